@@ -16,6 +16,18 @@ g++ -std=c++17 -Wall -Wextra -O2 -I../include \
     ../src/CardiacElectrophysiology.cpp \
     ../src/DataProcessor.cpp \
     ../src/ValidationFramework.cpp \
+    ../src/ThreadPool.cpp \
+    ../src/StencilKernels.cpp \
+    ../src/SparseDiffusion.cpp \
+    ../src/MappedFile.cpp \
+    ../src/ADIDiffusion.cpp \
+    ../src/FitzHughNagumoEnsemble.cpp \
+    ../src/FitzHughNagumo3D.cpp \
+    ../src/StimulusSchedule.cpp \
+    ../src/SnapshotWriter.cpp \
+    ../src/RateTable.cpp \
+    ../src/ScarMask.cpp \
+    -pthread \
     -o MI_Modeling_Cpp_Project
 
 if [ $? -eq 0 ]; then
@@ -31,7 +43,20 @@ g++ -std=c++17 -Wall -Wextra -O2 -I../include \
     ../tests/simple_test_main.cpp \
     ../src/DTM.cpp \
     ../src/FitzHughNagumo.cpp \
+    ../src/CardiacElectrophysiology.cpp \
     ../src/ValidationFramework.cpp \
+    ../src/ThreadPool.cpp \
+    ../src/StencilKernels.cpp \
+    ../src/SparseDiffusion.cpp \
+    ../src/MappedFile.cpp \
+    ../src/ADIDiffusion.cpp \
+    ../src/FitzHughNagumoEnsemble.cpp \
+    ../src/FitzHughNagumo3D.cpp \
+    ../src/StimulusSchedule.cpp \
+    ../src/SnapshotWriter.cpp \
+    ../src/RateTable.cpp \
+    ../src/ScarMask.cpp \
+    -pthread \
     -o simple_tests
 
 if [ $? -eq 0 ]; then
@@ -56,12 +81,43 @@ else
     exit 1
 fi
 
+# Compile MPI tests when an MPI compiler is available
+if command -v mpicxx > /dev/null 2>&1; then
+    echo "Compiling MPI tests..."
+    mpicxx -std=c++17 -Wall -Wextra -O2 -I../include -DOMPI_SKIP_MPICXX -DMPICH_SKIP_MPICXX \
+        ../tests/mpi_test_main.cpp \
+        ../src/DomainDecomposition.cpp \
+        ../src/DistributedFitzHughNagumo.cpp \
+        ../src/DistributedCardiacModel.cpp \
+        ../src/FitzHughNagumo.cpp \
+        ../src/CardiacElectrophysiology.cpp \
+        ../src/StimulusSchedule.cpp \
+        ../src/StencilKernels.cpp \
+        ../src/SparseDiffusion.cpp \
+        ../src/ThreadPool.cpp \
+        ../src/MappedFile.cpp \
+        ../src/ADIDiffusion.cpp \
+        ../src/SnapshotWriter.cpp \
+        ../src/RateTable.cpp \
+        ../src/ScarMask.cpp \
+        -pthread \
+        -o mpi_tests
+    
+    if [ $? -eq 0 ]; then
+        echo "MPI tests compiled successfully!"
+    else
+        echo "Error building MPI tests"
+        exit 1
+    fi
+fi
+
 echo "Build completed successfully!"
 echo ""
 echo "Available programs:"
 echo "  ./MI_Modeling_Cpp_Project    - Main MI modeling application"
 echo "  ./simple_tests               - Unit tests"
 echo "  ./data_test                  - Data processing and validation tests"
+echo "  mpirun -np 4 ./mpi_tests     - Distributed solver tests (if MPI is installed)"
 echo ""
 echo "Usage examples:"
 echo "  ./MI_Modeling_Cpp_Project --help                    # Show help"
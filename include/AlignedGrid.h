@@ -0,0 +1,338 @@
+#ifndef ALIGNEDGRID_H
+#define ALIGNEDGRID_H
+
+/**
+ * @file AlignedGrid.h
+ * @brief Contiguous, cache-line aligned 2D grid storage with halo cells
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// Alignment (bytes) of every grid row; matches a cache line and an AVX-512 register
+constexpr std::size_t kGridAlignment = 64;
+
+/**
+ * @brief Non-owning view of one grid row (span-style)
+ */
+template <typename T>
+class RowSpan {
+public:
+    RowSpan(T* data, std::size_t size) : data_(data), size_(size) {}
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    T* data() const { return data_; }
+    T* begin() const { return data_; }
+    T* end() const { return data_ + size_; }
+    T& operator[](std::size_t x) const { return data_[x]; }
+
+private:
+    T* data_;
+    std::size_t size_;
+};
+
+/**
+ * @brief Non-owning 2D view over strided grid storage
+ *
+ * Indexing mirrors std::vector<std::vector<T>> (`view[y][x]`, `size()` is the
+ * number of rows, range-for yields rows) so code written against the nested
+ * vector accessors keeps working. A view is invalidated when the grid it was
+ * taken from is resized or swapped (e.g. by a simulation step).
+ */
+template <typename T>
+class GridView {
+public:
+    class RowIterator {
+    public:
+        RowIterator(T* row, std::ptrdiff_t stride, std::size_t width)
+            : row_(row), stride_(stride), width_(width) {}
+
+        RowSpan<T> operator*() const { return RowSpan<T>(row_, width_); }
+        RowIterator& operator++() { row_ += stride_; return *this; }
+        bool operator==(const RowIterator& other) const { return row_ == other.row_; }
+        bool operator!=(const RowIterator& other) const { return row_ != other.row_; }
+
+    private:
+        T* row_;
+        std::ptrdiff_t stride_;
+        std::size_t width_;
+    };
+
+    GridView() : origin_(nullptr), width_(0), height_(0), stride_(0) {}
+
+    /**
+     * @brief Construct a view
+     * @param origin Pointer to element (0, 0)
+     * @param width Number of columns
+     * @param height Number of rows
+     * @param stride Distance in elements between consecutive rows
+     */
+    GridView(T* origin, int width, int height, std::ptrdiff_t stride)
+        : origin_(origin), width_(width), height_(height), stride_(stride) {}
+
+    /// Views over mutable data convert to read-only views
+    operator GridView<const T>() const {
+        return GridView<const T>(origin_, width_, height_, stride_);
+    }
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    std::ptrdiff_t stride() const { return stride_; }
+
+    std::size_t size() const { return static_cast<std::size_t>(height_); }
+    bool empty() const { return height_ == 0 || width_ == 0; }
+
+    RowSpan<T> operator[](std::size_t y) const {
+        return RowSpan<T>(origin_ + static_cast<std::ptrdiff_t>(y) * stride_, width_);
+    }
+
+    T& operator()(int x, int y) const { return origin_[y * stride_ + x]; }
+
+    RowIterator begin() const { return RowIterator(origin_, stride_, width_); }
+    RowIterator end() const { return RowIterator(origin_ + height_ * stride_, stride_, width_); }
+
+    /**
+     * @brief Copy the viewed cells into nested vectors
+     * @return 2D grid of values indexed [y][x]
+     */
+    std::vector<std::vector<std::remove_const_t<T>>> toVector() const {
+        std::vector<std::vector<std::remove_const_t<T>>> result(height_);
+        for (int y = 0; y < height_; ++y) {
+            const T* row = origin_ + y * stride_;
+            result[y].assign(row, row + width_);
+        }
+        return result;
+    }
+
+    /// Implicit copy for callers that still expect nested vectors
+    operator std::vector<std::vector<std::remove_const_t<T>>>() const { return toVector(); }
+
+private:
+    T* origin_;
+    int width_;
+    int height_;
+    std::ptrdiff_t stride_;
+};
+
+/**
+ * @brief Non-owning 2D view of one lane of interleaved grid storage
+ *
+ * Cell (x, y) lives at `origin[y * stride + x * step]`, e.g. one member of an
+ * ensemble stored member-fastest. Indexing mirrors GridView (`view[y][x]`,
+ * `view(x, y)`, `size()` is the number of rows, toVector()).
+ */
+template <typename T>
+class StridedGridView {
+public:
+    /**
+     * @brief Non-owning view of one row with a fixed element step
+     */
+    class Row {
+    public:
+        Row(T* data, std::ptrdiff_t step, std::size_t size) : data_(data), step_(step), size_(size) {}
+
+        std::size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        T& operator[](std::size_t x) const { return data_[static_cast<std::ptrdiff_t>(x) * step_]; }
+
+    private:
+        T* data_;
+        std::ptrdiff_t step_;
+        std::size_t size_;
+    };
+
+    StridedGridView() : origin_(nullptr), width_(0), height_(0), stride_(0), step_(1) {}
+
+    /**
+     * @brief Construct a view
+     * @param origin Pointer to element (0, 0)
+     * @param width Number of columns
+     * @param height Number of rows
+     * @param stride Distance in elements between consecutive rows
+     * @param step Distance in elements between consecutive columns
+     */
+    StridedGridView(T* origin, int width, int height, std::ptrdiff_t stride, std::ptrdiff_t step)
+        : origin_(origin), width_(width), height_(height), stride_(stride), step_(step) {}
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+
+    std::size_t size() const { return static_cast<std::size_t>(height_); }
+    bool empty() const { return height_ == 0 || width_ == 0; }
+
+    Row operator[](std::size_t y) const {
+        return Row(origin_ + static_cast<std::ptrdiff_t>(y) * stride_, step_, width_);
+    }
+
+    T& operator()(int x, int y) const { return origin_[y * stride_ + x * step_]; }
+
+    /**
+     * @brief Copy the viewed cells into nested vectors
+     * @return 2D grid of values indexed [y][x]
+     */
+    std::vector<std::vector<std::remove_const_t<T>>> toVector() const {
+        std::vector<std::vector<std::remove_const_t<T>>> result(height_, std::vector<std::remove_const_t<T>>(width_));
+        for (int y = 0; y < height_; ++y) {
+            for (int x = 0; x < width_; ++x) {
+                result[y][x] = (*this)(x, y);
+            }
+        }
+        return result;
+    }
+
+    /// Implicit copy for callers that expect nested vectors
+    operator std::vector<std::vector<std::remove_const_t<T>>>() const { return toVector(); }
+
+private:
+    T* origin_;
+    int width_;
+    int height_;
+    std::ptrdiff_t stride_;
+    std::ptrdiff_t step_;
+};
+
+/**
+ * @brief Owning 2D grid stored as one contiguous, 64-byte aligned block
+ *
+ * Rows are padded so that every row starts on a cache line and the stride is a
+ * multiple of the alignment. `halo` extra rows are kept above and below the
+ * grid and at least `halo` extra columns on each side, so stencils may read
+ * neighbours at x = -1..width and y = -1..height without bounds checks.
+ */
+template <typename T>
+class AlignedGrid {
+    static_assert(std::is_trivially_copyable<T>::value, "AlignedGrid requires trivially copyable elements");
+
+public:
+    /// Number of elements of T per alignment block
+    static constexpr int kLanes = static_cast<int>(kGridAlignment / sizeof(T)) > 0
+                                      ? static_cast<int>(kGridAlignment / sizeof(T)) : 1;
+
+    AlignedGrid() = default;
+
+    /**
+     * @brief Constructor
+     * @param width Number of columns
+     * @param height Number of rows
+     * @param halo Number of halo cells around the grid
+     * @param value Initial value for every cell, halo included
+     */
+    AlignedGrid(int width, int height, int halo = 1, T value = T()) {
+        resize(width, height, halo, value);
+    }
+
+    AlignedGrid(const AlignedGrid& other) {
+        allocate(other.width_, other.height_, other.halo_);
+        std::copy(other.data_, other.data_ + allocatedSize(), data_);
+    }
+
+    AlignedGrid(AlignedGrid&& other) noexcept { swap(other); }
+
+    AlignedGrid& operator=(const AlignedGrid& other) {
+        if (this != &other) {
+            AlignedGrid copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    AlignedGrid& operator=(AlignedGrid&& other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~AlignedGrid() { release(); }
+
+    /**
+     * @brief Reallocate the grid; previous contents are discarded
+     */
+    void resize(int width, int height, int halo = 1, T value = T()) {
+        release();
+        allocate(width, height, halo);
+        fill(value);
+    }
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    int halo() const { return halo_; }
+
+    /// Distance in elements between the starts of consecutive rows
+    std::ptrdiff_t stride() const { return stride_; }
+
+    /// Total number of allocated elements, padding and halo included
+    std::size_t allocatedSize() const {
+        return static_cast<std::size_t>(stride_) * static_cast<std::size_t>(height_ + 2 * halo_);
+    }
+
+    /// Start of the allocation (first halo row, first padding column)
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+
+    /**
+     * @brief Pointer to cell (0, y); valid for y in [-halo, height + halo)
+     */
+    T* row(int y) { return origin_ + y * stride_; }
+    const T* row(int y) const { return origin_ + y * stride_; }
+
+    T& operator()(int x, int y) { return origin_[y * stride_ + x]; }
+    const T& operator()(int x, int y) const { return origin_[y * stride_ + x]; }
+
+    /// Set every allocated element, halo and padding included
+    void fill(T value) { std::fill(data_, data_ + allocatedSize(), value); }
+
+    void swap(AlignedGrid& other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(origin_, other.origin_);
+        std::swap(width_, other.width_);
+        std::swap(height_, other.height_);
+        std::swap(halo_, other.halo_);
+        std::swap(stride_, other.stride_);
+    }
+
+    GridView<T> view() { return GridView<T>(origin_, width_, height_, stride_); }
+    GridView<const T> view() const { return GridView<const T>(origin_, width_, height_, stride_); }
+
+private:
+    T* data_ = nullptr;
+    T* origin_ = nullptr;
+    int width_ = 0;
+    int height_ = 0;
+    int halo_ = 0;
+    std::ptrdiff_t stride_ = 0;
+
+    static int roundUpToLanes(int n) { return (n + kLanes - 1) / kLanes * kLanes; }
+
+    void allocate(int width, int height, int halo) {
+        width_ = std::max(width, 0);
+        height_ = std::max(height, 0);
+        halo_ = std::max(halo, 0);
+
+        // Left padding is a whole alignment block so column 0 stays aligned
+        int pad_left = roundUpToLanes(halo_);
+        stride_ = roundUpToLanes(pad_left + width_ + halo_);
+
+        std::size_t count = allocatedSize();
+        if (count == 0) {
+            data_ = origin_ = nullptr;
+            return;
+        }
+        data_ = static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(kGridAlignment)));
+        origin_ = data_ + halo_ * stride_ + pad_left;
+    }
+
+    void release() {
+        if (data_) {
+            ::operator delete(data_, std::align_val_t(kGridAlignment));
+        }
+        data_ = origin_ = nullptr;
+        width_ = height_ = halo_ = 0;
+        stride_ = 0;
+    }
+};
+
+#endif // ALIGNEDGRID_H
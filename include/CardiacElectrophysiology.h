@@ -6,10 +6,49 @@
  * @brief Cardiac electrophysiology models for MI modeling
  */
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <vector>
 #include <string>
 #include <functional>
 #include <map>
+#include <memory>
+#include <cstdint>
+#include "AlignedGrid.h"
+#include "IonicState.h"
+#include "RateTable.h"
+#include "ScarMask.h"
+#include "StencilKernels.h"
+
+class SparseDiffusion;
+class ThreadPool;
+
+/**
+ * @brief Integration scheme for Hodgkin-Huxley gates
+ *
+ * A gate obeys dg/dt = alpha(V) (1 - g) - beta(V) g. With V frozen over a
+ * step this is linear in g, so the Rush-Larsen schemes advance it exactly
+ * and stay in [0, 1] for any dt, while forward Euler is only stable for
+ * dt < 1 / (alpha + beta), which the fast sodium gates make very small.
+ */
+enum class GateIntegrator {
+    ForwardEuler,            ///< Explicit Euler step for every gate
+    RushLarsen,              ///< Exponential gate update with rates from the start of the step (first order)
+    GeneralizedRushLarsen2   ///< Rates and currents from a half-step midpoint state (second order)
+};
+
+/**
+ * @brief Treatment of the grid edge in the diffusion term
+ *
+ * V is surrounded by a one-cell ring of ghost cells that is refilled before
+ * every step, so edge cells use the same stencil as interior cells.
+ */
+enum class BoundaryCondition {
+    ZeroFlux,  ///< Neumann: no current crosses the edge (default)
+    Fixed,     ///< Dirichlet: the ghost cells are held at a fixed potential
+    Periodic   ///< Opposite edges are joined
+};
 
 /**
  * @brief Base class for cardiac electrophysiology models
@@ -24,12 +63,42 @@ public:
      */
     CardiacElectrophysiology(int width, int height, double dt = 0.01);
     
-    virtual ~CardiacElectrophysiology() = default;
+    virtual ~CardiacElectrophysiology();
     
     /**
      * @brief Run one time step of the simulation
+     *
+     * Same as beginStep(), stepCells() over the whole grid, then finishStep().
+     */
+    virtual void step();
+    
+    /**
+     * @brief Start a step that is advanced one rectangle at a time
+     *
+     * Fills the ghost cells and, with the sparse operator, computes the
+     * diffusion term of every cell, so V must be final for this step. Without
+     * the sparse operator only stepCells() reads the rest of V, which lets a
+     * caller still be receiving parts of V while it steps cells that do not
+     * read them (see DistributedCardiacModel).
      */
-    virtual void step() = 0;
+    void beginStep();
+    
+    /**
+     * @brief Advance the cells of a rectangle by one step
+     *
+     * Between beginStep() and finishStep() every cell must be stepped exactly
+     * once; rectangles may be stepped in any order.
+     * @param x_begin First column
+     * @param x_end One past the last column
+     * @param y_begin First row
+     * @param y_end One past the last row
+     */
+    void stepCells(int x_begin, int x_end, int y_begin, int y_end);
+    
+    /**
+     * @brief Make the stepped V current and advance the time
+     */
+    void finishStep();
     
     /**
      * @brief Run simulation for specified number of steps
@@ -39,9 +108,18 @@ public:
     
     /**
      * @brief Get membrane potential (V)
-     * @return 2D grid of membrane potential values
+     * @return View of the V grid, indexed [y][x]; invalidated by the next step
      */
-    virtual const std::vector<std::vector<double>>& getMembranePotential() const = 0;
+    virtual GridView<const double> getMembranePotential() const = 0;
+    
+    /**
+     * @brief Get writable row y of the membrane potential
+     *
+     * Lets a domain decomposition fill halo cells in place.
+     * @param y Row index
+     * @return Pointer to V at (0, y)
+     */
+    virtual double* membranePotentialRow(int y) = 0;
     
     /**
      * @brief Get current simulation time
@@ -49,31 +127,380 @@ public:
      */
     double getTime() const { return time_; }
     
+    /**
+     * @brief Get the memory taken by the integrated state of one cell
+     * @return Bytes per cell
+     */
+    virtual std::size_t getStateBytesPerCell() const = 0;
+    
     /**
      * @brief Set tissue conductivity
      * @param conductivity Conductivity value (S/cm)
      */
-    void setConductivity(double conductivity) { conductivity_ = conductivity; }
+    void setConductivity(double conductivity);
+    
+    /**
+     * @brief Select the boundary condition at the grid edge
+     * @param condition ZeroFlux (default), Fixed or Periodic
+     * @param fixed_potential Ghost cell potential for Fixed (mV)
+     */
+    void setBoundaryCondition(BoundaryCondition condition, double fixed_potential = 0.0);
+    
+    BoundaryCondition getBoundaryCondition() const { return boundary_; }
+    
+    /**
+     * @brief Use anisotropic diffusion along a fiber field
+     *
+     * Each cell conducts with the tensor sigma_t I + (sigma_l - sigma_t) f f^T,
+     * f = (cos angle, sin angle); scar cells do not conduct. The 9-point
+     * stencil weights this gives are computed here and again only when the
+     * MI region or boundary condition changes, and replace the isotropic
+     * setConductivity() value.
+     * @param fiber_angle Fiber angle per cell (radians from the x axis towards
+     *                    increasing y), or empty to return to isotropic diffusion
+     * @param longitudinal Conductivity along the fibers (sigma_l)
+     * @param transverse Conductivity across the fibers (sigma_t)
+     * @return false if the field size does not match the grid (diffusion unchanged)
+     */
+    bool setFiberOrientation(const std::vector<std::vector<double>>& fiber_angle,
+                             double longitudinal, double transverse);
+    
+    /**
+     * @brief Check whether diffusion follows a fiber field
+     */
+    bool isAnisotropic() const { return fiber_angle_.width() > 0; }
+    
+    /**
+     * @brief Apply diffusion as a sparse matrix over the excitable cells
+     *
+     * The face couplings are assembled into a CSR operator with one row per
+     * excitable cell, renumbered with reverse Cuthill-McKee (see
+     * SparseDiffusion), and reassembled whenever the couplings change. Each
+     * step gathers V of those cells, multiplies on the stepping threads and
+     * scatters the result for the ionic update, so scar cells cost no
+     * diffusion work or mask checks. Results match the stencil to rounding.
+     * @param enabled true for the sparse operator, false for the stencil (default)
+     */
+    void setSparseDiffusion(bool enabled);
+    
+    /**
+     * @brief Get the sparse diffusion operator, e.g. to report its size
+     * @return Operator, or nullptr when diffusion uses the stencil
+     */
+    const SparseDiffusion* getSparseDiffusion() const { return sparse_diffusion_.get(); }
     
     /**
      * @brief Set MI region (damaged tissue)
+     *
+     * Scar cells do not conduct: no current flows across a face between a
+     * scar cell and its neighbours.
      * @param mi_region 2D boolean grid indicating MI regions
      */
     void setMIRegion(const std::vector<std::vector<bool>>& mi_region);
+    
+    /**
+     * @brief Set the MI region from a packed mask without copying it
+     *
+     * Pass a mask built with ScarMask::fromWords to hand over its words, or
+     * one built with ScarMask::view to use a segmentation buffer in place.
+     * @param mask Scar mask of the grid's size
+     * @return false if the mask size does not match the grid (MI region unchanged)
+     */
+    bool setScarMask(ScarMask mask);
+    
+    /**
+     * @brief Get the MI region and its precomputed excitable spans
+     */
+    const ScarMask& getScarMask() const { return scar_; }
+    
+    /**
+     * @brief Assign a tissue class to every cell
+     *
+     * Classes index the model's small table of conductance sets: class 0 is
+     * the set chosen by setCellType / setVariant and addTissueClass appends
+     * more. The per-cell update reads each cell's conductances from that
+     * table, so normal, ischemic and infarcted tissue share one simulation.
+     * @param classes 2D grid of class indices; empty puts every cell back in class 0
+     * @return true if successful, false on a size mismatch or an undefined class
+     */
+    bool setTissueClasses(const std::vector<std::vector<uint8_t>>& classes);
+    
+    /**
+     * @brief Append a tissue class with the conductances of a named cell type
+     * @param cell_type Cell type (LuoRudyModel::setCellType) or variant (TenTusscherModel::setVariant)
+     * @return Index of the new class, or -1 if the name is unknown or kMaxTissueClasses exist
+     */
+    virtual int addTissueClass(const std::string& cell_type) = 0;
+    
+    /**
+     * @brief Get the number of defined tissue classes
+     */
+    virtual int getTissueClassCount() const = 0;
+    
+    /**
+     * @brief Scale the conductance of one current cell by cell
+     *
+     * Multiplies the conductance of the cell's tissue class, e.g. to grade a
+     * border zone continuously between infarcted and healthy tissue.
+     * @param current Index of the current in the model's Current enum
+     * @param scale 2D grid of factors; empty removes the scaling
+     * @return true if successful, false on a size mismatch or an unknown current
+     */
+    bool setConductanceScale(int current, const std::vector<std::vector<double>>& scale);
+    
+    /// Most tissue classes a model can hold (indices are uint8_t)
+    static constexpr int kMaxTissueClasses = 256;
+    
+    /**
+     * @brief Set number of threads used for stepping
+     *
+     * The grid is split into contiguous row bands, one per thread, which are
+     * advanced by a persistent worker pool. Results do not depend on the
+     * thread count.
+     * @param num_threads Thread count; 1 steps serially on the calling thread,
+     *                    values <= 0 select the hardware concurrency
+     */
+    void setNumThreads(int num_threads);
+    
+    /**
+     * @brief Get number of threads used for stepping
+     * @return Thread count
+     */
+    int getNumThreads() const;
+    
+    /**
+     * @brief Select how the gating variables are integrated
+     *
+     * V and the concentrations stay explicit; GeneralizedRushLarsen2 also
+     * evaluates their rates at the midpoint state.
+     * @param integrator Gate integration scheme (default ForwardEuler)
+     */
+    void setGateIntegrator(GateIntegrator integrator) { gate_integrator_ = integrator; }
+    
+    GateIntegrator getGateIntegrator() const { return gate_integrator_; }
+    
+    /**
+     * @brief Interpolate the voltage-dependent rate functions from a lookup table
+     *
+     * Gate rates and the exp() terms of the currents are read from a table
+     * over [kRateTableMinVoltage, kRateTableMaxVoltage] instead of being
+     * evaluated per cell; potentials outside that range use the exact
+     * functions. The table depends only on the model class and resolution
+     * (conductances scale the currents outside it), so all models of a class
+     * share one copy.
+     * @param resolution Table spacing in mV; 0 switches back to exact evaluation (default)
+     * @return true if successful, false if the resolution is invalid
+     */
+    bool setRateTableResolution(double resolution);
+    
+    /**
+     * @brief Get the lookup table in use, e.g. to report its interpolation error
+     * @return Table, or nullptr when the rates are evaluated exactly
+     */
+    const RateTable* getRateTable() const { return rate_table_.get(); }
+    
+    /// Potential range covered by rate tables (mV)
+    static constexpr double kRateTableMinVoltage = -120.0;
+    static constexpr double kRateTableMaxVoltage = 80.0;
 
 protected:
+    /// Opening and closing rates of a gate at some membrane potential
+    struct GateRate {
+        double alpha, beta;
+    };
+    
     int width_, height_;
     double dt_, time_;
     double conductivity_;
-    std::vector<std::vector<bool>> mi_region_;
+    BoundaryCondition boundary_;
+    double boundary_potential_;        ///< Ghost cell potential for BoundaryCondition::Fixed
+    ScarMask scar_;                    ///< MI regions (scar tissue) and the excitable spans between them
+    AlignedGrid<double> fiber_angle_;  ///< Fiber angle per cell (empty: isotropic diffusion)
+    double longitudinal_conductivity_, transverse_conductivity_;
+    
+    /// Face couplings of the stencil (see NinePointRowPointers); diagonals empty when isotropic
+    enum DiffusionWeight { EastWeight, SouthWeight, SouthEastWeight, NorthEastWeight, kDiffusionWeightCount };
+    std::array<AlignedGrid<double>, kDiffusionWeightCount> diffusion_weights_;
+    AlignedGrid<unsigned char> tissue_class_;          ///< Tissue class per cell (empty: class 0 everywhere)
+    std::vector<AlignedGrid<double>> conductance_scale_;  ///< Factors per current (empty grids: unscaled)
+    GateIntegrator gate_integrator_;
+    std::shared_ptr<const RateTable> rate_table_;
+    
+    AlignedGrid<double> V_next_;       ///< Membrane potential written by step(), then swapped in
+    AlignedGrid<double> scratch_;      ///< Row buffers, scratch_rows_ per thread
+    int scratch_rows_;
+    std::unique_ptr<ThreadPool> pool_; ///< Workers for parallel stepping (null when serial)
+    
+    std::unique_ptr<SparseDiffusion> sparse_diffusion_;  ///< CSR operator (null: stencil diffusion)
+    std::vector<std::ptrdiff_t> sparse_cells_;           ///< Offset from V(0, 0) of each operator row's cell
+    std::vector<double> sparse_in_, sparse_out_;         ///< V and diffusion in operator order
+    AlignedGrid<double> sparse_result_;                  ///< Diffusion term per cell from the operator
+    
+    /// Sodium activation gate m
+    static GateRate sodiumActivation(double V);
+    
+    /// Sodium inactivation gate h
+    static GateRate sodiumInactivation(double V);
+    
+    /// Delayed rectifier potassium activation gate (xr, u)
+    static GateRate potassiumActivation(double V);
+    
+    /**
+     * @brief Per-cell step factors of the exponential gate update
+     *
+     * With its rates held fixed over a step a gate moves to
+     * g_inf + (g - g_inf) exp(-dt / tau) = g + step * (alpha (1 - g) - beta g),
+     * with step = (1 - exp(-dt (alpha + beta))) / (alpha + beta), which tends
+     * to the Euler factor dt as alpha + beta -> 0.
+     * @param alpha Opening rates of the row
+     * @param beta Closing rates of the row
+     * @param dt Step length
+     * @param step Receives the step factors of columns [x_begin, x_end)
+     * @param x_begin First column
+     * @param x_end One past the last column
+     */
+    void gateStepRow(const double* alpha, const double* beta, double dt, double* step,
+                     int x_begin, int x_end) const;
+    
+    /**
+     * @brief Recompute the face couplings from the conductivities, fiber
+     *        field, MI region and boundary condition
+     *
+     * Couplings to scar cells are zero, as are couplings across the grid
+     * edge under BoundaryCondition::ZeroFlux.
+     */
+    void updateDiffusionWeights();
+    
+    /**
+     * @brief Build the sparse operator from the face couplings and boundary condition
+     */
+    void assembleSparseDiffusion();
     
     /**
-     * @brief Apply diffusion operator for electrical propagation
-     * @param grid Input grid
-     * @param result Output grid
+     * @brief Diffusion term of every excitable cell through the sparse operator
+     *
+     * Run at the start of a step, after the ghost cells are filled.
+     * @param V Membrane potential
      */
-    void applyDiffusion(const std::vector<std::vector<double>>& grid,
-                       std::vector<std::vector<double>>& result);
+    void applySparseDiffusion(const AlignedGrid<double>& V);
+    
+    /**
+     * @brief Fill the ghost cells around V for the boundary condition
+     * @param V Membrane potential at the start of a step
+     */
+    void fillGhostCells(AlignedGrid<double>& V) const;
+    
+    /**
+     * @brief Diffusion term of one row for the reaction update
+     *
+     * Stencil of the precomputed face couplings: 5-point, or 9-point when
+     * anisotropic. Reads the ghost cells on the grid edge.
+     * Only the excitable spans of the row are written. With the sparse
+     * operator the row computed by applySparseDiffusion is returned instead.
+     * @param V Membrane potential
+     * @param y Row index
+     * @param columns Columns to compute
+     * @param out Receives the diffusion term of the row's excitable cells in columns
+     * @return Diffusion term of the row (out, or a row of the sparse result)
+     */
+    const double* diffusionRow(const AlignedGrid<double>& V, int y, const CellSpan& columns, double* out) const;
+    
+    /**
+     * @brief Copy the scar cells of row y, which a step leaves unchanged
+     * @param from Current row
+     * @param to Row of the next step
+     * @param y Row index
+     * @param columns Columns to copy
+     */
+    void copyScarCells(const double* from, double* to, int y, const CellSpan& columns) const {
+        for (const CellSpan& scar : scar_.scarSpans(y)) {
+            const CellSpan span = scar.clip(columns);
+            if (span.begin < span.end) {
+                std::copy(from + span.begin, from + span.end, to + span.begin);
+            }
+        }
+    }
+    
+    /**
+     * @brief Tissue classes of row y, or nullptr when every cell is class 0
+     */
+    const unsigned char* tissueClassRow(int y) const {
+        return tissue_class_.width() > 0 ? tissue_class_.row(y) : nullptr;
+    }
+    
+    /**
+     * @brief Conductance factors of one current in row y, or nullptr when unscaled
+     */
+    const double* conductanceScaleRow(int current, int y) const {
+        const AlignedGrid<double>& scale = conductance_scale_[current];
+        return scale.width() > 0 ? scale.row(y) : nullptr;
+    }
+    
+    /**
+     * @brief Point the kernel's tissue rows at row y
+     */
+    template <int Count>
+    void tissueRow(int y, TissueRowPointers<Count>& tissue) const {
+        tissue.tissue_class = tissueClassRow(y);
+        for (int c = 0; c < Count; ++c) {
+            tissue.scale[c] = conductanceScaleRow(c, y);
+        }
+    }
+    
+    /**
+     * @brief Conductances of one cell: its tissue class's entry times the scale fields
+     */
+    template <typename Conductances>
+    Conductances cellConductances(const std::vector<Conductances>& tissue_classes, int x, int y) const {
+        const unsigned char* classes = tissueClassRow(y);
+        Conductances conductances = tissue_classes[classes ? classes[x] : 0];
+        for (int c = 0; c < static_cast<int>(conductances.size()); ++c) {
+            if (const double* scale = conductanceScaleRow(c, y)) {
+                conductances[c] *= scale[x];
+            }
+        }
+        return conductances;
+    }
+    
+    /**
+     * @brief Size the per-thread scratch rows
+     * @param rows_per_thread Rows of width_ doubles each thread needs
+     */
+    void allocateScratch(int rows_per_thread);
+    
+    /**
+     * @brief Scratch row of one thread
+     */
+    double* scratchRow(int thread_index, int row) { return scratch_.row(thread_index * scratch_rows_ + row); }
+    
+    /**
+     * @brief Run a row-band task on the pool, or serially without one
+     * @param y_begin First row to split into bands
+     * @param y_end One past the last row
+     * @param task Callable receiving (thread index, first row, end row)
+     */
+    void forEachBand(int y_begin, int y_end, const std::function<void(int, int, int)>& task);
+    
+    /**
+     * @brief Advance the cells of rows [y_begin, y_end) in columns by one step
+     *
+     * Gates and Cai are updated in place, V into V_next_.
+     * @param thread_index Thread whose scratch rows to use
+     * @param y_begin First row
+     * @param y_end One past the last row
+     * @param columns Columns to update
+     */
+    virtual void updateRows(int thread_index, int y_begin, int y_end, const CellSpan& columns) = 0;
+    
+    /**
+     * @brief Membrane potential grid of the derived model's state
+     */
+    virtual AlignedGrid<double>& potential() = 0;
+    
+    /**
+     * @brief Get the shared rate table of the derived model at a resolution
+     */
+    virtual std::shared_ptr<const RateTable> makeRateTable(double resolution) const = 0;
 };
 
 /**
@@ -81,11 +508,19 @@ protected:
  */
 class LuoRudyModel : public CardiacElectrophysiology {
 public:
+    /// Ionic currents of one cell, in this order
+    enum Current { INa, ICaL, IK, IK1, Ib, ICaT, kCurrentCount };
+    using Currents = std::array<double, kCurrentCount>;
+    
+    /// Report names of the currents, indexed by Current
+    static const std::array<const char*, kCurrentCount> kCurrentNames;
+    
     LuoRudyModel(int width, int height, double dt = 0.01);
     ~LuoRudyModel() override;
     
-    void step() override;
-    const std::vector<std::vector<double>>& getMembranePotential() const override { return V_; }
+    GridView<const double> getMembranePotential() const override { return state_[State::V].view(); }
+    double* membranePotentialRow(int y) override { return state_[State::V].row(y); }
+    std::size_t getStateBytesPerCell() const override { return IonicState<State>::bytesPerCell(); }
     
     /**
      * @brief Set model parameters for different cell types
@@ -93,6 +528,9 @@ public:
      */
     void setCellType(const std::string& cell_type);
     
+    int addTissueClass(const std::string& cell_type) override;
+    int getTissueClassCount() const override { return static_cast<int>(tissue_classes_.size()); }
+    
     /**
      * @brief Get ionic currents
      * @return Map of current names to 2D grids
@@ -100,23 +538,83 @@ public:
     std::map<std::string, std::vector<std::vector<double>>> getIonicCurrents() const;
 
 private:
-    // State variables
-    std::vector<std::vector<double>> V_;  // Membrane potential
-    std::vector<std::vector<double>> m_, h_, j_;  // Sodium gate variables
-    std::vector<std::vector<double>> xr_, xs_;    // Potassium gate variables
-    std::vector<std::vector<double>> d_, f_, fca_; // Calcium gate variables
-    std::vector<std::vector<double>> Cai_, CaSR_; // Calcium concentrations
+    /// Voltage-dependent rate functions, in this order (K1Denominator = 1 + exp(0.07 (V + 80)))
+    enum Rate { AlphaM, BetaM, AlphaH, BetaH, AlphaXr, BetaXr, K1Denominator, kRateCount };
+    using Rates = std::array<double, kRateCount>;
+    
+    /// step() scratch rows: diffusion term, midpoint state, gate step factors, then one row per Rate
+    enum ScratchRow { DiffusionRow, VHalfRow, MHalfRow, HHalfRow, XrHalfRow, CaiHalfRow,
+                      MStepRow, HStepRow, XrStepRow, FirstRateRow,
+                      kScratchRowCount = FirstRateRow + kRateCount };
+    
+    /// Integrated state variables
+    enum class State { V, m, h, xr, Cai, Count };
+    
+    IonicState<State> state_;
+    
+    // Gates the simplified dynamics never update, held at their resting
+    // values as parameters instead of per-cell state
+    double j_, xs_, d_, f_, fca_;
     
-    // Model parameters
-    double GNa_, Gsi_, GK_, GK1_, Gb_, GCaL_;
+    /// Conductances of each tissue class; class 0 follows setCellType
+    std::vector<LuoRudyConductances> tissue_classes_;
     
     /**
-     * @brief Calculate ionic currents
-     * @param x X coordinate
-     * @param y Y coordinate
-     * @return Map of current values
+     * @brief Conductances of a named cell type
+     * @return false (leaving conductances unchanged) if the name is unknown
      */
-    std::map<std::string, double> calculateIonicCurrents(int x, int y);
+    bool cellTypeConductances(const std::string& cell_type, LuoRudyConductances& conductances) const;
+    
+    /**
+     * @brief Evaluate every rate function exactly
+     * @param V Membrane potential
+     * @param rates Receives kRateCount values indexed by Rate
+     */
+    static void exactRates(double V, double* rates);
+    
+    /**
+     * @brief Evaluate every rate function, from the rate table if one is set
+     */
+    void evaluateRates(double V, Rates& rates) const {
+        if (rate_table_) {
+            rate_table_->lookup(V, rates.data());
+        } else {
+            exactRates(V, rates.data());
+        }
+    }
+    
+    std::shared_ptr<const RateTable> makeRateTable(double resolution) const override;
+    
+    /**
+     * @brief Calculate the ionic currents of one cell
+     * @param V Membrane potential
+     * @param m Sodium activation gate
+     * @param h Sodium inactivation gate
+     * @param xr Potassium activation gate
+     * @param rates Rate functions at V
+     * @param conductances Conductances of the cell
+     * @return Currents indexed by Current
+     */
+    Currents calculateIonicCurrents(double V, double m, double h, double xr, const Rates& rates,
+                                    const LuoRudyConductances& conductances) const;
+    
+    /**
+     * @brief Evaluate every rate function for a span of a row of potentials
+     * @param V Potentials of the row
+     * @param rates Receives rates[r][x] for every Rate r and x in [x_begin, x_end)
+     * @param x_begin First column
+     * @param x_end One past the last column
+     */
+    void evaluateRateRow(const double* V, double* const* rates, int x_begin, int x_end) const;
+    
+    /**
+     * @brief Advance rows [y_begin, y_end) in columns: V into V_next_, gates and Cai in place
+     *
+     * Rates are evaluated per row into scratch rows; the currents and the
+     * state update then run through the vectorized membrane kernel.
+     */
+    void updateRows(int thread_index, int y_begin, int y_end, const CellSpan& columns) override;
+    AlignedGrid<double>& potential() override { return state_[State::V]; }
 };
 
 /**
@@ -124,32 +622,114 @@ private:
  */
 class TenTusscherModel : public CardiacElectrophysiology {
 public:
+    /// Ionic currents of one cell, in this order
+    enum Current { INa, ICaL, IKr, IKs, IK1, Ito, INaCa, INaK, kCurrentCount };
+    using Currents = std::array<double, kCurrentCount>;
+    
+    /// Report names of the currents, indexed by Current
+    static const std::array<const char*, kCurrentCount> kCurrentNames;
+    
     TenTusscherModel(int width, int height, double dt = 0.01);
     ~TenTusscherModel() override;
     
-    void step() override;
-    const std::vector<std::vector<double>>& getMembranePotential() const override { return V_; }
+    GridView<const double> getMembranePotential() const override { return state_[State::V].view(); }
+    double* membranePotentialRow(int y) override { return state_[State::V].row(y); }
+    std::size_t getStateBytesPerCell() const override { return IonicState<State>::bytesPerCell(); }
     
     /**
      * @brief Set model variant (epi, endo, mid)
      * @param variant Cell type variant
      */
     void setVariant(const std::string& variant);
+    
+    int addTissueClass(const std::string& variant) override;
+    int getTissueClassCount() const override { return static_cast<int>(tissue_classes_.size()); }
+    
+    /**
+     * @brief Get ionic currents
+     * @return Map of current names to 2D grids
+     */
+    std::map<std::string, std::vector<std::vector<double>>> getIonicCurrents() const;
 
 private:
-    // State variables (simplified for demonstration)
-    std::vector<std::vector<double>> V_;  // Membrane potential
-    std::vector<std::vector<double>> m_, h_, j_, oa_, oi_;  // Gate variables
-    std::vector<std::vector<double>> d_, f_, fca_, u_, v_, w_;  // Additional gates
-    std::vector<std::vector<double>> Cai_, CaSR_, CaSS_, Nai_, Ki_;  // Concentrations
+    /// Voltage-dependent rate functions, in this order (K1Denominator = 1 + exp(0.07 (V + 80)),
+    /// NaCaExpPlus/Minus = exp(+/-0.03743 V))
+    enum Rate { AlphaM, BetaM, AlphaU, BetaU, K1Denominator, NaCaExpPlus, NaCaExpMinus, kRateCount };
+    using Rates = std::array<double, kRateCount>;
+    
+    /// step() scratch rows: diffusion term, midpoint state, gate step factors, then one row per Rate
+    enum ScratchRow { DiffusionRow, VHalfRow, MHalfRow, UHalfRow, CaiHalfRow, MStepRow, UStepRow, FirstRateRow,
+                      kScratchRowCount = FirstRateRow + kRateCount };
+    
+    /// Integrated state variables (u is the IKr activation gate)
+    enum class State { V, m, u, Cai, Count };
+    
+    IonicState<State> state_;
+    
+    // Gates and concentrations the simplified dynamics never update, held
+    // at their resting values as parameters instead of per-cell state
+    double h_, j_, oa_, oi_, d_, f_, fca_, v_;
+    double Nai_, Ki_;
+    
+    /// Conductances of each tissue class; class 0 follows setVariant
+    std::vector<TenTusscherConductances> tissue_classes_;
+    
+    /**
+     * @brief Conductances of a named variant
+     * @return false (leaving conductances unchanged) if the name is unknown
+     */
+    bool variantConductances(const std::string& variant, TenTusscherConductances& conductances) const;
+    
+    /**
+     * @brief Evaluate every rate function exactly
+     * @param V Membrane potential
+     * @param rates Receives kRateCount values indexed by Rate
+     */
+    static void exactRates(double V, double* rates);
+    
+    /**
+     * @brief Evaluate every rate function, from the rate table if one is set
+     */
+    void evaluateRates(double V, Rates& rates) const {
+        if (rate_table_) {
+            rate_table_->lookup(V, rates.data());
+        } else {
+            exactRates(V, rates.data());
+        }
+    }
+    
+    std::shared_ptr<const RateTable> makeRateTable(double resolution) const override;
     
-    // Model parameters
-    double GNa_, GCaL_, GKr_, GKs_, GK1_, Gto_, GNaCa_, GNaK_;
+    /**
+     * @brief Calculate the ionic currents of one cell
+     * @param V Membrane potential
+     * @param m Sodium activation gate
+     * @param u IKr activation gate
+     * @param Cai Intracellular calcium
+     * @param rates Rate functions at V
+     * @param conductances Conductances of the cell
+     * @return Currents indexed by Current
+     */
+    Currents calculateIonicCurrents(double V, double m, double u, double Cai, const Rates& rates,
+                                    const TenTusscherConductances& conductances) const;
+    
+    /**
+     * @brief Evaluate every rate function for a span of a row of potentials
+     * @param V Potentials of the row
+     * @param rates Receives rates[r][x] for every Rate r and x in [x_begin, x_end)
+     * @param x_begin First column
+     * @param x_end One past the last column
+     */
+    void evaluateRateRow(const double* V, double* const* rates, int x_begin, int x_end) const;
     
     /**
-     * @brief Calculate ionic currents for Ten Tusscher model
+     * @brief Advance rows [y_begin, y_end) in columns: V into V_next_, gates and Cai in place
+     *
+     * Rates are evaluated per row into scratch rows; the currents and the
+     * state update then run through the vectorized membrane kernel.
      */
-    std::map<std::string, double> calculateIonicCurrents(int x, int y);
+    void updateRows(int thread_index, int y_begin, int y_end, const CellSpan& columns) override;
+    AlignedGrid<double>& potential() override { return state_[State::V]; }
 };
 
 #endif // CARDIACELECTROPHYSIOLOGY_H
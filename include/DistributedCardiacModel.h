@@ -0,0 +1,126 @@
+#ifndef DISTRIBUTEDCARDIACMODEL_H
+#define DISTRIBUTEDCARDIACMODEL_H
+
+/**
+ * @file DistributedCardiacModel.h
+ * @brief Cardiac electrophysiology models decomposed over MPI ranks
+ */
+
+#include <functional>
+#include <memory>
+#include <vector>
+#include "CardiacElectrophysiology.h"
+#include "DomainDecomposition.h"
+
+/**
+ * @brief Runs any CardiacElectrophysiology model on one block per MPI rank
+ *
+ * Each rank builds a local model covering its block plus one halo cell
+ * towards every neighbouring rank. The local model's edge cells are then
+ * either halo cells or cells on the global edge, where the local model
+ * applies its boundary condition as a serial run would, so after the
+ * membrane potential halo is refreshed the owned cells see exactly the
+ * neighbours they would in a serial run. Halo cells are stepped with the
+ * rest of the local model and overwritten by the next exchange. Periodic
+ * boundaries would need the wrap-around exchanged and are not supported: a
+ * periodic local model from the factory is reported and reset to zero flux.
+ *
+ * Only V couples neighbouring cells, so it is the only field exchanged.
+ * With fibers set the 9-point stencil also reads the diagonal neighbours,
+ * so the corner halo cells are exchanged too.
+ * A step posts the exchange, updates the cells that do not read the halo
+ * while it is in flight, then finishes it and updates the cells along the
+ * halo. With the sparse diffusion operator, which computes every cell's
+ * diffusion term at the start of a step, the exchange is finished first.
+ *
+ * All methods taking or returning global data are collective.
+ */
+class DistributedCardiacModel {
+public:
+    /// Creates a model of the given local size; configure cell type etc. here
+    using Factory = std::function<std::unique_ptr<CardiacElectrophysiology>(int width, int height, double dt)>;
+
+    /**
+     * @brief Constructor (collective over comm)
+     * @param width Global grid width
+     * @param height Global grid height
+     * @param dt Time step
+     * @param factory Builds the local model
+     * @param comm Communicator whose ranks share the grid
+     */
+    DistributedCardiacModel(int width, int height, double dt, const Factory& factory,
+                            MPI_Comm comm = MPI_COMM_WORLD);
+
+    /**
+     * @brief Set MI region from a function of the global coordinates
+     * @param is_mi true where the tissue is scar
+     */
+    void setMIRegion(const std::function<bool(int, int)>& is_mi);
+
+    /**
+     * @brief Set membrane potential from a function of the global coordinates
+     * @param v_init V at (x, y)
+     */
+    void setMembranePotential(const std::function<double(int, int)>& v_init);
+
+    /**
+     * @brief Set fiber-oriented anisotropic conductivity (see CardiacElectrophysiology::setFiberOrientation)
+     * @param fiber_angle Fiber angle at (x, y) of the global grid
+     * @param longitudinal Conductivity along the fibers
+     * @param transverse Conductivity across the fibers
+     * @return false if the local model rejects the field or conductivities
+     */
+    bool setFiberOrientation(const std::function<double(int, int)>& fiber_angle, double longitudinal,
+                             double transverse);
+
+    /**
+     * @brief Select the boundary condition at the global grid edge
+     * @param condition ZeroFlux or Fixed
+     * @param fixed_potential Ghost cell potential for Fixed (mV)
+     * @return false for Periodic, which is not supported (condition unchanged)
+     */
+    bool setBoundaryCondition(BoundaryCondition condition, double fixed_potential = 0.0);
+
+    /**
+     * @brief Set tissue conductivity
+     * @param conductivity Conductivity value (S/cm)
+     */
+    void setConductivity(double conductivity);
+
+    /**
+     * @brief Run one time step (collective)
+     */
+    void step();
+
+    /**
+     * @brief Run simulation for specified number of steps (collective)
+     * @param steps Number of time steps
+     */
+    void run(int steps);
+
+    /**
+     * @brief Collect the membrane potential on one rank (collective)
+     * @param root Rank that receives the grid
+     * @return Global V indexed [y][x] on root, empty elsewhere
+     */
+    std::vector<std::vector<double>> gatherMembranePotential(int root = 0) const;
+
+    /**
+     * @brief Get the local model (block plus halo cells)
+     */
+    CardiacElectrophysiology& getLocalModel() { return *model_; }
+
+    const DomainDecomposition& getDecomposition() const { return decomposition_; }
+
+    double getTime() const { return model_->getTime(); }
+
+private:
+    DomainDecomposition decomposition_;
+    int offset_x_, offset_y_;  ///< Local model coordinates of owned cell (0, 0)
+    int model_width_, model_height_;
+    std::unique_ptr<CardiacElectrophysiology> model_;
+
+    DomainDecomposition::FieldRows potentialRows();
+};
+
+#endif // DISTRIBUTEDCARDIACMODEL_H
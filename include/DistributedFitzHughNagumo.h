@@ -0,0 +1,161 @@
+#ifndef DISTRIBUTEDFITZHUGHNAGUMO_H
+#define DISTRIBUTEDFITZHUGHNAGUMO_H
+
+/**
+ * @file DistributedFitzHughNagumo.h
+ * @brief FitzHugh-Nagumo model decomposed over MPI ranks
+ */
+
+#include <functional>
+#include <memory>
+#include <vector>
+#include "AlignedGrid.h"
+#include "DomainDecomposition.h"
+#include "StimulusRows.h"
+#include "StimulusSchedule.h"
+
+/**
+ * @brief FitzHughNagumo on a grid split into one block per MPI rank
+ *
+ * Each rank stores only its block (plus a one-cell halo), so the global grid
+ * may exceed the memory of one node. A step posts the halo exchange of u
+ * (and v when dv != 0), updates the cells that do not read the halo while
+ * the messages are in flight, waits, and then updates the outermost owned
+ * rows and columns. Global edge cells receive reaction terms only and the
+ * stimulus schedule is applied as in FitzHughNagumo, so the result matches
+ * a serial run of the same grid.
+ *
+ * All methods taking or returning global data are collective.
+ */
+class DistributedFitzHughNagumo {
+public:
+    /**
+     * @brief Constructor (collective over comm)
+     * @param width Global grid width
+     * @param height Global grid height
+     * @param dt Time step
+     * @param comm Communicator whose ranks share the grid
+     */
+    DistributedFitzHughNagumo(int width, int height, double dt = 0.01, MPI_Comm comm = MPI_COMM_WORLD);
+
+    /**
+     * @brief Set model parameters
+     * @param a Parameter a
+     * @param b Parameter b
+     * @param c Parameter c
+     * @param d Parameter d
+     */
+    void setParameters(double a, double b, double c, double d);
+
+    /**
+     * @brief Set diffusion coefficients
+     * @param du Diffusion coefficient for u variable
+     * @param dv Diffusion coefficient for v variable
+     */
+    void setDiffusionCoefficients(double du, double dv);
+
+    /**
+     * @brief Set initial conditions from functions of the global coordinates
+     *
+     * Each rank evaluates the functions on its own block only.
+     * @param u_init Initial u at (x, y)
+     * @param v_init Initial v at (x, y)
+     */
+    void setInitialConditions(const std::function<double(int, int)>& u_init,
+                              const std::function<double(int, int)>& v_init);
+
+    /**
+     * @brief Add a stimulus point from the current time (global coordinates)
+     * @param x X coordinate
+     * @param y Y coordinate
+     * @param strength Stimulus strength
+     * @param duration Stimulus duration
+     */
+    void addStimulus(int x, int y, double strength, double duration);
+
+    /**
+     * @brief Replace all stimuli with a timed protocol (global coordinates)
+     * @param schedule Pulses, pulse trains and S1-S2 protocols
+     */
+    void setStimulusSchedule(const StimulusSchedule& schedule);
+
+    /**
+     * @brief Run one time step (collective)
+     */
+    void step();
+
+    /**
+     * @brief Run simulation for specified number of steps (collective)
+     * @param steps Number of time steps to run
+     */
+    void run(int steps);
+
+    /**
+     * @brief Collect u on one rank (collective)
+     * @param root Rank that receives the grid
+     * @return Global u indexed [y][x] on root, empty elsewhere
+     */
+    std::vector<std::vector<double>> gatherU(int root = 0) const;
+
+    /**
+     * @brief Collect v on one rank (collective)
+     * @param root Rank that receives the grid
+     * @return Global v indexed [y][x] on root, empty elsewhere
+     */
+    std::vector<std::vector<double>> gatherV(int root = 0) const;
+
+    /**
+     * @brief Get this rank's block of u
+     * @return View indexed [y - getYBegin()][x - getXBegin()]
+     */
+    GridView<const double> getLocalU() const { return u_.view(); }
+
+    /**
+     * @brief Get this rank's block of v
+     */
+    GridView<const double> getLocalV() const { return v_.view(); }
+
+    const DomainDecomposition& getDecomposition() const { return decomposition_; }
+
+    double getTime() const { return time_; }
+
+private:
+    DomainDecomposition decomposition_;
+    int width_, height_;          ///< Global grid size
+    int local_width_, local_height_;
+    int x_begin_, y_begin_;       ///< Global coordinates of local cell (0, 0)
+    double dt_, time_;
+    double a_, b_, c_, d_;
+    double du_, dv_;
+
+    // Local block with a one-cell halo
+    AlignedGrid<double> u_, v_;
+    AlignedGrid<double> u_new_, v_new_;
+
+    // Schedule over the global grid; the rows cover the local block only
+    StimulusSchedule stimulus_schedule_;
+    StimulusRows<double> stimulus_rows_;
+
+    /**
+     * @brief Update cells [x_begin, x_end) of local row y
+     */
+    void updateRow(int y, int x_begin, int x_end);
+
+    /**
+     * @brief Compile the schedule for the global grid and reselect the pattern
+     */
+    void compileStimulus();
+
+    /**
+     * @brief Select the pattern active at time t in stimulus_rows_
+     */
+    void selectStimulus(double t);
+
+    /**
+     * @brief Row pointer table of a local grid, halo rows included
+     */
+    template <typename Rows, typename Grid>
+    static Rows fieldRows(Grid& grid);
+};
+
+#endif // DISTRIBUTEDFITZHUGHNAGUMO_H
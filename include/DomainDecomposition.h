@@ -0,0 +1,123 @@
+#ifndef DOMAINDECOMPOSITION_H
+#define DOMAINDECOMPOSITION_H
+
+/**
+ * @file DomainDecomposition.h
+ * @brief 2D block decomposition of a grid over MPI ranks with halo exchange
+ */
+
+#include <mpi.h>
+#include <vector>
+
+/**
+ * @brief Splits a global grid into one rectangular block per MPI rank
+ *
+ * Ranks form a non-periodic px x py Cartesian grid (px along x). Rank
+ * (cx, cy) owns columns [getXBegin(), getXBegin() + getLocalWidth()) and
+ * rows [getYBegin(), getYBegin() + getLocalHeight()) of the global grid.
+ *
+ * Fields are described by a table of row pointers so that any storage with
+ * contiguous rows can be exchanged: rows[y + 1] addresses owned column 0 of
+ * local row y for y in [-1, getLocalHeight()], and the halo cells of a row
+ * are at columns -1 and getLocalWidth(). Only halo cells towards an existing
+ * neighbour are touched, so storage may omit the halo on global edges.
+ *
+ * beginHaloExchange() posts non-blocking receives and sends of the owned
+ * edge cells; the caller updates cells that do not read the halo and then
+ * calls finishHaloExchange(). Corner halo cells are only exchanged on
+ * request, with the diagonal neighbours (5-point stencils do not read them).
+ */
+class DomainDecomposition {
+public:
+    /// Row pointer table of one local field (see class description)
+    using FieldRows = std::vector<double*>;
+
+    /// Read-only row pointer table, same layout as FieldRows
+    using ConstFieldRows = std::vector<const double*>;
+
+    /**
+     * @brief Constructor (collective over comm)
+     * @param global_width Global grid width
+     * @param global_height Global grid height
+     * @param comm Communicator whose ranks share the grid
+     */
+    DomainDecomposition(int global_width, int global_height, MPI_Comm comm = MPI_COMM_WORLD);
+
+    /**
+     * @brief Destructor - frees the Cartesian communicator
+     */
+    ~DomainDecomposition();
+
+    DomainDecomposition(const DomainDecomposition&) = delete;
+    DomainDecomposition& operator=(const DomainDecomposition&) = delete;
+
+    int getRank() const { return rank_; }
+    int getSize() const { return size_; }
+    int getProcessesX() const { return dims_x_; }
+    int getProcessesY() const { return dims_y_; }
+
+    int getGlobalWidth() const { return global_width_; }
+    int getGlobalHeight() const { return global_height_; }
+    int getXBegin() const { return x_begin_; }
+    int getYBegin() const { return y_begin_; }
+    int getLocalWidth() const { return local_width_; }
+    int getLocalHeight() const { return local_height_; }
+
+    bool hasWestNeighbor() const { return neighbors_[kWest] != MPI_PROC_NULL; }
+    bool hasEastNeighbor() const { return neighbors_[kEast] != MPI_PROC_NULL; }
+    bool hasNorthNeighbor() const { return neighbors_[kNorth] != MPI_PROC_NULL; }
+    bool hasSouthNeighbor() const { return neighbors_[kSouth] != MPI_PROC_NULL; }
+
+    /// Cartesian communicator of the decomposition
+    MPI_Comm getCommunicator() const { return cart_comm_; }
+
+    /**
+     * @brief Start exchanging the halos of the given fields
+     *
+     * The owned edge cells must not change and the halo cells must not be
+     * read until finishHaloExchange() returns.
+     * @param fields Row pointer tables, one per field
+     * @param corners Also exchange the corner halo cells (e.g. for 9-point stencils)
+     */
+    void beginHaloExchange(const std::vector<FieldRows>& fields, bool corners = false);
+
+    /**
+     * @brief Wait for the exchange started by beginHaloExchange() and fill the halo columns
+     */
+    void finishHaloExchange();
+
+    /**
+     * @brief Collect a field on one rank (collective)
+     * @param field Row pointer table of the local field
+     * @param root Rank that receives the global grid
+     * @return Global grid indexed [y][x] on root, empty on every other rank
+     */
+    std::vector<std::vector<double>> gather(const ConstFieldRows& field, int root = 0) const;
+
+private:
+    // North is row -1 (smaller y), south is row local_height
+    enum Side {
+        kWest = 0, kEast = 1, kNorth = 2, kSouth = 3,
+        kNorthWest = 4, kNorthEast = 5, kSouthWest = 6, kSouthEast = 7, kSideCount = 8
+    };
+
+    static Side cornerSide(bool north, bool east) {
+        return north ? (east ? kNorthEast : kNorthWest) : (east ? kSouthEast : kSouthWest);
+    }
+
+    int global_width_, global_height_;
+    MPI_Comm cart_comm_;
+    int rank_, size_;
+    int dims_x_, dims_y_;
+    int x_begin_, y_begin_;
+    int local_width_, local_height_;
+    int neighbors_[kSideCount];
+
+    // Exchange in flight
+    std::vector<FieldRows> pending_fields_;
+    std::vector<MPI_Request> requests_;
+    std::vector<std::vector<double>> column_send_;  ///< [field * 2 + side] packed owned columns
+    std::vector<std::vector<double>> column_recv_;  ///< [field * 2 + side] received halo columns
+};
+
+#endif // DOMAINDECOMPOSITION_H
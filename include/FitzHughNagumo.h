@@ -8,22 +8,69 @@
 
 #include <vector>
 #include <functional>
+#include <memory>
 #include <string>
+#include "AlignedGrid.h"
+#include "ADIDiffusion.h"
+#include "StimulusRows.h"
+#include "StimulusSchedule.h"
 
-class FitzHughNagumo {
+class SnapshotWriter;
+class ThreadPool;
+
+/**
+ * @brief Largest deviation of a reduced-precision run from a double run
+ */
+struct PrecisionDeviation {
+    double max_abs_u;    ///< Max |u - u_double| over all cells and compared steps
+    double max_abs_v;    ///< Max |v - v_double| over all cells and compared steps
+    int steps_compared;  ///< Number of steps compared so far
+};
+
+/**
+ * @brief Time integration schemes for FitzHugh-Nagumo
+ */
+enum class TimeIntegrator {
+    ForwardEuler,  ///< Fixed step dt (default)
+    AdaptiveRK23,  ///< Bogacki-Shampine 3(2) pair with local error control
+    ImexADI        ///< Explicit reaction, implicit ADI diffusion; no diffusive dt limit
+};
+
+/**
+ * @brief On-disk formats for saveState()
+ */
+enum class StateFormat {
+    Text,    ///< Whitespace-separated values (original format)
+    Binary   ///< Versioned header followed by raw u and v payloads
+};
+
+/**
+ * @brief FitzHugh-Nagumo solver templated on the storage/compute scalar type
+ *
+ * Instantiated for double (FitzHughNagumo) and float (FitzHughNagumoF). The
+ * float solver moves half the bytes per cell and fits twice as many cells
+ * into each SIMD register; parameters, time and the public setters stay in
+ * double precision.
+ */
+template <typename T>
+class BasicFitzHughNagumo {
 public:
+    /// Tile size used by setActiveTiles()
+    static constexpr int kActiveTileWidth = 64;
+    static constexpr int kActiveTileHeight = 16;
+    
     /**
      * @brief Constructor for FitzHugh-Nagumo model
      * @param width Width of the simulation grid
      * @param height Height of the simulation grid
      * @param dt Time step
      */
-    FitzHughNagumo(int width, int height, double dt = 0.01);
+    BasicFitzHughNagumo(int width, int height, double dt = 0.01);
     
     /**
      * @brief Destructor
      */
-    ~FitzHughNagumo();
+    ~BasicFitzHughNagumo();
     
     /**
      * @brief Initialize the simulation with default parameters
@@ -56,6 +103,9 @@ public:
     
     /**
      * @brief Add stimulus at specific location
+     *
+     * Adds a single pulse to the stimulus schedule, switched on from the
+     * current time for the given duration.
      * @param x X coordinate
      * @param y Y coordinate
      * @param strength Stimulus strength
@@ -63,6 +113,141 @@ public:
      */
     void addStimulus(int x, int y, double strength, double duration);
     
+    /**
+     * @brief Replace all stimuli with a timed protocol
+     *
+     * The schedule is compiled for this grid into sparse cell lists per time
+     * window. A fixed step from t to t + dt applies the stimuli active at
+     * t + dt / 2; adaptive steps end on window boundaries.
+     * @param schedule Pulses, pulse trains and S1-S2 protocols
+     */
+    void setStimulusSchedule(const StimulusSchedule& schedule);
+    
+    /**
+     * @brief Get the stimulus schedule
+     */
+    const StimulusSchedule& getStimulusSchedule() const { return stimulus_schedule_; }
+    
+    /**
+     * @brief Record u and v every interval steps
+     *
+     * After every interval-th step the fields are copied into the writer's
+     * queue and its background thread writes them, so stepping never waits
+     * for the disk. Temporally blocked sweeps end on frame steps and the
+     * adaptive integrator reaches each frame time exactly. The writer must
+     * be open for this grid size and precision and outlive its use here.
+     * @param writer Open writer, or null to stop recording
+     * @param interval Steps between frames
+     */
+    void setOutput(SnapshotWriter* writer, int interval);
+    
+    /**
+     * @brief Set number of threads used for stepping
+     *
+     * The grid is split into contiguous row bands, one per thread, which are
+     * advanced by a persistent worker pool with a barrier between steps.
+     * @param num_threads Thread count; 1 steps serially on the calling thread,
+     *                    values <= 0 select the hardware concurrency
+     */
+    void setNumThreads(int num_threads);
+    
+    /**
+     * @brief Get number of threads used for stepping
+     * @return Thread count
+     */
+    int getNumThreads() const;
+    
+    /**
+     * @brief Enable temporally blocked execution in run()
+     *
+     * run() then advances cache-sized column tiles by several time steps
+     * each (skewed wavefront over rows and time levels) instead of streaming
+     * the whole grid through memory once per step. Results are bit-identical
+     * to stepping one step at a time. Blocking applies when stepping on a
+     * single thread; with setNumThreads() > 1 run() uses row bands instead.
+     * @param steps_per_block Time steps per tile sweep; <= 1 disables blocking
+     * @param tile_width Columns per tile; 0 sizes tiles to stay cache resident
+     */
+    void setTemporalBlocking(int steps_per_block, int tile_width = 0);
+    
+    /**
+     * @brief Enable skipping of quiescent tiles in forward Euler steps
+     *
+     * The grid is split into tiles of kActiveTileWidth x kActiveTileHeight
+     * cells. A tile is updated only if it or one of its four neighbouring
+     * tiles changed in the previous step; otherwise its inputs (own cells,
+     * stencil halo, stimulus, parameters) are those of the previous step and
+     * recomputing it would reproduce its current values, so skipping it is
+     * exact. A tile counts as changed if any u or v moved by more than
+     * threshold; an updated tile that did not change is restored to its
+     * previous values. With threshold 0 results are bit-identical to full
+     * stepping; a positive threshold freezes cells drifting slower than that.
+     * Any change made through the setters marks all tiles active again.
+     * Takes precedence over temporal blocking.
+     * @param enabled true to enable
+     * @param threshold Largest per-step change treated as no change
+     */
+    void setActiveTiles(bool enabled, double threshold = 0.0);
+    
+    /**
+     * @brief Get the fraction of tiles updated in the last step
+     * @return Fraction in [0, 1]; 1 when active tiles are disabled
+     */
+    double getActiveTileFraction() const;
+    
+    /**
+     * @brief Enable or disable accuracy comparison against a double run
+     *
+     * When enabled, a double-precision copy of the model is advanced next to
+     * this one from the same state, parameters and stimuli, and the largest
+     * deviation of u and v is recorded after every step. Comparison runs the
+     * steps one at a time (temporal blocking is not used meanwhile).
+     * Enabling resets the recorded deviation.
+     * @param enabled true to enable
+     */
+    void setAccuracyComparison(bool enabled);
+    
+    /**
+     * @brief Get the deviation recorded by the accuracy comparison
+     * @return Deviation since comparison was enabled (zero when disabled)
+     */
+    PrecisionDeviation getPrecisionDeviation() const;
+    
+    /**
+     * @brief Select the time integrator
+     *
+     * With AdaptiveRK23, step() and run(steps) still advance the clock by dt
+     * and steps * dt, but cover that interval with as many internal steps as
+     * the error control requires: short ones through the upstroke, long ones
+     * during recovery. A step is accepted when the max-norm of the embedded
+     * error estimate, scaled by abs_tol + rel_tol * |state|, is at most 1.
+     * Temporal blocking is not used by the adaptive integrator.
+     * @param integrator Integration scheme
+     * @param rel_tol Relative tolerance (adaptive only)
+     * @param abs_tol Absolute tolerance (adaptive only)
+     */
+    void setIntegrator(TimeIntegrator integrator, double rel_tol = 1e-4, double abs_tol = 1e-6);
+    
+    /**
+     * @brief Get the selected time integrator
+     */
+    TimeIntegrator getIntegrator() const;
+    
+    /**
+     * @brief Get the number of accepted adaptive steps since setIntegrator()
+     */
+    long long getAcceptedSteps() const;
+    
+    /**
+     * @brief Get the number of rejected adaptive steps since setIntegrator()
+     */
+    long long getRejectedSteps() const;
+    
+    /**
+     * @brief Get the step size the adaptive integrator will try next
+     */
+    double getAdaptiveStepSize() const;
+    
     /**
      * @brief Run one time step of the simulation
      */
@@ -76,15 +261,15 @@ public:
     
     /**
      * @brief Get current u variable values
-     * @return 2D grid of u values
+     * @return View of the u grid, indexed [y][x]; invalidated by the next step
      */
-    const std::vector<std::vector<double>>& getU() const;
+    GridView<const T> getU() const;
     
     /**
      * @brief Get current v variable values
-     * @return 2D grid of v values
+     * @return View of the v grid, indexed [y][x]; invalidated by the next step
      */
-    const std::vector<std::vector<double>>& getV() const;
+    GridView<const T> getV() const;
     
     /**
      * @brief Get current simulation time
@@ -94,19 +279,30 @@ public:
     
     /**
      * @brief Save current state to file
+     *
+     * The binary format (version 1) is a fixed header holding a magic tag,
+     * version, dtype, grid size, time, a..d and du/dv, followed at a 64-byte
+     * aligned offset by the u and then the v field, row-major, in the
+     * solver's precision and native byte order.
      * @param filename Output filename
+     * @param format Text (default, readable by the analysis scripts) or Binary
      * @return true if successful, false otherwise
      */
-    bool saveState(const std::string& filename) const;
+    bool saveState(const std::string& filename, StateFormat format = StateFormat::Text) const;
     
     /**
      * @brief Load state from file
+     *
+     * The format is detected from the file contents. Binary checkpoints are
+     * memory-mapped and may have been written by a solver of either precision.
      * @param filename Input filename
      * @return true if successful, false otherwise
      */
     bool loadState(const std::string& filename);
 
 private:
+    template <typename> friend class BasicFitzHughNagumo;
+    
     int width_;          ///< Width of the simulation grid
     int height_;         ///< Height of the simulation grid
     double dt_;          ///< Time step
@@ -117,23 +313,191 @@ private:
     double du_, dv_;     ///< Diffusion coefficients
     
     // State variables
-    std::vector<std::vector<double>> u_;  ///< Fast variable (membrane potential)
-    std::vector<std::vector<double>> v_;  ///< Slow variable (recovery)
-    std::vector<std::vector<double>> u_new_;  ///< Temporary storage for u
-    std::vector<std::vector<double>> v_new_;  ///< Temporary storage for v
+    AlignedGrid<T> u_;      ///< Fast variable (membrane potential)
+    AlignedGrid<T> v_;      ///< Slow variable (recovery)
+    AlignedGrid<T> u_new_;  ///< Temporary storage for u
+    AlignedGrid<T> v_new_;  ///< Temporary storage for v
+    
+    // Stimulus: the step kernels read stimulus_rows_.row(y), which is a
+    // zero row unless row y is stimulated in the current window
+    StimulusSchedule stimulus_schedule_;
+    StimulusRows<T> stimulus_rows_;
+    
+    std::unique_ptr<ThreadPool> pool_;  ///< Workers for parallel stepping (null when serial)
+    
+    int block_steps_;       ///< Time steps per temporally blocked sweep (<= 1: off)
+    int block_tile_width_;  ///< Tile width for blocked sweeps (0: automatic)
+    
+    // Adaptive integration
+    TimeIntegrator integrator_;
+    double rel_tol_, abs_tol_;   ///< Error tolerances
+    double adaptive_step_;       ///< Next internal step size to try
+    long long accepted_steps_;
+    long long rejected_steps_;
+    AlignedGrid<T> rate_u_[4];   ///< Stage derivatives k1..k4 of u
+    AlignedGrid<T> rate_v_[4];   ///< Stage derivatives k1..k4 of v
+    AlignedGrid<T> stage_u_[2];  ///< Alternating stage inputs for u; [0] ends as the candidate
+    AlignedGrid<T> stage_v_[2];  ///< Alternating stage inputs for v
     
-    // Stimulus
-    std::vector<std::vector<double>> stimulus_;
+    // Active-tile tracking
+    bool active_tiles_;                        ///< Skip tiles that cannot change
+    double active_threshold_;                  ///< Change treated as none
+    bool activity_valid_;                      ///< tile_active_ matches the current state
+    int tiles_x_, tiles_y_;                    ///< Tile grid size
+    std::vector<unsigned char> tile_active_;   ///< Tiles to update in the next step
+    std::vector<unsigned char> tile_changed_;  ///< Tiles changed by the last step
+    int last_active_count_;                    ///< Tiles updated in the last step
+    
+    // IMEX diffusion solvers (configured on first use)
+    ADIDiffusion<T> adi_u_;
+    ADIDiffusion<T> adi_v_;
+    
+    // Time-series output
+    SnapshotWriter* output_;   ///< Frame writer (null: no output)
+    int output_interval_;      ///< Steps between frames
+    long long step_count_;     ///< Steps taken (adaptive runs count dt units)
+    
+    std::unique_ptr<BasicFitzHughNagumo<double>> reference_;  ///< Double run for accuracy comparison
+    PrecisionDeviation deviation_;                             ///< Recorded deviation from reference_
+    
+    /**
+     * @brief Copy state, parameters and stimuli into the reference model
+     */
+    void syncReference();
+    
+    /**
+     * @brief Advance the reference model one step and record the deviation
+     */
+    void compareWithReference();
+    
+    /**
+     * @brief Integrate over an interval with the adaptive RK2(3) pair
+     * @param interval Simulated time to advance
+     */
+    void advanceAdaptive(double interval);
+    
+    /**
+     * @brief Mark every tile active if the state changed outside of stepping
+     */
+    void prepareActiveTiles();
+    
+    /**
+     * @brief Euler update of the active tiles in a band of tile rows
+     *
+     * Records which tiles changed and restores tiles that did not.
+     * @param tile_row_begin First tile row
+     * @param tile_row_end One past the last tile row
+     */
+    void updateActiveTiles(int tile_row_begin, int tile_row_end);
+    
+    /**
+     * @brief Derive the next active set from the changed tiles and finish the step
+     */
+    void finishActiveStep();
+    
+    /**
+     * @brief One IMEX step: explicit reaction, then implicit ADI diffusion
+     */
+    void advanceImex();
+    
+    /**
+     * @brief Run a row-band task on the pool, or serially without one
+     * @param task Callable receiving (thread index, first row, end row)
+     */
+    void forEachBand(const std::function<void(int, int, int)>& task);
+    
+    /**
+     * @brief Evaluate the right-hand side (du/dt, dv/dt) for a band of rows
+     *
+     * Boundary cells receive the reaction terms only, as in the Euler update.
+     */
+    void evaluateRates(const AlignedGrid<T>& u_src, const AlignedGrid<T>& v_src,
+                       AlignedGrid<T>& rate_u, AlignedGrid<T>& rate_v, int y_begin, int y_end);
+    
+    /**
+     * @brief Write state + h * sum(weights[i] * k_i) for a band of rows
+     */
+    void combineStage(double h, const double* weights, int num_rates,
+                      AlignedGrid<T>& out_u, AlignedGrid<T>& out_v, int y_begin, int y_end);
     
     /**
-     * @brief Apply diffusion operator
-     * @param grid Input grid
-     * @param coeff Diffusion coefficient
-     * @param result Output grid
+     * @brief Write the binary checkpoint format
      */
-    void applyDiffusion(const std::vector<std::vector<double>>& grid,
-                       double coeff,
-                       std::vector<std::vector<double>>& result);
+    bool saveBinaryState(const std::string& filename) const;
+    
+    /**
+     * @brief Read a binary checkpoint from a mapped file
+     * @param bytes Start of the mapped file
+     * @param size Size of the mapped file in bytes
+     * @param filename File name for error messages
+     */
+    bool loadBinaryState(const unsigned char* bytes, std::size_t size, const std::string& filename);
+    
+    /**
+     * @brief Swap state and step buffers, advance the clock and select the
+     *        stimulus of the next step
+     */
+    void finishStep();
+    
+    /**
+     * @brief Count finished steps and queue a frame when one is due
+     * @param steps Steps just finished
+     */
+    void recordOutput(int steps);
+    
+    /**
+     * @brief Get the number of steps until the next frame
+     */
+    int stepsUntilOutput() const;
+    
+    /**
+     * @brief Compile the schedule for this grid and select the current stimulus
+     */
+    void compileStimulus();
+    
+    /**
+     * @brief Select the pattern active at time t in stimulus_rows_
+     * @return true if the pattern changed
+     */
+    bool selectStimulus(double t);
+    
+    /**
+     * @brief Select the stimulus for the next fixed step and count the steps it lasts
+     * @param max_steps Largest count of interest
+     * @return Steps (at least 1, at most max_steps) with the same stimulus
+     */
+    int stepsWithCurrentStimulus(int max_steps);
+    
+    /**
+     * @brief Fused diffusion, reaction and Euler update for a band of rows
+     *
+     * Reads u_, v_ and the stimulus rows and writes u_new_, v_new_ in a single sweep.
+     * @param y_begin First row to update
+     * @param y_end One past the last row to update
+     */
+    void updateRows(int y_begin, int y_end);
+    
+    /**
+     * @brief Fused diffusion, reaction and Euler update for part of one row
+     *
+     * Boundary cells receive the reaction terms only.
+     * @param u_src Current u values
+     * @param v_src Current v values
+     * @param u_dst Updated u values
+     * @param v_dst Updated v values
+     * @param y Row to update
+     * @param x_begin First column to update
+     * @param x_end One past the last column to update
+     */
+    void updateRow(const AlignedGrid<T>& u_src, const AlignedGrid<T>& v_src,
+                   AlignedGrid<T>& u_dst, AlignedGrid<T>& v_dst,
+                   int y, int x_begin, int x_end);
+    
+    /**
+     * @brief Advance all cells by several steps with a skewed tile wavefront
+     * @param steps Number of time steps (levels) in this sweep
+     */
+    void advanceBlock(int steps);
     
     /**
      * @brief Apply reaction terms
@@ -142,7 +506,7 @@ private:
      * @param stim_val Stimulus value
      * @return Reaction term for u
      */
-    double reactionU(double u_val, double v_val, double stim_val);
+    T reactionU(T u_val, T v_val, T stim_val);
     
     /**
      * @brief Apply reaction terms for v
@@ -150,7 +514,7 @@ private:
      * @param v_val Current v value
      * @return Reaction term for v
      */
-    double reactionV(double u_val, double v_val);
+    T reactionV(T u_val, T v_val);
     
     /**
      * @brief Check if coordinates are within bounds
@@ -161,4 +525,10 @@ private:
     bool isValidCoordinate(int x, int y) const;
 };
 
+/// Double-precision FitzHugh-Nagumo solver
+using FitzHughNagumo = BasicFitzHughNagumo<double>;
+
+/// Single-precision FitzHugh-Nagumo solver
+using FitzHughNagumoF = BasicFitzHughNagumo<float>;
+
 #endif // FITZHUGHNAGUMO_H
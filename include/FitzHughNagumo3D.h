@@ -0,0 +1,206 @@
+#ifndef FITZHUGHNAGUMO3D_H
+#define FITZHUGHNAGUMO3D_H
+
+/**
+ * @file FitzHughNagumo3D.h
+ * @brief FitzHugh-Nagumo model on a 3D grid for transmural propagation
+ */
+
+#include <memory>
+#include <vector>
+#include "AlignedGrid.h"
+#include "StimulusRows.h"
+#include "StimulusSchedule.h"
+
+class ThreadPool;
+
+/**
+ * @brief Discrete Laplacians available in 3D
+ */
+enum class Stencil3D {
+    SevenPoint,    ///< Face neighbours only (default, vectorized)
+    NineteenPoint  ///< Face and edge neighbours; more isotropic wavefronts
+};
+
+/**
+ * @brief FitzHugh-Nagumo solver on a width x height x depth grid
+ *
+ * Mirrors FitzHughNagumo with a z coordinate added. The grid is stored as
+ * depth planes of aligned rows in one allocation, so the z neighbours of a
+ * row are a fixed number of rows away. A step sweeps bricks of full-width
+ * rows: for each band of block-height rows every plane of the thread's
+ * z-slab is updated in turn, so the three input planes of that band stay in
+ * cache while the sweep moves through z instead of each plane being fetched
+ * from memory three times. Threads own contiguous z-slabs and meet at a
+ * barrier between steps. Boundary cells (outer faces) receive reaction
+ * terms only, as in 2D.
+ */
+class FitzHughNagumo3D {
+public:
+    /**
+     * @brief Constructor
+     * @param width Number of cells in x
+     * @param height Number of cells in y
+     * @param depth Number of cells in z (transmural direction)
+     * @param dt Time step
+     */
+    FitzHughNagumo3D(int width, int height, int depth, double dt = 0.01);
+
+    /**
+     * @brief Destructor
+     */
+    ~FitzHughNagumo3D();
+
+    /**
+     * @brief Initialize the simulation with small random perturbations
+     */
+    void initialize();
+
+    /**
+     * @brief Set model parameters
+     * @param a Parameter a
+     * @param b Parameter b
+     * @param c Parameter c
+     * @param d Parameter d
+     */
+    void setParameters(double a, double b, double c, double d);
+
+    /**
+     * @brief Set diffusion coefficients
+     * @param du Diffusion coefficient for u variable
+     * @param dv Diffusion coefficient for v variable
+     */
+    void setDiffusionCoefficients(double du, double dv);
+
+    /**
+     * @brief Set initial conditions
+     * @param u_init Initial values for u, indexed [z][y][x]
+     * @param v_init Initial values for v, indexed [z][y][x]
+     */
+    void setInitialConditions(const std::vector<std::vector<std::vector<double>>>& u_init,
+                              const std::vector<std::vector<std::vector<double>>>& v_init);
+
+    /**
+     * @brief Add stimulus at specific location
+     * @param x X coordinate
+     * @param y Y coordinate
+     * @param z Z coordinate
+     * @param strength Stimulus strength
+     * @param duration Stimulus duration, starting at the current time (as in FitzHughNagumo)
+     */
+    void addStimulus(int x, int y, int z, double strength, double duration);
+
+    /**
+     * @brief Select the discrete Laplacian
+     */
+    void setStencil(Stencil3D stencil);
+
+    Stencil3D getStencil() const { return stencil_; }
+
+    /**
+     * @brief Set the number of rows per brick of the cache-blocked sweep
+     * @param rows Rows per brick; 0 sizes bricks to keep three planes cache resident
+     */
+    void setBlockHeight(int rows);
+
+    /**
+     * @brief Set number of threads used for stepping
+     * @param num_threads Thread count (at most one per plane); values <= 0
+     *                    select the hardware concurrency
+     */
+    void setNumThreads(int num_threads);
+
+    int getNumThreads() const;
+
+    /**
+     * @brief Perform one simulation step
+     */
+    void step();
+
+    /**
+     * @brief Run simulation for specified number of steps
+     * @param steps Number of steps to run
+     */
+    void run(int steps);
+
+    /**
+     * @brief Get one z-plane of the u field
+     * @param z Plane index
+     * @return View into the simulation grid, invalidated by the next step
+     */
+    GridView<const double> getU(int z) const;
+
+    /**
+     * @brief Get one z-plane of the v field
+     * @param z Plane index
+     * @return View into the simulation grid, invalidated by the next step
+     */
+    GridView<const double> getV(int z) const;
+
+    double getTime() const { return time_; }
+    int getWidth() const { return width_; }
+    int getHeight() const { return height_; }
+    int getDepth() const { return depth_; }
+
+private:
+    int width_, height_, depth_;
+    double dt_;
+    double time_;
+
+    // Model parameters
+    double a_, b_, c_, d_;
+    double du_, dv_;
+
+    // Plane z, row y at grid row z * height_ + y
+    AlignedGrid<double> u_, v_;
+    AlignedGrid<double> u_new_, v_new_;
+
+    // Stimulus pulses, compiled over the width x (height * depth) grid rows
+    StimulusSchedule stimulus_schedule_;
+    StimulusRows<double> stimulus_rows_;
+
+    Stencil3D stencil_;
+    int block_height_;  ///< Rows per brick (0: automatic)
+
+    std::unique_ptr<ThreadPool> pool_;
+
+    /**
+     * @brief Update planes [z_begin, z_end) brick by brick into the step buffers
+     */
+    void updateSlab(int z_begin, int z_end);
+
+    /**
+     * @brief Update one row of one plane
+     */
+    void updateRow(int y, int z);
+
+    /**
+     * @brief 19-point interior update of one row
+     */
+    void updateRow19(int y, int z);
+
+    /**
+     * @brief Reaction-only update of cells [x_begin, x_end) of one row
+     */
+    void updateBoundary(int y, int z, int x_begin, int x_end);
+
+    /**
+     * @brief Swap the step buffers, advance time and select the next step's stimulus
+     */
+    void finishStep();
+
+    /**
+     * @brief Compile the schedule for this grid and select the current stimulus
+     */
+    void compileStimulus();
+
+    int effectiveBlockHeight() const;
+    int rowIndex(int y, int z) const { return z * height_ + y; }
+
+    double reactionU(double u_val, double v_val, double stim_val) const;
+    double reactionV(double u_val, double v_val) const;
+
+    bool isValidCoordinate(int x, int y, int z) const;
+};
+
+#endif // FITZHUGHNAGUMO3D_H
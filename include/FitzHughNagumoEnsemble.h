@@ -0,0 +1,183 @@
+#ifndef FITZHUGHNAGUMOENSEMBLE_H
+#define FITZHUGHNAGUMOENSEMBLE_H
+
+/**
+ * @file FitzHughNagumoEnsemble.h
+ * @brief Many FitzHugh-Nagumo simulations with different parameters stepped together
+ */
+
+#include <memory>
+#include <vector>
+#include "AlignedGrid.h"
+#include "StimulusRows.h"
+#include "StimulusSchedule.h"
+
+class ThreadPool;
+
+/**
+ * @brief Parameters of one ensemble member (see FitzHughNagumo::setParameters)
+ */
+struct FHNMemberParameters {
+    double a = 0.1;
+    double b = 0.5;
+    double c = 1.0;
+    double d = 0.0;
+    double du = 0.1;   ///< Diffusion coefficient for u
+    double dv = 0.0;   ///< Diffusion coefficient for v
+};
+
+/**
+ * @brief Ensemble of same-sized FitzHugh-Nagumo grids that differ in parameters
+ *
+ * Members are stored interleaved, member-fastest: the values of all members
+ * at one cell are contiguous, so a SIMD register holds one cell of several
+ * members and each lane applies its member's parameters. One sweep of the
+ * stencil then advances the whole ensemble, and per-cell neighbour loads
+ * are shared by all members instead of being repeated per simulation. The
+ * member count is padded to StencilKernels::kEnsembleBlock slots; padding
+ * slots hold a zero state that never changes.
+ *
+ * Each member follows the same forward Euler update as FitzHughNagumo and
+ * agrees with a separately run FitzHughNagumo to rounding.
+ */
+class FitzHughNagumoEnsemble {
+public:
+    /**
+     * @brief Constructor
+     * @param width Width of every member grid
+     * @param height Height of every member grid
+     * @param members Number of members
+     * @param dt Time step shared by all members
+     */
+    FitzHughNagumoEnsemble(int width, int height, int members, double dt = 0.01);
+
+    /**
+     * @brief Destructor
+     */
+    ~FitzHughNagumoEnsemble();
+
+    /**
+     * @brief Set the parameters of one member
+     * @param member Member index
+     * @param parameters Model and diffusion parameters
+     */
+    void setMemberParameters(int member, const FHNMemberParameters& parameters);
+
+    /**
+     * @brief Get the parameters of one member
+     */
+    FHNMemberParameters getMemberParameters(int member) const;
+
+    /**
+     * @brief Set the initial state of one member
+     * @param member Member index
+     * @param u_init Initial values for u
+     * @param v_init Initial values for v
+     */
+    void setInitialConditions(int member, const std::vector<std::vector<double>>& u_init,
+                              const std::vector<std::vector<double>>& v_init);
+
+    /**
+     * @brief Set the same initial state for every member
+     */
+    void setInitialConditions(const std::vector<std::vector<double>>& u_init,
+                              const std::vector<std::vector<double>>& v_init);
+
+    /**
+     * @brief Add a stimulus to one member
+     * @param member Member index
+     * @param x X coordinate
+     * @param y Y coordinate
+     * @param strength Stimulus strength
+     * @param duration Stimulus duration, starting at the current time (as in FitzHughNagumo)
+     */
+    void addStimulus(int member, int x, int y, double strength, double duration);
+
+    /**
+     * @brief Add the same stimulus to every member
+     */
+    void addStimulus(int x, int y, double strength, double duration);
+
+    /**
+     * @brief Set number of threads used for stepping (row bands, as in FitzHughNagumo)
+     * @param num_threads Thread count; values <= 0 select the hardware concurrency
+     */
+    void setNumThreads(int num_threads);
+
+    int getNumThreads() const;
+
+    /**
+     * @brief Advance every member by one time step
+     */
+    void step();
+
+    /**
+     * @brief Advance every member by a number of time steps
+     * @param steps Number of steps
+     */
+    void run(int steps);
+
+    /**
+     * @brief Get the u field of one member
+     * @return View into the ensemble storage, invalidated by the next step
+     */
+    StridedGridView<const double> getU(int member) const;
+
+    /**
+     * @brief Get the v field of one member
+     * @return View into the ensemble storage, invalidated by the next step
+     */
+    StridedGridView<const double> getV(int member) const;
+
+    int getWidth() const { return width_; }
+    int getHeight() const { return height_; }
+    int getMemberCount() const { return members_; }
+    double getTime() const { return time_; }
+
+private:
+    int width_, height_;
+    int members_;   ///< Members in use
+    int slots_;     ///< Members per cell in storage (padded)
+    double dt_;
+    double time_;
+
+    std::vector<FHNMemberParameters> parameters_;
+
+    // Kernel coefficients, one per slot
+    std::vector<double> du_, dv_, a_, b_, inv_c_;
+
+    // Interleaved fields: cell (x, y) of member m at row(y)[x * slots_ + m]
+    AlignedGrid<double> u_, v_;
+    AlignedGrid<double> u_new_, v_new_;
+
+    // Stimulus pulses, compiled over the interleaved columns (x * slots_ + m)
+    StimulusSchedule stimulus_schedule_;
+    StimulusRows<double> stimulus_rows_;
+
+    std::unique_ptr<ThreadPool> pool_;
+
+    /**
+     * @brief Euler update of rows [y_begin, y_end) into the step buffers
+     */
+    void updateRows(int y_begin, int y_end);
+
+    /**
+     * @brief Reaction-only update of the boundary cells x in [x_begin, x_end) of row y
+     */
+    void updateBoundary(int y, int x_begin, int x_end);
+
+    /**
+     * @brief Swap the step buffers, advance time and select the next step's stimulus
+     */
+    void finishStep();
+
+    /**
+     * @brief Compile the schedule for this grid and select the current stimulus
+     */
+    void compileStimulus();
+
+    bool isValidMember(int member) const;
+    bool isValidCoordinate(int x, int y) const;
+};
+
+#endif // FITZHUGHNAGUMOENSEMBLE_H
@@ -0,0 +1,52 @@
+#ifndef IONICSTATE_H
+#define IONICSTATE_H
+
+/**
+ * @file IonicState.h
+ * @brief Structure-of-arrays storage for the state variables of ionic models
+ */
+
+#include <array>
+#include <cstddef>
+#include "AlignedGrid.h"
+
+/**
+ * @brief One aligned, contiguous grid per integrated state variable
+ *
+ * Indexed by the model's state enum (whose last enumerator is the count), so
+ * only the variables a model actually integrates take memory and a row sweep
+ * streams each variable through its own cache lines, with neighbouring cells
+ * in neighbouring vector lanes. Every grid carries a one-cell halo so the
+ * membrane potential can feed stencils directly.
+ */
+template <typename Variable>
+class IonicState {
+public:
+    /// Number of state variables
+    static constexpr int kCount = static_cast<int>(Variable::Count);
+
+    IonicState() = default;
+
+    /**
+     * @brief Allocate every variable and set it to its initial value
+     * @param width Grid width
+     * @param height Grid height
+     * @param initial Initial value of each variable, in enum order
+     */
+    IonicState(int width, int height, const std::array<double, kCount>& initial) {
+        for (int i = 0; i < kCount; ++i) {
+            fields_[i].resize(width, height, 1, initial[i]);
+        }
+    }
+
+    AlignedGrid<double>& operator[](Variable variable) { return fields_[static_cast<int>(variable)]; }
+    const AlignedGrid<double>& operator[](Variable variable) const { return fields_[static_cast<int>(variable)]; }
+
+    /// State memory per cell in bytes (row padding and halo excluded)
+    static constexpr std::size_t bytesPerCell() { return kCount * sizeof(double); }
+
+private:
+    std::array<AlignedGrid<double>, kCount> fields_;
+};
+
+#endif // IONICSTATE_H
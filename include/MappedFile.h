@@ -0,0 +1,62 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+/**
+ * @file MappedFile.h
+ * @brief Read-only memory mapping of a whole file
+ */
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Read-only view of a file's contents backed by mmap
+ *
+ * Pages are only read from disk when touched, so opening a large checkpoint
+ * costs a system call rather than a full read. On platforms without mmap the
+ * file is read into memory instead.
+ */
+class MappedFile {
+public:
+    MappedFile();
+
+    /**
+     * @brief Destructor - unmaps the file
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Map a file, replacing any previous mapping
+     * @param filename File to map
+     * @return true if successful, false otherwise
+     */
+    bool open(const std::string& filename);
+
+    /**
+     * @brief Unmap the file
+     */
+    void close();
+
+    /**
+     * @brief Get the mapped bytes (null when nothing is mapped)
+     */
+    const unsigned char* data() const { return data_; }
+
+    /**
+     * @brief Get the number of mapped bytes
+     */
+    std::size_t size() const { return size_; }
+
+    bool isOpen() const { return data_ != nullptr; }
+
+private:
+    const unsigned char* data_;
+    std::size_t size_;
+    std::vector<unsigned char> fallback_;  ///< Contents when mmap is unavailable
+};
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,127 @@
+#ifndef RATETABLE_H
+#define RATETABLE_H
+
+/**
+ * @file RateTable.h
+ * @brief Interpolated lookup tables of voltage-dependent rate functions
+ */
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Samples of several functions of the membrane potential on a uniform grid
+ *
+ * All functions share one voltage axis and are stored interleaved, so the
+ * lookup of every function at one V reads two adjacent table rows and
+ * replaces each exp() by a linear interpolation. Voltages outside the table
+ * (or NaN) fall back to the exact functions.
+ *
+ * Tables are immutable once built and safe to share between models and
+ * threads; shared() hands out one table per key and resolution for as long
+ * as any model holds it.
+ */
+class RateTable {
+public:
+    /// Writes the value of every tabulated function at V into values[0 .. columns)
+    using Function = std::function<void(double V, double* values)>;
+
+    /**
+     * @brief Tabulate functions and measure the interpolation error
+     * @param v_min Lowest tabulated potential (mV)
+     * @param v_max Highest tabulated potential (mV)
+     * @param resolution Sample spacing (mV)
+     * @param columns Number of functions (at most kMaxColumns)
+     * @param function Exact functions
+     */
+    RateTable(double v_min, double v_max, double resolution, int columns, Function function);
+
+    /**
+     * @brief Get a table shared by every caller with the same arguments
+     *
+     * Thread-safe. Callers must pass the same functions for the same key.
+     * @param key Names the tabulated functions (e.g. the model)
+     * @param v_min Lowest tabulated potential (mV)
+     * @param v_max Highest tabulated potential (mV)
+     * @param resolution Sample spacing (mV)
+     * @param columns Number of functions (at most kMaxColumns)
+     * @param function Exact functions, only called if the table is built
+     * @return The table, or nullptr if the range or resolution is invalid
+     */
+    static std::shared_ptr<const RateTable> shared(const std::string& key, double v_min, double v_max,
+                                                   double resolution, int columns, const Function& function);
+
+    /**
+     * @brief Interpolate every function at V
+     * @param V Membrane potential (mV)
+     * @param values Receives one value per column
+     */
+    void lookup(double V, double* values) const {
+        double position = (V - v_min_) * inverse_resolution_;
+        // Range-check the index too: -ffinite-math-only may drop the NaN test
+        int i = static_cast<int>(position);
+        if (!(position >= 0.0 && position < intervals_) || i < 0 || i >= intervals_) {
+            function_(V, values);
+            return;
+        }
+        double t = position - i;
+        const double* lower = &samples_[static_cast<std::size_t>(i) * columns_];
+        const double* upper = lower + columns_;
+        for (int c = 0; c < columns_; ++c) {
+            values[c] = lower[c] + t * (upper[c] - lower[c]);
+        }
+    }
+
+    /**
+     * @brief Interpolate every function at a row of potentials
+     * @param V Membrane potentials
+     * @param count Number of potentials
+     * @param values Receives values[c][i] for column c at V[i]
+     */
+    void lookup(const double* V, int count, double* const* values) const {
+        double row[kMaxColumns];
+        for (int i = 0; i < count; ++i) {
+            lookup(V[i], row);
+            for (int c = 0; c < columns_; ++c) {
+                values[c][i] = row[c];
+            }
+        }
+    }
+
+    /// Most columns a table may have
+    static constexpr int kMaxColumns = 16;
+
+    /**
+     * @brief Largest absolute interpolation error of one function
+     *
+     * Measured against the exact function at the midpoint and quarter points
+     * of every interval when the table is built.
+     */
+    double getMaxError(int column) const { return max_error_[column]; }
+
+    /**
+     * @brief Largest interpolation error relative to the exact value, over all functions
+     */
+    double getMaxRelativeError() const { return max_relative_error_; }
+
+    double getResolution() const { return resolution_; }
+    double getMinVoltage() const { return v_min_; }
+    double getMaxVoltage() const { return v_min_ + intervals_ * resolution_; }
+    int getColumnCount() const { return columns_; }
+
+    /// Table memory in bytes
+    std::size_t getBytes() const { return samples_.size() * sizeof(double); }
+
+private:
+    double v_min_, resolution_, inverse_resolution_;
+    int intervals_, columns_;
+    Function function_;
+    std::vector<double> samples_;  ///< (intervals_ + 1) rows of columns_ values
+    std::vector<double> max_error_;
+    double max_relative_error_;
+};
+
+#endif // RATETABLE_H
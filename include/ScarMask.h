@@ -0,0 +1,141 @@
+#ifndef SCARMASK_H
+#define SCARMASK_H
+
+/**
+ * @file ScarMask.h
+ * @brief Bit-packed scar mask with precomputed per-row spans of excitable cells
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Half-open range [begin, end) of cells in one grid row
+ */
+struct CellSpan {
+    int begin, end;
+
+    /// Part of the span inside columns; empty (begin >= end) when they do not meet
+    CellSpan clip(const CellSpan& columns) const {
+        return {std::max(begin, columns.begin), std::min(end, columns.end)};
+    }
+};
+
+/**
+ * @brief The spans of one row, for range-for loops
+ */
+class CellSpans {
+public:
+    CellSpans(const CellSpan* first, const CellSpan* last) : first_(first), last_(last) {}
+
+    const CellSpan* begin() const { return first_; }
+    const CellSpan* end() const { return last_; }
+    bool empty() const { return first_ == last_; }
+    std::size_t size() const { return static_cast<std::size_t>(last_ - first_); }
+
+private:
+    const CellSpan* first_;
+    const CellSpan* last_;
+};
+
+/**
+ * @brief Scar (non-excitable) cells of a 2D grid, one bit per cell
+ *
+ * Row y starts at word y * stride(); bit x % 64 of its word x / 64 is set in
+ * scar cells, and bits past the width are ignored. The runs of excitable
+ * (live) cells and of scar cells in every row are extracted once when the
+ * mask is built, so sweeps loop over spans instead of testing each cell.
+ *
+ * A mask either owns its words or views words owned by the caller, e.g. the
+ * output buffer of a segmentation, which must then outlive it. Masks are
+ * move-only so that the spans are never silently recomputed or duplicated.
+ */
+class ScarMask {
+public:
+    /// Empty (0 x 0) mask
+    ScarMask();
+
+    /**
+     * @brief Mask without scar cells
+     * @param width Grid width
+     * @param height Grid height
+     */
+    ScarMask(int width, int height);
+
+    /**
+     * @brief Pack a boolean grid (true in scar cells)
+     * @param region One row per y, each at least as wide as the first row
+     */
+    explicit ScarMask(const std::vector<std::vector<bool>>& region);
+
+    ScarMask(ScarMask&&) = default;
+    ScarMask& operator=(ScarMask&&) = default;
+    ScarMask(const ScarMask&) = delete;
+    ScarMask& operator=(const ScarMask&) = delete;
+
+    /**
+     * @brief Take ownership of packed words without copying them
+     * @param words height * wordsPerRow(width) words, rows back to back
+     * @param width Grid width
+     * @param height Grid height
+     * @return The mask, or an empty mask if words has the wrong size
+     */
+    static ScarMask fromWords(std::vector<uint64_t> words, int width, int height);
+
+    /**
+     * @brief View packed words owned by the caller (zero-copy)
+     * @param words Word 0 of row 0; must stay valid and unchanged while the mask is used
+     * @param width Grid width
+     * @param height Grid height
+     * @param stride Words between consecutive rows (at least wordsPerRow(width))
+     * @return The mask, or an empty mask if the stride is too small
+     */
+    static ScarMask view(const uint64_t* words, int width, int height, std::size_t stride);
+
+    /// Words holding one row of a grid of this width
+    static std::size_t wordsPerRow(int width) { return (static_cast<std::size_t>(width) + 63) / 64; }
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    std::size_t stride() const { return stride_; }
+
+    /// True if the mask owns its words, false for a view
+    bool ownsWords() const { return owns_words_; }
+
+    /// Packed words of row y
+    const uint64_t* row(int y) const { return words_ + y * stride_; }
+
+    bool isScar(int x, int y) const { return (row(y)[x >> 6] >> (x & 63)) & 1; }
+
+    /// Runs of excitable cells in row y, left to right
+    CellSpans liveSpans(int y) const { return spans(live_spans_, live_offsets_, y); }
+
+    /// Runs of scar cells in row y, left to right
+    CellSpans scarSpans(int y) const { return spans(scar_spans_, scar_offsets_, y); }
+
+    /// Number of scar cells in the grid
+    std::size_t getScarCellCount() const { return scar_cells_; }
+
+private:
+    ScarMask(int width, int height, std::size_t stride);
+
+    /// Extract the live and scar spans of every row from the words
+    void buildSpans();
+
+    static CellSpans spans(const std::vector<CellSpan>& all, const std::vector<int>& offsets, int y) {
+        return CellSpans(all.data() + offsets[y], all.data() + offsets[y + 1]);
+    }
+
+    int width_, height_;
+    std::size_t stride_;
+    std::vector<uint64_t> storage_;  ///< Owned words (empty for a view)
+    const uint64_t* words_;          ///< storage_.data() or the viewed words
+    bool owns_words_;
+    std::vector<CellSpan> live_spans_, scar_spans_;
+    std::vector<int> live_offsets_, scar_offsets_;  ///< Spans of row y: [offsets[y], offsets[y + 1])
+    std::size_t scar_cells_;
+};
+
+#endif // SCARMASK_H
@@ -0,0 +1,216 @@
+#ifndef SNAPSHOTWRITER_H
+#define SNAPSHOTWRITER_H
+
+/**
+ * @file SnapshotWriter.h
+ * @brief Background writer for time-series frames of simulation fields
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "AlignedGrid.h"
+#include "MappedFile.h"
+
+/**
+ * @brief Fields that can be recorded in a frame
+ */
+enum SnapshotField : unsigned int {
+    kSnapshotU = 1u,
+    kSnapshotV = 2u
+};
+
+/**
+ * @brief Appends frames of u and/or v to a binary file from a background thread
+ *
+ * push() copies the selected fields into a preallocated slot of a
+ * single-producer, single-consumer ring and returns; a writer thread drains
+ * the ring to disk, so the simulation thread never formats or writes. When
+ * the ring is full push() either waits for a free slot or drops the frame
+ * (see setDropWhenFull()).
+ *
+ * File layout: a 64-byte header (magic "MIFHNFRM", version, element type,
+ * width, height, field mask, frame size) followed by fixed-size frames of
+ * time (double), step (int64) and the selected fields, u before v, each
+ * width * height row-major values. Frames are only ever appended, and the
+ * fixed size lets SnapshotReader address frame i directly.
+ */
+class SnapshotWriter {
+public:
+    SnapshotWriter();
+
+    /**
+     * @brief Destructor - writes the queued frames and closes the file
+     */
+    ~SnapshotWriter();
+
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+    /**
+     * @brief Create the frame file and start the writer thread
+     * @param filename Output file (truncated)
+     * @param width Grid width
+     * @param height Grid height
+     * @param single_precision true for float fields, false for double
+     * @param fields Mask of SnapshotField values to record
+     * @param queue_frames Number of frames that can be in flight
+     * @return true if successful, false otherwise
+     */
+    bool open(const std::string& filename, int width, int height, bool single_precision = false,
+              unsigned int fields = kSnapshotU | kSnapshotV, int queue_frames = 8);
+
+    /**
+     * @brief Write all queued frames, stop the writer thread and close the file
+     * @return false if any write failed
+     */
+    bool close();
+
+    bool isOpen() const { return file_ != nullptr; }
+
+    /**
+     * @brief Drop frames instead of waiting when the queue is full
+     */
+    void setDropWhenFull(bool drop) { drop_when_full_ = drop; }
+
+    /**
+     * @brief Queue one frame
+     *
+     * Fields not selected at open() are ignored. Must be called from a single
+     * thread at a time.
+     * @param time Simulation time
+     * @param step Step number
+     * @param u u field
+     * @param v v field
+     * @return false if the writer is closed, failed, the grid or element type
+     *         does not match, or the frame was dropped
+     */
+    template <typename T>
+    bool push(double time, long long step, const AlignedGrid<T>& u, const AlignedGrid<T>& v);
+
+    /// Frames written to the file so far
+    long long getFramesWritten() const { return frames_written_.load(std::memory_order_acquire); }
+
+    /// Frames dropped because the queue was full
+    long long getFramesDropped() const { return frames_dropped_; }
+
+    /// Size in bytes of the file header
+    static constexpr std::size_t kHeaderBytes = 64;
+
+private:
+    struct Slot {
+        double time;
+        long long step;
+        std::vector<unsigned char> payload;
+    };
+
+    std::FILE* file_;
+    int width_, height_;
+    unsigned int fields_;
+    std::size_t element_size_;
+    std::size_t field_bytes_;
+
+    std::vector<Slot> slots_;
+    std::atomic<std::size_t> head_;  ///< Next slot to fill (producer)
+    std::atomic<std::size_t> tail_;  ///< Next slot to write (writer thread)
+    std::atomic<bool> stop_;
+    std::atomic<bool> failed_;
+    std::atomic<long long> frames_written_;
+    long long frames_dropped_;
+    bool drop_when_full_;
+    std::thread thread_;
+
+    /**
+     * @brief Get a free slot, waiting or giving up as configured
+     * @return Slot to fill, or null if the frame is dropped
+     */
+    Slot* acquireSlot();
+
+    /**
+     * @brief Hand the slot returned by acquireSlot() to the writer thread
+     */
+    void commitSlot();
+
+    void writerLoop();
+};
+
+/**
+ * @brief Random access to the frames of a SnapshotWriter file
+ */
+class SnapshotReader {
+public:
+    SnapshotReader();
+
+    /**
+     * @brief Map a frame file and validate its header
+     * @return true if successful, false otherwise
+     */
+    bool open(const std::string& filename);
+
+    int getWidth() const { return width_; }
+    int getHeight() const { return height_; }
+    bool isSinglePrecision() const { return element_size_ == sizeof(float); }
+    bool hasField(SnapshotField field) const { return (fields_ & field) != 0; }
+
+    /// Number of complete frames in the file
+    long long getFrameCount() const { return frame_count_; }
+
+    double getTime(long long frame) const;
+    long long getStep(long long frame) const;
+
+    /**
+     * @brief Copy one field of one frame
+     * @return Values indexed [y][x]; empty if the frame or field does not exist
+     */
+    std::vector<std::vector<double>> getField(long long frame, SnapshotField field) const;
+
+private:
+    MappedFile file_;
+    int width_, height_;
+    unsigned int fields_;
+    std::size_t element_size_;
+    std::size_t frame_bytes_;
+    long long frame_count_;
+
+    const unsigned char* frameData(long long frame) const;
+};
+
+template <typename T>
+bool SnapshotWriter::push(double time, long long step, const AlignedGrid<T>& u, const AlignedGrid<T>& v) {
+    static_assert(std::is_floating_point<T>::value, "Snapshots hold floating-point fields");
+    if (!file_ || failed_.load(std::memory_order_relaxed) || sizeof(T) != element_size_ ||
+        u.width() != width_ || u.height() != height_ || v.width() != width_ || v.height() != height_) {
+        return false;
+    }
+
+    Slot* slot = acquireSlot();
+    if (!slot) {
+        return false;
+    }
+    slot->time = time;
+    slot->step = step;
+
+    // Rows are copied without their padding
+    unsigned char* out = slot->payload.data();
+    const std::size_t row_bytes = static_cast<std::size_t>(width_) * sizeof(T);
+    for (const AlignedGrid<T>* grid : {&u, &v}) {
+        if (!(fields_ & (grid == &u ? kSnapshotU : kSnapshotV))) {
+            continue;
+        }
+        for (int y = 0; y < height_; ++y) {
+            std::memcpy(out, grid->row(y), row_bytes);
+            out += row_bytes;
+        }
+    }
+
+    commitSlot();
+    return true;
+}
+
+#endif // SNAPSHOTWRITER_H
@@ -0,0 +1,90 @@
+#ifndef SPARSEDIFFUSION_H
+#define SPARSEDIFFUSION_H
+
+/**
+ * @file SparseDiffusion.h
+ * @brief Diffusion operator over excitable cells only, stored as a CSR matrix
+ */
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Sparse diffusion operator out = A v + b in compressed sparse row form
+ *
+ * Rows and columns cover only the cells that take part in diffusion, so scar
+ * tissue costs neither storage nor work. assemble() renumbers the cells with
+ * reverse Cuthill-McKee, which keeps the columns of each row close to the
+ * row index: consecutive rows then read neighbouring parts of v. Vectors
+ * passed to apply() are in this renumbered order; getOrder() maps back.
+ *
+ * The diagonal is stored apart from the off-diagonal entries, and b (e.g.
+ * the contribution of cells held at a fixed potential) only when nonzero.
+ */
+class SparseDiffusion {
+public:
+    SparseDiffusion();
+
+    /**
+     * @brief Assemble the operator from rows in the caller's cell order
+     *
+     * Entries with equal row and column are summed into the diagonal.
+     * @param row_begin Start of each row in columns/values (size cells + 1)
+     * @param columns Column of each entry
+     * @param values Value of each entry
+     * @param constant Constant term b per cell, or empty for b = 0
+     * @return false if the arrays are inconsistent (operator unchanged)
+     */
+    bool assemble(const std::vector<int>& row_begin, const std::vector<int>& columns,
+                  const std::vector<double>& values, const std::vector<double>& constant);
+
+    /**
+     * @brief Compute out = A in + b for rows [row_begin, row_end)
+     *
+     * Rows are independent, so threads may apply disjoint row ranges at once.
+     * @param in Vector over all cells (renumbered order)
+     * @param out Receives rows [row_begin, row_end) (must not alias in)
+     * @param row_begin First row
+     * @param row_end One past the last row
+     */
+    void apply(const double* in, double* out, int row_begin, int row_end) const;
+
+    /// Number of rows (cells)
+    int size() const { return static_cast<int>(diagonal_.size()); }
+
+    /// Number of stored off-diagonal entries
+    std::size_t getOffDiagonalCount() const { return columns_.size(); }
+
+    /**
+     * @brief Largest |row - column| over the stored entries
+     */
+    int getBandwidth() const;
+
+    /**
+     * @brief Caller's index of each renumbered row
+     */
+    const std::vector<int>& getOrder() const { return order_; }
+
+    /**
+     * @brief Reverse Cuthill-McKee ordering of a symmetric sparsity pattern
+     *
+     * Each connected component is numbered breadth first from a
+     * pseudo-peripheral cell, visiting neighbours by increasing degree, and
+     * the whole sequence is reversed.
+     * @param row_begin Start of each row in columns (size cells + 1)
+     * @param columns Neighbours of each cell
+     * @return Old index of each new position
+     */
+    static std::vector<int> reverseCuthillMcKee(const std::vector<int>& row_begin,
+                                                const std::vector<int>& columns);
+
+private:
+    std::vector<int> row_begin_;    ///< Start of each row's off-diagonal entries
+    std::vector<int> columns_;
+    std::vector<double> values_;
+    std::vector<double> diagonal_;
+    std::vector<double> constant_;  ///< b (empty when zero)
+    std::vector<int> order_;
+};
+
+#endif // SPARSEDIFFUSION_H
@@ -0,0 +1,320 @@
+#ifndef STENCILKERNELS_H
+#define STENCILKERNELS_H
+
+/**
+ * @file StencilKernels.h
+ * @brief Vectorized 5-point stencil and reaction kernels with runtime ISA dispatch
+ */
+
+#include <array>
+
+/**
+ * @brief Instruction set levels with a dedicated kernel implementation
+ */
+enum class SimdLevel {
+    Scalar = 0,
+    SSE2 = 1,
+    AVX2 = 2,
+    AVX512 = 3
+};
+
+/**
+ * @brief Row pointers for one FitzHugh-Nagumo stencil update
+ *
+ * All pointers address column 0 of their row; kernels read x-1 and x+1.
+ */
+template <typename T>
+struct FHNRowPointers {
+    const T* u_up;     ///< u at row y-1
+    const T* u_row;    ///< u at row y
+    const T* u_down;   ///< u at row y+1
+    const T* v_up;     ///< v at row y-1
+    const T* v_row;    ///< v at row y
+    const T* v_down;   ///< v at row y+1
+    const T* stim;     ///< Stimulus at row y
+    T* u_out;          ///< Updated u at row y
+    T* v_out;          ///< Updated v at row y
+};
+
+/**
+ * @brief Row pointers for one 3D (7-point) FitzHugh-Nagumo stencil update
+ */
+struct FHNRowPointers3D {
+    FHNRowPointers<double> plane;  ///< Rows y-1, y, y+1 of plane z, stimulus and outputs
+    const double* u_front;         ///< u at row y of plane z-1
+    const double* u_back;          ///< u at row y of plane z+1
+    const double* v_front;         ///< v at row y of plane z-1
+    const double* v_back;          ///< v at row y of plane z+1
+};
+
+/**
+ * @brief Scalar coefficients of the FitzHugh-Nagumo update
+ */
+template <typename T>
+struct FHNCoefficients {
+    T dt;
+    T du, dv;
+    T a, b, c;
+};
+
+/**
+ * @brief Per-member coefficients of an interleaved FitzHugh-Nagumo ensemble
+ *
+ * Every array holds one value per member slot.
+ */
+struct FHNEnsembleCoefficients {
+    double dt;
+    const double* du;
+    const double* dv;
+    const double* a;
+    const double* b;
+    const double* inv_c;  ///< 1 / c
+};
+
+/**
+ * @brief Row pointers of a 9-point diffusion operator with precomputed weights
+ *
+ * out[x] = sum over the eight neighbours n of w(x, n) (V[n] - V[x]). Each
+ * weight couples two cells and is stored once, with the cell it couples to
+ * its east, south, south-east or north-east neighbour (y grows southwards),
+ * so the operator is symmetric and conserves charge.
+ */
+struct NinePointRowPointers {
+    const double* up;               ///< Potential of row y - 1
+    const double* row;              ///< Potential of row y
+    const double* down;             ///< Potential of row y + 1
+    const double* east;             ///< Row y: (x, y) to (x + 1, y)
+    const double* south_up;         ///< Row y - 1: (x, y - 1) to (x, y)
+    const double* south;            ///< Row y: (x, y) to (x, y + 1)
+    const double* south_east_up;    ///< Row y - 1: (x, y - 1) to (x + 1, y)
+    const double* south_east;       ///< Row y: (x, y) to (x + 1, y + 1)
+    const double* north_east;       ///< Row y: (x, y) to (x + 1, y - 1)
+    const double* north_east_down;  ///< Row y + 1: (x, y + 1) to (x + 1, y)
+    double* out;
+};
+
+/**
+ * @brief Row pointers of one Hodgkin-Huxley gate for a membrane update
+ */
+struct GateRowPointers {
+    const double* eval;    ///< Gate value the currents are evaluated at
+    const double* value;   ///< Gate value advanced by the step
+    const double* alpha;   ///< Opening rate
+    const double* beta;    ///< Closing rate
+    const double* step;    ///< Per-cell step factor (exponential integrators), or null for dt
+    double* out;           ///< Advanced gate value
+};
+
+/**
+ * @brief Per-cell conductance sources of a membrane update
+ *
+ * A cell's conductances are read from the coefficient table entry of its
+ * tissue class, then multiplied by the optional scale rows.
+ */
+template <int Count>
+struct TissueRowPointers {
+    const unsigned char* tissue_class;  ///< Tissue class per cell, or null for class 0 everywhere
+    const double* scale[Count];         ///< Per-cell factor of each conductance, or null where unscaled
+};
+
+/**
+ * @brief Conductances of one Luo-Rudy tissue class, indexed by LuoRudyModel::Current
+ *
+ * INa: GNa, ICaL: GCaL d f fca, IK: GK, IK1: GK1, Ib: Gb, ICaT: 0.0005 d.
+ */
+using LuoRudyConductances = std::array<double, 6>;
+
+/**
+ * @brief Row pointers for one Luo-Rudy membrane update
+ *
+ * Currents are evaluated at the V_eval / gate eval state; V, the gates and
+ * Cai then advance from their current values into the output rows. Every
+ * cell in the range is updated: callers skip scar cells by passing only the
+ * excitable spans of a row.
+ */
+struct LuoRudyRowPointers {
+    const double* V_eval;          ///< Potential the currents are evaluated at
+    const double* V;               ///< Potential advanced by the step
+    const double* diffusion;       ///< Diffusion term (sum of w (V[n] - V[x])), added to dV/dt
+    const double* k1_denominator;  ///< 1 + exp(0.07 (V_eval + 80))
+    const double* Cai;
+    double* V_out;
+    double* Cai_out;
+    GateRowPointers m, h, xr;
+    TissueRowPointers<std::tuple_size<LuoRudyConductances>::value> tissue;
+};
+
+/**
+ * @brief Scalar coefficients of the Luo-Rudy membrane update
+ */
+struct LuoRudyCoefficients {
+    double dt;
+    double j, xs;                       ///< Gates held at their resting values
+    const LuoRudyConductances* tissue;  ///< Conductances indexed by tissue class
+};
+
+/**
+ * @brief Conductances of one Ten Tusscher tissue class, indexed by TenTusscherModel::Current
+ *
+ * INa: GNa, ICaL: GCaL d f fca, IKr: GKr sqrt(Ki / 5.4), IKs: GKs v,
+ * IK1: GK1 sqrt(Ki / 5.4), Ito: Gto oa oi, INaCa: GNaCa, INaK: the
+ * (voltage-independent) pump current itself.
+ */
+using TenTusscherConductances = std::array<double, 8>;
+
+/**
+ * @brief Row pointers for one Ten Tusscher membrane update (see LuoRudyRowPointers)
+ */
+struct TenTusscherRowPointers {
+    const double* V_eval;
+    const double* V;
+    const double* diffusion;
+    const double* k1_denominator;  ///< 1 + exp(0.07 (V_eval + 80))
+    const double* naca_exp_plus;   ///< exp(0.03743 V_eval)
+    const double* naca_exp_minus;  ///< exp(-0.03743 V_eval)
+    const double* Cai_eval;        ///< Calcium the currents are evaluated at
+    const double* Cai;
+    double* V_out;
+    double* Cai_out;
+    GateRowPointers m, u;
+    TissueRowPointers<std::tuple_size<TenTusscherConductances>::value> tissue;
+};
+
+/**
+ * @brief Scalar coefficients of the Ten Tusscher membrane update
+ */
+struct TenTusscherCoefficients {
+    double dt;
+    double h, j, Nai;                       ///< Gates and sodium held at their resting values
+    const TenTusscherConductances* tissue;  ///< Conductances indexed by tissue class
+};
+
+/**
+ * @brief Stencil kernels selected once at startup from the CPU features
+ *
+ * The best level supported by the CPU (checked with CPUID) is used unless
+ * the MI_SIMD environment variable (scalar, sse2, avx2, avx512) or
+ * setSimdLevel() requests a lower one. On non-x86 targets only the scalar
+ * kernels are built.
+ */
+class StencilKernels {
+public:
+    /**
+     * @brief Fused 5-point diffusion, FHN reaction and Euler update for one row
+     *
+     * The result for a cell does not depend on where [x_begin, x_end) starts
+     * or ends, so a row may be updated in several pieces bit-identically.
+     * @param rows Row pointers
+     * @param x_begin First column to update (must be >= 1)
+     * @param x_end One past the last column to update (must be <= width - 1)
+     * @param coeff Model coefficients
+     */
+    static void fhnRow(const FHNRowPointers<double>& rows, int x_begin, int x_end,
+                       const FHNCoefficients<double>& coeff);
+    
+    /**
+     * @brief Single-precision variant of fhnRow (twice the lanes per register)
+     */
+    static void fhnRow(const FHNRowPointers<float>& rows, int x_begin, int x_end,
+                       const FHNCoefficients<float>& coeff);
+
+    /**
+     * @brief Fused 7-point diffusion, FHN reaction and Euler update for one row of a 3D grid
+     *
+     * Unlike fhnRow, the last (x_end - x_begin) % lanes cells use scalar
+     * arithmetic, so rows should always be updated whole.
+     * @param rows Row pointers
+     * @param x_begin First column to update (must be >= 1)
+     * @param x_end One past the last column to update (must be <= width - 1)
+     * @param coeff Model coefficients
+     */
+    static void fhnRow7(const FHNRowPointers3D& rows, int x_begin, int x_end,
+                        const FHNCoefficients<double>& coeff);
+
+    /// Member slot counts passed to fhnEnsembleRow() must be a multiple of this
+    static constexpr int kEnsembleBlock = 8;
+
+    /**
+     * @brief fhnRow for an ensemble stored member-fastest
+     *
+     * Member m of cell x lives at index x * members + m of every row, so one
+     * vector lane is one member and each lane uses its own coefficients.
+     * @param rows Row pointers (interleaved layout)
+     * @param x_begin First cell to update (must be >= 1)
+     * @param x_end One past the last cell to update (must be <= width - 1)
+     * @param members Member slots per cell (multiple of kEnsembleBlock)
+     * @param coeff Per-member coefficients
+     */
+    static void fhnEnsembleRow(const FHNRowPointers<double>& rows, int x_begin, int x_end, int members,
+                               const FHNEnsembleCoefficients& coeff);
+
+    /**
+     * @brief Scaled 5-point Laplacian of one row: out = coeff * lap(grid)
+     * @param up Row y-1
+     * @param row Row y
+     * @param down Row y+1
+     * @param coeff Scale factor (diffusion coefficient or conductivity)
+     * @param out Output row
+     * @param x_begin First column; column x_begin - 1 is read (e.g. from a halo)
+     * @param x_end One past the last column; column x_end is read
+     */
+    static void laplacianRow(const double* up, const double* row, const double* down,
+                             double coeff, double* out, int x_begin, int x_end);
+
+    /**
+     * @brief 9-point diffusion of one row with per-coupling weights (e.g. a fiber-oriented tensor)
+     *
+     * Like laplacianRow, a cell's result does not depend on where the range
+     * is split. With null diagonal weight rows only the east and south
+     * couplings are applied (5-point stencil with per-face weights).
+     * @param rows Potential, weight and output rows
+     * @param x_begin First column; column x_begin - 1 is read (e.g. from a halo)
+     * @param x_end One past the last column; column x_end is read
+     */
+    static void ninePointRow(const NinePointRowPointers& rows, int x_begin, int x_end);
+
+    /**
+     * @brief Luo-Rudy currents, potential, gate and calcium update for one row
+     *
+     * Lanes hold neighbouring cells. Each cell takes the same arithmetic path
+     * wherever the range starts, so a row may be updated span by span, but
+     * vector lanes agree with the scalar kernel only to rounding.
+     * Output rows may alias the rows they advance.
+     * @param rows Row pointers
+     * @param x_begin First cell to update
+     * @param x_end One past the last cell to update
+     * @param coeff Model coefficients
+     */
+    static void luoRudyRow(const LuoRudyRowPointers& rows, int x_begin, int x_end,
+                           const LuoRudyCoefficients& coeff);
+
+    /**
+     * @brief Ten Tusscher counterpart of luoRudyRow
+     */
+    static void tenTusscherRow(const TenTusscherRowPointers& rows, int x_begin, int x_end,
+                               const TenTusscherCoefficients& coeff);
+
+    /**
+     * @brief Get the best level supported by this CPU and build
+     */
+    static SimdLevel detectSimdLevel();
+
+    /**
+     * @brief Get the level of the active kernels
+     */
+    static SimdLevel getSimdLevel();
+
+    /**
+     * @brief Select the kernels for a level
+     * @param level Requested level
+     * @return false if the level is not supported (active kernels unchanged)
+     */
+    static bool setSimdLevel(SimdLevel level);
+
+    /**
+     * @brief Get printable name of a level
+     */
+    static const char* simdLevelName(SimdLevel level);
+};
+
+#endif // STENCILKERNELS_H
@@ -0,0 +1,116 @@
+#ifndef STIMULUSROWS_H
+#define STIMULUSROWS_H
+
+/**
+ * @file StimulusRows.h
+ * @brief Per-row stimulus pointers for the step kernels of a compiled StimulusSchedule
+ */
+
+#include <algorithm>
+#include <vector>
+#include "AlignedGrid.h"
+#include "StimulusSchedule.h"
+
+/**
+ * @brief Stimulus rows of the active pattern of a schedule
+ *
+ * build() turns every pattern into dense rows holding only the rows it
+ * stimulates; row(y) then points at the active pattern's row y, or at a
+ * shared zero row where y is not stimulated. Switching patterns rewrites
+ * only the pointers of the rows the two patterns touch, and kernels read
+ * the stimulus without a per-cell grid.
+ *
+ * A solver may cover a block of the grid the schedule was compiled for
+ * (e.g. one MPI rank's part); cells outside the block are dropped.
+ */
+template <typename T>
+class StimulusRows {
+public:
+    StimulusRows() : pattern_(0) {}
+
+    /**
+     * @brief Build the rows of every pattern of a compiled schedule
+     *
+     * Pattern 0 (no stimulus) becomes active.
+     * @param schedule Compiled schedule
+     * @param width Block width
+     * @param height Block height
+     * @param x_begin Schedule column of block column 0
+     * @param y_begin Schedule row of block row 0
+     */
+    void build(const StimulusSchedule& schedule, int width, int height, int x_begin = 0, int y_begin = 0) {
+        if (zero_row_.width() != width) {
+            zero_row_.resize(width, 1);
+        }
+        pattern_rows_.assign(schedule.patternCount(), std::vector<int>());
+        pattern_values_.clear();
+        for (int p = 0; p < schedule.patternCount(); ++p) {
+            const StimulusPattern& pattern = schedule.pattern(p);
+            std::vector<int>& rows = pattern_rows_[p];
+            for (std::size_t i = 0; i < pattern.rows.size(); ++i) {
+                const int y = pattern.rows[i] - y_begin;
+                const bool inside = y >= 0 && y < height &&
+                    std::any_of(pattern.cells.begin() + pattern.row_offsets[i],
+                                pattern.cells.begin() + pattern.row_offsets[i + 1],
+                                [&](const StimulusPattern::Cell& cell) {
+                                    return cell.x >= x_begin && cell.x < x_begin + width;
+                                });
+                if (inside) {
+                    rows.push_back(static_cast<int>(i));
+                }
+            }
+
+            AlignedGrid<T> values(width, static_cast<int>(rows.size()));
+            for (int r = 0; r < static_cast<int>(rows.size()); ++r) {
+                T* row = values.row(r);
+                const int i = rows[r];
+                for (int c = pattern.row_offsets[i]; c < pattern.row_offsets[i + 1]; ++c) {
+                    const int x = pattern.cells[c].x - x_begin;
+                    if (x >= 0 && x < width) {
+                        row[x] = static_cast<T>(pattern.cells[c].strength);
+                    }
+                }
+                rows[r] = pattern.rows[i] - y_begin;
+            }
+            pattern_values_.push_back(std::move(values));
+        }
+
+        rows_.assign(height, zero_row_.row(0));
+        pattern_ = 0;
+    }
+
+    /**
+     * @brief Make a pattern active
+     * @param pattern Pattern index of the schedule passed to build()
+     * @return true if the active pattern changed
+     */
+    bool select(int pattern) {
+        if (pattern == pattern_) {
+            return false;
+        }
+        for (int y : pattern_rows_[pattern_]) {
+            rows_[y] = zero_row_.row(0);
+        }
+        const std::vector<int>& rows = pattern_rows_[pattern];
+        for (int r = 0; r < static_cast<int>(rows.size()); ++r) {
+            rows_[rows[r]] = pattern_values_[pattern].row(r);
+        }
+        pattern_ = pattern;
+        return true;
+    }
+
+    /// Stimulus of block row y under the active pattern
+    const T* row(int y) const { return rows_[y]; }
+
+    /// Active pattern
+    int pattern() const { return pattern_; }
+
+private:
+    std::vector<std::vector<int>> pattern_rows_;  ///< Block rows stimulated by each pattern
+    std::vector<AlignedGrid<T>> pattern_values_;  ///< Those rows' values, in the same order
+    std::vector<const T*> rows_;                  ///< Stimulus row per block row
+    AlignedGrid<T> zero_row_;
+    int pattern_;
+};
+
+#endif // STIMULUSROWS_H
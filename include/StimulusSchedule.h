@@ -0,0 +1,151 @@
+#ifndef STIMULUSSCHEDULE_H
+#define STIMULUSSCHEDULE_H
+
+/**
+ * @file StimulusSchedule.h
+ * @brief Timed stimulus protocols compiled into sparse per-window cell lists
+ */
+
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Set of grid cells a stimulus is applied to
+ */
+class StimulusRegion {
+public:
+    StimulusRegion() = default;
+
+    /**
+     * @brief Single cell
+     */
+    static StimulusRegion point(int x, int y);
+
+    /**
+     * @brief Cells with x in [x_begin, x_end) and y in [y_begin, y_end)
+     */
+    static StimulusRegion rectangle(int x_begin, int y_begin, int x_end, int y_end);
+
+    /**
+     * @brief Cells where mask[y][x] is true
+     */
+    static StimulusRegion mask(const std::vector<std::vector<bool>>& mask);
+
+    /**
+     * @brief Get the (x, y) coordinates of the cells
+     */
+    const std::vector<std::pair<int, int>>& cells() const { return cells_; }
+
+private:
+    std::vector<std::pair<int, int>> cells_;
+};
+
+/**
+ * @brief Stimulus cells of one time window, sorted by row then column
+ *
+ * The cells of row rows[i] are cells[row_offsets[i]] .. cells[row_offsets[i + 1] - 1].
+ */
+struct StimulusPattern {
+    struct Cell {
+        int x;
+        double strength;
+    };
+
+    std::vector<int> rows;
+    std::vector<int> row_offsets;
+    std::vector<Cell> cells;
+};
+
+/**
+ * @brief Stimulus protocol: pulses with start, duration and optional period
+ *
+ * Pulses are kept as added; compile() splits the time axis at every pulse
+ * onset and offset and gives each window between two events the sparse list
+ * of cells stimulated during it (strengths of overlapping pulses add).
+ * Windows with the same set of active pulses share one pattern, so a pacing
+ * train of any length compiles to a handful of patterns. Pattern 0 is always
+ * the empty pattern. A pulse is on for start <= t < start + duration.
+ */
+class StimulusSchedule {
+public:
+    StimulusSchedule();
+
+    /**
+     * @brief Add a pulse train
+     * @param region Stimulated cells
+     * @param strength Stimulus current added to du/dt
+     * @param start Onset of the first pulse
+     * @param duration Length of each pulse
+     * @param period Onset-to-onset interval (ignored when count is 1)
+     * @param count Number of pulses
+     */
+    void addPulse(const StimulusRegion& region, double strength, double start, double duration,
+                  double period = 0.0, int count = 1);
+
+    /**
+     * @brief Add an S1-S2 protocol
+     *
+     * s1_count S1 pulses every s1_interval starting at start, followed by one
+     * S2 pulse s2_coupling after the last S1 onset.
+     * @param s1_region Cells of the pacing (S1) pulses
+     * @param s2_region Cells of the premature (S2) pulse
+     * @param strength Stimulus strength of every pulse
+     * @param duration Length of every pulse
+     * @param start Onset of the first S1 pulse
+     * @param s1_interval S1 basic cycle length
+     * @param s1_count Number of S1 pulses
+     * @param s2_coupling Interval from the last S1 onset to the S2 onset
+     */
+    void addS1S2(const StimulusRegion& s1_region, const StimulusRegion& s2_region, double strength,
+                 double duration, double start, double s1_interval, int s1_count, double s2_coupling);
+
+    /**
+     * @brief Remove all pulses
+     */
+    void clear();
+
+    bool empty() const { return pulses_.empty(); }
+
+    /**
+     * @brief Build the windows and patterns for a grid; cells outside it are dropped
+     * @param width Grid width
+     * @param height Grid height
+     */
+    void compile(int width, int height);
+
+    /**
+     * @brief Get the pattern active at time t (after compile())
+     * @return Pattern index
+     */
+    int patternAt(double t) const;
+
+    /**
+     * @brief Get the first window boundary after time t
+     * @return Boundary time, or infinity if the pattern never changes again
+     */
+    double nextChange(double t) const;
+
+    const StimulusPattern& pattern(int index) const { return patterns_[index]; }
+    int patternCount() const { return static_cast<int>(patterns_.size()); }
+
+private:
+    struct Pulse {
+        StimulusRegion region;
+        double strength;
+        double start;
+        double duration;
+        double period;
+        int count;
+    };
+
+    std::vector<Pulse> pulses_;
+
+    // Compiled form: pattern window_patterns_[i] is active for
+    // window_starts_[i] <= t < window_starts_[i + 1]; before the first
+    // start the empty pattern is active
+    std::vector<double> window_starts_;
+    std::vector<int> window_patterns_;
+    std::vector<StimulusPattern> patterns_;
+};
+
+#endif // STIMULUSSCHEDULE_H
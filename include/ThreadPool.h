@@ -0,0 +1,146 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+/**
+ * @file ThreadPool.h
+ * @brief Persistent worker pool with a reusable barrier for time-stepping loops
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Reusable barrier for a fixed number of threads
+ *
+ * Threads spin briefly and then yield while waiting, which keeps the
+ * per-step synchronization cost low for short simulation steps.
+ */
+class Barrier {
+public:
+    /**
+     * @brief Constructor
+     * @param count Number of threads that must arrive before release
+     */
+    explicit Barrier(int count);
+
+    /**
+     * @brief Block until all threads have arrived
+     */
+    void wait() {
+        wait([] {});
+    }
+
+    /**
+     * @brief Block until all threads have arrived
+     * @param completion Run by the last thread to arrive, before the others are released
+     */
+    template <typename Completion>
+    void wait(Completion&& completion) {
+        unsigned int generation = generation_.load(std::memory_order_acquire);
+        if (arrived_.fetch_add(1, std::memory_order_acq_rel) + 1 == count_) {
+            completion();
+            arrived_.store(0, std::memory_order_relaxed);
+            generation_.fetch_add(1, std::memory_order_release);
+            return;
+        }
+        for (int spins = 0; generation_.load(std::memory_order_acquire) == generation; ++spins) {
+            if (spins > kSpinLimit) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    static constexpr int kSpinLimit = 1024;
+
+    const int count_;
+    std::atomic<int> arrived_;
+    std::atomic<unsigned int> generation_;
+};
+
+/**
+ * @brief Fixed-size pool of persistent worker threads
+ *
+ * run() executes the same task on every thread of the pool (the calling
+ * thread takes part as thread 0) and returns when all have finished.
+ * Tasks that loop over many time steps call barrier() between steps, so
+ * threads are forked and joined once per run() instead of once per step.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Constructor
+     * @param num_threads Total number of threads including the caller;
+     *                    values <= 0 select the hardware concurrency
+     */
+    explicit ThreadPool(int num_threads);
+
+    /**
+     * @brief Destructor - stops and joins all workers
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Get number of threads taking part in run()
+     * @return Thread count including the caller
+     */
+    int size() const { return static_cast<int>(workers_.size()) + 1; }
+
+    /**
+     * @brief Execute a task on all threads and wait for completion
+     * @param task Callable receiving the thread index in [0, size())
+     */
+    void run(const std::function<void(int)>& task);
+
+    /**
+     * @brief Synchronize all threads inside a task passed to run()
+     */
+    void barrier() { barrier_.wait(); }
+
+    /**
+     * @brief Synchronize all threads inside a task passed to run()
+     * @param completion Run once by the last thread to arrive
+     */
+    template <typename Completion>
+    void barrier(Completion&& completion) {
+        barrier_.wait(std::forward<Completion>(completion));
+    }
+
+    /**
+     * @brief Split [begin, end) into size() contiguous, balanced chunks
+     * @param thread_index Index of the chunk
+     * @param begin Range start
+     * @param end Range end
+     * @return Pair of (chunk begin, chunk end)
+     */
+    std::pair<int, int> partition(int thread_index, int begin, int end) const;
+
+    /**
+     * @brief Get the number of hardware threads (at least 1)
+     */
+    static int hardwareConcurrency();
+
+private:
+    std::vector<std::thread> workers_;
+    Barrier barrier_;
+
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    const std::function<void(int)>* task_;
+    unsigned long job_generation_;
+    int pending_;
+    bool stop_;
+
+    void workerLoop(int thread_index);
+};
+
+#endif // THREADPOOL_H
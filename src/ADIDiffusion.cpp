@@ -0,0 +1,170 @@
+#include "ADIDiffusion.h"
+#include "ThreadPool.h"
+#include <algorithm>
+
+template <typename T>
+ADIDiffusion<T>::ADIDiffusion()
+    : width_(0), height_(0), coefficient_(-1.0) {
+}
+
+template <typename T>
+void ADIDiffusion<T>::configure(int width, int height, double coefficient) {
+    if (width == width_ && height == height_ && coefficient == coefficient_) {
+        return;
+    }
+    width_ = width;
+    height_ = height;
+    coefficient_ = coefficient;
+
+    factorize(width_ - 2, x_upper_, x_inv_pivot_);
+    factorize(height_ - 2, y_upper_, y_inv_pivot_);
+    half_.resize(width_, height_);
+}
+
+template <typename T>
+void ADIDiffusion<T>::factorize(int n, std::vector<T>& upper, std::vector<T>& inv_pivot) const {
+    // Constant tridiagonal system: sub = super = -r/2, diagonal = 1 + r
+    const double off = -0.5 * coefficient_;
+    const double diagonal = 1.0 + coefficient_;
+
+    upper.assign(std::max(n, 0), T(0));
+    inv_pivot.assign(std::max(n, 0), T(0));
+    double previous_upper = 0.0;
+    for (int i = 0; i < n; ++i) {
+        double pivot = diagonal - off * previous_upper;
+        previous_upper = off / pivot;
+        inv_pivot[i] = static_cast<T>(1.0 / pivot);
+        upper[i] = static_cast<T>(previous_upper);
+    }
+}
+
+template <typename T>
+void ADIDiffusion<T>::apply(const AlignedGrid<T>& in, AlignedGrid<T>& out, ThreadPool* pool) {
+    if (width_ < 3 || height_ < 3) {
+        // No interior cells: everything is boundary
+        for (int y = 0; y < height_; ++y) {
+            std::copy(in.row(y), in.row(y) + width_, out.row(y));
+        }
+        return;
+    }
+
+    // Boundary ring is held fixed
+    std::copy(in.row(0), in.row(0) + width_, out.row(0));
+    std::copy(in.row(height_ - 1), in.row(height_ - 1) + width_, out.row(height_ - 1));
+    for (int y = 1; y < height_ - 1; ++y) {
+        out(0, y) = in(0, y);
+        out(width_ - 1, y) = in(width_ - 1, y);
+    }
+
+    if (!pool) {
+        sweepRows(in, 0, height_);
+        sweepColumns(in, out, 1, width_ - 1);
+        return;
+    }
+
+    pool->run([&](int thread_index) {
+        auto rows = pool->partition(thread_index, 0, height_);
+        sweepRows(in, rows.first, rows.second);
+    });
+
+    // Column blocks start on alignment boundaries so threads never share a cache line
+    const int lanes = AlignedGrid<T>::kLanes;
+    const int num_blocks = (width_ + lanes - 1) / lanes;
+    pool->run([&](int thread_index) {
+        auto blocks = pool->partition(thread_index, 0, num_blocks);
+        int x_begin = std::max(1, blocks.first * lanes);
+        int x_end = std::min(width_ - 1, blocks.second * lanes);
+        if (x_begin < x_end) {
+            sweepColumns(in, out, x_begin, x_end);
+        }
+    });
+}
+
+template <typename T>
+void ADIDiffusion<T>::sweepRows(const AlignedGrid<T>& in, int y_begin, int y_end) {
+    const T half_r = static_cast<T>(0.5 * coefficient_);
+
+    // The elimination along a row is a serial recurrence, so rows are solved
+    // in groups with the recurrences interleaved to keep the FPU busy
+    const int kGroup = 8;
+    T* rows[kGroup];
+
+    for (int y_group = y_begin; y_group < y_end; y_group += kGroup) {
+        int count = 0;
+        for (int y = y_group; y < std::min(y_group + kGroup, y_end); ++y) {
+            const T* row = in.row(y);
+            T* result = half_.row(y);
+            if (y == 0 || y == height_ - 1) {
+                std::copy(row, row + width_, result);
+                continue;
+            }
+
+            // Right-hand side: explicit half step in y
+            const T* up = in.row(y - 1);
+            const T* down = in.row(y + 1);
+            for (int x = 1; x < width_ - 1; ++x) {
+                result[x] = row[x] + half_r * (up[x] - T(2) * row[x] + down[x]);
+            }
+            result[1] += half_r * row[0];
+            result[width_ - 2] += half_r * row[width_ - 1];
+            result[0] = row[0];
+            result[width_ - 1] = row[width_ - 1];
+            rows[count++] = result;
+        }
+
+        // Thomas elimination along the rows (unknowns x = 1 .. width - 2)
+        for (int k = 0; k < count; ++k) {
+            rows[k][1] *= x_inv_pivot_[0];
+        }
+        for (int x = 2; x < width_ - 1; ++x) {
+            const T inv_pivot = x_inv_pivot_[x - 1];
+            for (int k = 0; k < count; ++k) {
+                rows[k][x] = (rows[k][x] + half_r * rows[k][x - 1]) * inv_pivot;
+            }
+        }
+        for (int x = width_ - 3; x >= 1; --x) {
+            const T upper = x_upper_[x - 1];
+            for (int k = 0; k < count; ++k) {
+                rows[k][x] -= upper * rows[k][x + 1];
+            }
+        }
+    }
+}
+
+template <typename T>
+void ADIDiffusion<T>::sweepColumns(const AlignedGrid<T>& in, AlignedGrid<T>& out, int x_begin, int x_end) {
+    const T half_r = static_cast<T>(0.5 * coefficient_);
+
+    // Forward elimination down the columns, one row of the block at a time;
+    // the known boundary rows enter the first and last equations through
+    // the right-hand side
+    const T* top = in.row(0);
+    const T* bottom = in.row(height_ - 1);
+    for (int y = 1; y < height_ - 1; ++y) {
+        const T* row = half_.row(y);
+        const T* previous = out.row(y - 1);
+        T* result = out.row(y);
+        const T inv_pivot = y_inv_pivot_[y - 1];
+        const T carry = y == 1 ? T(0) : half_r;
+        const T top_weight = y == 1 ? half_r : T(0);
+        const T bottom_weight = y == height_ - 2 ? half_r : T(0);
+        for (int x = x_begin; x < x_end; ++x) {
+            T rhs = row[x] + half_r * (row[x - 1] - T(2) * row[x] + row[x + 1])
+                    + top_weight * top[x] + bottom_weight * bottom[x];
+            result[x] = (rhs + carry * previous[x]) * inv_pivot;
+        }
+    }
+
+    // Back substitution
+    for (int y = height_ - 3; y >= 1; --y) {
+        const T* next = out.row(y + 1);
+        T* result = out.row(y);
+        const T upper = y_upper_[y - 1];
+        for (int x = x_begin; x < x_end; ++x) {
+            result[x] -= upper * next[x];
+        }
+    }
+}
+
+template class ADIDiffusion<double>;
+template class ADIDiffusion<float>;
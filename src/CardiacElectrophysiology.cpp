@@ -1,17 +1,52 @@
 #include "CardiacElectrophysiology.h"
+#include "SparseDiffusion.h"
+#include "StencilKernels.h"
+#include "ThreadPool.h"
+#include <algorithm>
 #include <iostream>
 #include <cmath>
 #include <random>
 #include <map>
+#include <utility>
 
 // Base class implementation
 CardiacElectrophysiology::CardiacElectrophysiology(int width, int height, double dt)
-    : width_(width), height_(height), dt_(dt), time_(0.0), conductivity_(1.0) {
-    
-    mi_region_.resize(height_);
-    for (int i = 0; i < height_; ++i) {
-        mi_region_[i].resize(width_, false);
+    : width_(width), height_(height), dt_(dt), time_(0.0), conductivity_(1.0),
+      boundary_(BoundaryCondition::ZeroFlux), boundary_potential_(0.0), scar_(width, height),
+      longitudinal_conductivity_(0.0), transverse_conductivity_(0.0),
+      gate_integrator_(GateIntegrator::ForwardEuler),
+      V_next_(width, height), scratch_rows_(0) {
+    updateDiffusionWeights();
+}
+
+CardiacElectrophysiology::~CardiacElectrophysiology() = default;
+
+void CardiacElectrophysiology::step() {
+    beginStep();
+    stepCells(0, width_, 0, height_);
+    finishStep();
+}
+
+void CardiacElectrophysiology::beginStep() {
+    fillGhostCells(potential());
+    if (sparse_diffusion_) {
+        applySparseDiffusion(potential());
+    }
+}
+
+void CardiacElectrophysiology::stepCells(int x_begin, int x_end, int y_begin, int y_end) {
+    if (x_begin >= x_end || y_begin >= y_end) {
+        return;
     }
+    const CellSpan columns = {x_begin, x_end};
+    forEachBand(y_begin, y_end, [this, &columns](int thread_index, int band_begin, int band_end) {
+        updateRows(thread_index, band_begin, band_end, columns);
+    });
+}
+
+void CardiacElectrophysiology::finishStep() {
+    potential().swap(V_next_);
+    time_ += dt_;
 }
 
 void CardiacElectrophysiology::run(int steps) {
@@ -21,60 +56,490 @@ void CardiacElectrophysiology::run(int steps) {
 }
 
 void CardiacElectrophysiology::setMIRegion(const std::vector<std::vector<bool>>& mi_region) {
-    if (mi_region.size() != height_ || (height_ > 0 && mi_region[0].size() != width_)) {
+    bool size_matches = mi_region.size() == static_cast<std::size_t>(height_);
+    for (std::size_t y = 0; size_matches && y < mi_region.size(); ++y) {
+        size_matches = mi_region[y].size() == static_cast<std::size_t>(width_);
+    }
+    if (!size_matches) {
         std::cerr << "Error: MI region dimensions do not match grid size" << std::endl;
         return;
     }
-    mi_region_ = mi_region;
+    scar_ = ScarMask(mi_region);
+    updateDiffusionWeights();
+}
+
+bool CardiacElectrophysiology::setScarMask(ScarMask mask) {
+    if (mask.width() != width_ || mask.height() != height_) {
+        std::cerr << "Error: MI region dimensions do not match grid size" << std::endl;
+        return false;
+    }
+    scar_ = std::move(mask);
+    updateDiffusionWeights();
+    return true;
+}
+
+bool CardiacElectrophysiology::setFiberOrientation(const std::vector<std::vector<double>>& fiber_angle,
+                                                   double longitudinal, double transverse) {
+    if (fiber_angle.empty()) {
+        fiber_angle_.resize(0, 0, 0);
+        updateDiffusionWeights();
+        return true;
+    }
+    bool size_matches = fiber_angle.size() == static_cast<std::size_t>(height_);
+    for (std::size_t y = 0; size_matches && y < fiber_angle.size(); ++y) {
+        size_matches = fiber_angle[y].size() == static_cast<std::size_t>(width_);
+    }
+    if (!size_matches) {
+        std::cerr << "Error: Fiber field dimensions do not match grid size" << std::endl;
+        return false;
+    }
+    
+    fiber_angle_.resize(width_, height_, 0);
+    for (int y = 0; y < height_; ++y) {
+        std::copy(fiber_angle[y].begin(), fiber_angle[y].end(), fiber_angle_.row(y));
+    }
+    longitudinal_conductivity_ = longitudinal;
+    transverse_conductivity_ = transverse;
+    updateDiffusionWeights();
+    return true;
+}
+
+namespace {
+
+// Extend a field into its one-cell halo: wrapped around for periodic edges,
+// otherwise copied from the nearest edge cell
+void extendIntoHalo(AlignedGrid<double>& grid, bool periodic) {
+    const int width = grid.width();
+    const int height = grid.height();
+    for (int y = 0; y < height; ++y) {
+        double* row = grid.row(y);
+        row[-1] = row[periodic ? width - 1 : 0];
+        row[width] = row[periodic ? 0 : width - 1];
+    }
+    const double* top = grid.row(periodic ? height - 1 : 0);
+    const double* bottom = grid.row(periodic ? 0 : height - 1);
+    std::copy(top - 1, top + width + 1, grid.row(-1) - 1);
+    std::copy(bottom - 1, bottom + width + 1, grid.row(height) - 1);
+}
+
+} // namespace
+
+void CardiacElectrophysiology::setConductivity(double conductivity) {
+    conductivity_ = conductivity;
+    updateDiffusionWeights();
+}
+
+void CardiacElectrophysiology::setBoundaryCondition(BoundaryCondition condition, double fixed_potential) {
+    boundary_ = condition;
+    boundary_potential_ = fixed_potential;
+    updateDiffusionWeights();
 }
 
-void CardiacElectrophysiology::applyDiffusion(const std::vector<std::vector<double>>& grid,
-                                            std::vector<std::vector<double>>& result) {
-    // Apply 5-point stencil for 2D diffusion
-    for (int y = 1; y < height_ - 1; ++y) {
-        for (int x = 1; x < width_ - 1; ++x) {
-            // Skip diffusion in MI regions (scar tissue)
-            if (mi_region_[y][x]) {
-                result[y][x] = 0.0;
+void CardiacElectrophysiology::updateDiffusionWeights() {
+    const bool anisotropic = isAnisotropic();
+    
+    // Conductivity tensor of every cell and whether it conducts (zero in scar
+    // cells), extended into the ghost cells the way V is
+    AlignedGrid<double> sxx(width_, height_), syy(width_, height_), sxy(width_, height_), live(width_, height_);
+    const double anisotropy = longitudinal_conductivity_ - transverse_conductivity_;
+    for (int y = 0; y < height_; ++y) {
+        for (int x = 0; x < width_; ++x) {
+            if (scar_.isScar(x, y)) {
                 continue;
             }
-            
-            double laplacian = grid[y-1][x] + grid[y+1][x] + grid[y][x-1] + grid[y][x+1] - 4.0 * grid[y][x];
-            result[y][x] = conductivity_ * laplacian;
+            live(x, y) = 1.0;
+            if (anisotropic) {
+                const double c = std::cos(fiber_angle_(x, y));
+                const double s = std::sin(fiber_angle_(x, y));
+                sxx(x, y) = transverse_conductivity_ + anisotropy * c * c;
+                syy(x, y) = transverse_conductivity_ + anisotropy * s * s;
+                sxy(x, y) = anisotropy * c * s;
+            } else {
+                sxx(x, y) = syy(x, y) = conductivity_;
+            }
+        }
+    }
+    const bool periodic = boundary_ == BoundaryCondition::Periodic;
+    for (AlignedGrid<double>* field : {&sxx, &syy, &sxy, &live}) {
+        extendIntoHalo(*field, periodic);
+    }
+    
+    // A coupling conducts only between two conducting cells, and not across
+    // the grid edge under zero flux, so no current enters a scar or leaves the grid
+    const bool zero_flux = boundary_ == BoundaryCondition::ZeroFlux;
+    auto inside = [this](int x, int y) { return x >= 0 && x < width_ && y >= 0 && y < height_; };
+    auto connected = [&](int x0, int y0, int x1, int y1) {
+        if (zero_flux && !(inside(x0, y0) && inside(x1, y1))) {
+            return 0.0;
+        }
+        return live(x0, y0) * live(x1, y1);
+    };
+    
+    // Face conductivities are the mean of the two cells; the mixed derivative
+    // couples diagonal neighbours through the off-diagonal entries of the
+    // cells beside them. Weights reaching into the ghost cells are kept in
+    // the halo of the weight grids.
+    for (int w = 0; w < kDiffusionWeightCount; ++w) {
+        const bool used = anisotropic || w == EastWeight || w == SouthWeight;
+        diffusion_weights_[w].resize(used ? width_ : 0, used ? height_ : 0, 1, 0.0);
+    }
+    for (int y = -1; y <= height_; ++y) {
+        for (int x = -1; x < width_; ++x) {
+            if (y >= 0 && y < height_) {
+                diffusion_weights_[EastWeight](x, y) =
+                    0.5 * (sxx(x, y) + sxx(x + 1, y)) * connected(x, y, x + 1, y);
+            }
+            if (y < height_ && x >= 0) {
+                diffusion_weights_[SouthWeight](x, y) =
+                    0.5 * (syy(x, y) + syy(x, y + 1)) * connected(x, y, x, y + 1);
+            }
+            if (!anisotropic) {
+                continue;
+            }
+            if (y < height_) {
+                diffusion_weights_[SouthEastWeight](x, y) =
+                    0.25 * (sxy(x + 1, y) + sxy(x, y + 1)) * connected(x, y, x + 1, y + 1);
+            }
+            if (y >= 0) {
+                diffusion_weights_[NorthEastWeight](x, y) =
+                    -0.25 * (sxy(x + 1, y) + sxy(x, y - 1)) * connected(x, y, x + 1, y - 1);
+            }
+        }
+    }
+    
+    if (sparse_diffusion_) {
+        assembleSparseDiffusion();
+    }
+}
+
+void CardiacElectrophysiology::setSparseDiffusion(bool enabled) {
+    if (!enabled) {
+        sparse_diffusion_.reset();
+        sparse_cells_.clear();
+        sparse_in_.clear();
+        sparse_out_.clear();
+        sparse_result_.resize(0, 0, 0);
+        return;
+    }
+    if (!sparse_diffusion_) {
+        sparse_diffusion_.reset(new SparseDiffusion());
+        assembleSparseDiffusion();
+    }
+}
+
+void CardiacElectrophysiology::assembleSparseDiffusion() {
+    // Number the excitable cells row by row
+    std::vector<int> index(static_cast<std::size_t>(width_) * height_, -1);
+    std::vector<std::ptrdiff_t> cells;
+    for (int y = 0; y < height_; ++y) {
+        for (const CellSpan& span : scar_.liveSpans(y)) {
+            for (int x = span.begin; x < span.end; ++x) {
+                index[static_cast<std::size_t>(y) * width_ + x] = static_cast<int>(cells.size());
+                cells.push_back(y * V_next_.stride() + x);
+            }
+        }
+    }
+    
+    // The stencil's couplings of a cell as (neighbour offset, weight grid and
+    // the weight's position relative to the cell); the diagonal couplings
+    // only when anisotropic
+    struct Coupling {
+        int dx, dy, weight, wx, wy;
+    };
+    static const Coupling kCouplings[] = {
+        {1, 0, EastWeight, 0, 0},        {-1, 0, EastWeight, -1, 0},
+        {0, 1, SouthWeight, 0, 0},       {0, -1, SouthWeight, 0, -1},
+        {1, 1, SouthEastWeight, 0, 0},   {-1, -1, SouthEastWeight, -1, -1},
+        {1, -1, NorthEastWeight, 0, 0},  {-1, 1, NorthEastWeight, -1, 1}};
+    const int coupling_count = isAnisotropic() ? 8 : 4;
+    
+    // Row i: the diagonal, then every neighbour with a nonzero coupling.
+    // Couplings into a ghost cell wrap around (periodic) or move the fixed
+    // ghost potential into the constant term; zero-flux edges have none.
+    std::vector<int> row_begin(1, 0), columns;
+    std::vector<double> values, constant;
+    if (boundary_ == BoundaryCondition::Fixed) {
+        constant.assign(cells.size(), 0.0);
+    }
+    for (int y = 0; y < height_; ++y) {
+        for (const CellSpan& span : scar_.liveSpans(y)) {
+            for (int x = span.begin; x < span.end; ++x) {
+                const int row = index[static_cast<std::size_t>(y) * width_ + x];
+                const std::size_t diagonal = values.size();
+                columns.push_back(row);
+                values.push_back(0.0);
+                for (int c = 0; c < coupling_count; ++c) {
+                    const Coupling& coupling = kCouplings[c];
+                    const double w = diffusion_weights_[coupling.weight](x + coupling.wx, y + coupling.wy);
+                    if (w == 0.0) {
+                        continue;
+                    }
+                    values[diagonal] -= w;
+                    int nx = x + coupling.dx;
+                    int ny = y + coupling.dy;
+                    if (nx < 0 || nx >= width_ || ny < 0 || ny >= height_) {
+                        if (boundary_ != BoundaryCondition::Periodic) {
+                            constant[row] += w * boundary_potential_;
+                            continue;
+                        }
+                        nx = (nx + width_) % width_;
+                        ny = (ny + height_) % height_;
+                    }
+                    columns.push_back(index[static_cast<std::size_t>(ny) * width_ + nx]);
+                    values.push_back(w);
+                }
+                row_begin.push_back(static_cast<int>(columns.size()));
+            }
+        }
+    }
+    sparse_diffusion_->assemble(row_begin, columns, values, constant);
+    
+    // Cell of each renumbered row
+    const std::vector<int>& order = sparse_diffusion_->getOrder();
+    sparse_cells_.resize(order.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        sparse_cells_[i] = cells[order[i]];
+    }
+    sparse_in_.assign(cells.size(), 0.0);
+    sparse_out_.assign(cells.size(), 0.0);
+    sparse_result_.resize(width_, height_, 1, 0.0);
+}
+
+void CardiacElectrophysiology::applySparseDiffusion(const AlignedGrid<double>& V) {
+    const int cells = sparse_diffusion_->size();
+    const double* V_origin = V.row(0);
+    double* result = sparse_result_.row(0);
+    auto gather = [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            sparse_in_[i] = V_origin[sparse_cells_[i]];
+        }
+    };
+    auto multiply = [&](int begin, int end) {
+        sparse_diffusion_->apply(sparse_in_.data(), sparse_out_.data(), begin, end);
+        for (int i = begin; i < end; ++i) {
+            result[sparse_cells_[i]] = sparse_out_[i];
+        }
+    };
+    
+    if (!pool_) {
+        gather(0, cells);
+        multiply(0, cells);
+        return;
+    }
+    // Rows read V of any cell, so all of it is gathered before multiplying
+    pool_->run([&](int thread_index) {
+        auto rows = pool_->partition(thread_index, 0, cells);
+        gather(rows.first, rows.second);
+        pool_->barrier();
+        multiply(rows.first, rows.second);
+    });
+}
+
+void CardiacElectrophysiology::fillGhostCells(AlignedGrid<double>& V) const {
+    if (boundary_ != BoundaryCondition::Fixed) {
+        // Copies of the edge cells carry no current across the edge
+        extendIntoHalo(V, boundary_ == BoundaryCondition::Periodic);
+        return;
+    }
+    for (int y = 0; y < height_; ++y) {
+        V.row(y)[-1] = V.row(y)[width_] = boundary_potential_;
+    }
+    std::fill(V.row(-1) - 1, V.row(-1) + width_ + 1, boundary_potential_);
+    std::fill(V.row(height_) - 1, V.row(height_) + width_ + 1, boundary_potential_);
+}
+
+bool CardiacElectrophysiology::setTissueClasses(const std::vector<std::vector<uint8_t>>& classes) {
+    if (classes.empty()) {
+        tissue_class_.resize(0, 0, 0);
+        return true;
+    }
+    if (classes.size() != static_cast<std::size_t>(height_)) {
+        std::cerr << "Error: Tissue class dimensions do not match grid size" << std::endl;
+        return false;
+    }
+    const int class_count = getTissueClassCount();
+    for (const auto& row : classes) {
+        if (row.size() != static_cast<std::size_t>(width_)) {
+            std::cerr << "Error: Tissue class dimensions do not match grid size" << std::endl;
+            return false;
+        }
+        for (uint8_t tissue_class : row) {
+            if (tissue_class >= class_count) {
+                std::cerr << "Error: Tissue class " << static_cast<int>(tissue_class) << " is not defined"
+                          << std::endl;
+                return false;
+            }
+        }
+    }
+    
+    tissue_class_.resize(width_, height_, 0);
+    for (int y = 0; y < height_; ++y) {
+        std::copy(classes[y].begin(), classes[y].end(), tissue_class_.row(y));
+    }
+    return true;
+}
+
+bool CardiacElectrophysiology::setConductanceScale(int current, const std::vector<std::vector<double>>& scale) {
+    if (current < 0 || current >= static_cast<int>(conductance_scale_.size())) {
+        std::cerr << "Error: Unknown current " << current << std::endl;
+        return false;
+    }
+    if (scale.empty()) {
+        conductance_scale_[current].resize(0, 0, 0);
+        return true;
+    }
+    bool size_matches = scale.size() == static_cast<std::size_t>(height_);
+    for (std::size_t y = 0; size_matches && y < scale.size(); ++y) {
+        size_matches = scale[y].size() == static_cast<std::size_t>(width_);
+    }
+    if (!size_matches) {
+        std::cerr << "Error: Conductance scale dimensions do not match grid size" << std::endl;
+        return false;
+    }
+    
+    conductance_scale_[current].resize(width_, height_, 0);
+    for (int y = 0; y < height_; ++y) {
+        std::copy(scale[y].begin(), scale[y].end(), conductance_scale_[current].row(y));
+    }
+    return true;
+}
+
+void CardiacElectrophysiology::setNumThreads(int num_threads) {
+    if (num_threads <= 0) {
+        num_threads = ThreadPool::hardwareConcurrency();
+    }
+    // Every band needs at least one row
+    num_threads = std::max(1, std::min(num_threads, height_));
+    
+    if (num_threads == getNumThreads()) {
+        return;
+    }
+    pool_.reset(num_threads > 1 ? new ThreadPool(num_threads) : nullptr);
+    allocateScratch(scratch_rows_);
+}
+
+int CardiacElectrophysiology::getNumThreads() const {
+    return pool_ ? pool_->size() : 1;
+}
+
+void CardiacElectrophysiology::allocateScratch(int rows_per_thread) {
+    scratch_rows_ = rows_per_thread;
+    scratch_.resize(width_, scratch_rows_ * getNumThreads(), 0);
+}
+
+void CardiacElectrophysiology::forEachBand(int y_begin, int y_end,
+                                           const std::function<void(int, int, int)>& task) {
+    if (!pool_) {
+        task(0, y_begin, y_end);
+        return;
+    }
+    pool_->run([this, y_begin, y_end, &task](int thread_index) {
+        auto band = pool_->partition(thread_index, y_begin, y_end);
+        task(thread_index, band.first, band.second);
+    });
+}
+
+bool CardiacElectrophysiology::setRateTableResolution(double resolution) {
+    if (resolution == 0.0) {
+        rate_table_.reset();
+        return true;
+    }
+    std::shared_ptr<const RateTable> table = makeRateTable(resolution);
+    if (!table) {
+        return false;
+    }
+    rate_table_ = table;
+    return true;
+}
+
+CardiacElectrophysiology::GateRate CardiacElectrophysiology::sodiumActivation(double V) {
+    // alpha_m has a removable singularity at -47.13 mV, which a table may sample
+    double alpha = std::abs(V + 47.13) < 1e-6 ? 3.2 : 0.32 * (V + 47.13) / (1 - exp(-0.1 * (V + 47.13)));
+    return {alpha, 0.08 * exp(-V / 11.0)};
+}
+
+CardiacElectrophysiology::GateRate CardiacElectrophysiology::sodiumInactivation(double V) {
+    return {0.135 * exp(-(V + 80) / 6.8), 3.56 * exp(0.079 * V) + 3.1e6 * exp(0.35 * V)};
+}
+
+CardiacElectrophysiology::GateRate CardiacElectrophysiology::potassiumActivation(double V) {
+    return {0.0005 * exp(0.083 * (V + 50)) / (1 + exp(0.057 * (V + 50))),
+            0.0013 * exp(-0.06 * (V + 20)) / (1 + exp(-0.04 * (V + 20)))};
+}
+
+void CardiacElectrophysiology::gateStepRow(const double* alpha, const double* beta, double dt,
+                                           double* step, int x_begin, int x_end) const {
+    for (int x = x_begin; x < x_end; ++x) {
+        const double k = alpha[x] + beta[x];
+        step[x] = k > 0.0 ? -std::expm1(-dt * k) / k : dt;
+    }
+}
+
+const double* CardiacElectrophysiology::diffusionRow(const AlignedGrid<double>& V, int y, const CellSpan& columns,
+                                                     double* out) const {
+    if (sparse_diffusion_) {
+        return sparse_result_.row(y);
+    }
+    
+    const auto& w = diffusion_weights_;
+    NinePointRowPointers rows = {V.row(y - 1), V.row(y), V.row(y + 1), w[EastWeight].row(y),
+                                 w[SouthWeight].row(y - 1), w[SouthWeight].row(y),
+                                 nullptr, nullptr, nullptr, nullptr, out};
+    if (isAnisotropic()) {
+        rows.south_east_up = w[SouthEastWeight].row(y - 1);
+        rows.south_east = w[SouthEastWeight].row(y);
+        rows.north_east = w[NorthEastWeight].row(y);
+        rows.north_east_down = w[NorthEastWeight].row(y + 1);
+    }
+    
+    // Only excitable spans are visited, so MI regions (scar tissue) are skipped;
+    // edge cells read the ghost cells filled for the boundary condition
+    for (const CellSpan& live : scar_.liveSpans(y)) {
+        const CellSpan span = live.clip(columns);
+        if (span.begin < span.end) {
+            StencilKernels::ninePointRow(rows, span.begin, span.end);
+        }
+    }
+    return out;
+}
+
+namespace {
+
+// Rates of a model for a row of potentials, transposed to one row per rate
+template <int Count, void (*Exact)(double, double*)>
+void rateRow(const RateTable* table, const double* V, int x_begin, int x_end, double* const* rates) {
+    if (table) {
+        double* span_rates[Count];
+        for (int r = 0; r < Count; ++r) {
+            span_rates[r] = rates[r] + x_begin;
+        }
+        table->lookup(V + x_begin, x_end - x_begin, span_rates);
+        return;
+    }
+    for (int x = x_begin; x < x_end; ++x) {
+        double values[Count];
+        Exact(V[x], values);
+        for (int r = 0; r < Count; ++r) {
+            rates[r][x] = values[r];
         }
     }
 }
 
+} // namespace
+
 // Luo-Rudy Model Implementation
+const std::array<const char*, LuoRudyModel::kCurrentCount> LuoRudyModel::kCurrentNames = {
+    "INa", "ICaL", "IK", "IK1", "Ib", "ICaT"
+};
+
 LuoRudyModel::LuoRudyModel(int width, int height, double dt)
-    : CardiacElectrophysiology(width, height, dt) {
-    
-    // Initialize state variables
-    V_.resize(height_);
-    m_.resize(height_);
-    h_.resize(height_);
-    j_.resize(height_);
-    xr_.resize(height_);
-    xs_.resize(height_);
-    d_.resize(height_);
-    f_.resize(height_);
-    fca_.resize(height_);
-    Cai_.resize(height_);
-    CaSR_.resize(height_);
-    
-    for (int i = 0; i < height_; ++i) {
-        V_[i].resize(width_, -84.0);  // Resting potential
-        m_[i].resize(width_, 0.0);
-        h_[i].resize(width_, 1.0);
-        j_[i].resize(width_, 1.0);
-        xr_[i].resize(width_, 0.0);
-        xs_[i].resize(width_, 0.0);
-        d_[i].resize(width_, 0.0);
-        f_[i].resize(width_, 1.0);
-        fca_[i].resize(width_, 1.0);
-        Cai_[i].resize(width_, 0.0002);
-        CaSR_[i].resize(width_, 0.2);
-    }
+    : CardiacElectrophysiology(width, height, dt),
+      // Resting potential and gates
+      state_(width, height, {-84.0, 0.0, 1.0, 0.0, 0.0002}),
+      j_(1.0), xs_(0.0), d_(0.0), f_(1.0), fca_(1.0), tissue_classes_(1) {
+    
+    allocateScratch(kScratchRowCount);
+    conductance_scale_.resize(kCurrentCount);
     
     // Set default parameters for normal tissue
     setCellType("normal");
@@ -84,131 +549,204 @@ LuoRudyModel::~LuoRudyModel() {
     // Destructor - vectors will automatically clean up
 }
 
-void LuoRudyModel::step() {
-    std::vector<std::vector<double>> V_new(height_, std::vector<double>(width_, 0.0));
-    std::vector<std::vector<double>> dV_dt(height_, std::vector<double>(width_, 0.0));
-    
-    // Apply diffusion
-    applyDiffusion(V_, dV_dt);
+void LuoRudyModel::updateRows(int thread_index, int y_begin, int y_end, const CellSpan& columns) {
+    const AlignedGrid<double>& V = state_[State::V];
+    double* diffusion_row = scratchRow(thread_index, DiffusionRow);
+    double* V_half = scratchRow(thread_index, VHalfRow);
+    double* m_half = scratchRow(thread_index, MHalfRow);
+    double* h_half = scratchRow(thread_index, HHalfRow);
+    double* xr_half = scratchRow(thread_index, XrHalfRow);
+    double* Cai_half = scratchRow(thread_index, CaiHalfRow);
+    double* m_step = scratchRow(thread_index, MStepRow);
+    double* h_step = scratchRow(thread_index, HStepRow);
+    double* xr_step = scratchRow(thread_index, XrStepRow);
+    double* rates[kRateCount];
+    for (int r = 0; r < kRateCount; ++r) {
+        rates[r] = scratchRow(thread_index, FirstRateRow + r);
+    }
     
-    // Add reaction terms and update state variables
-    for (int y = 0; y < height_; ++y) {
-        for (int x = 0; x < width_; ++x) {
-            if (mi_region_[y][x]) {
-                // Scar tissue - no electrical activity
-                V_new[y][x] = V_[y][x];
+    // Forward Euler leaves the step rows null, so the kernel uses dt
+    const bool exponential = gate_integrator_ != GateIntegrator::ForwardEuler;
+    const LuoRudyCoefficients coeff = {dt_, j_, xs_, tissue_classes_.data()};
+    LuoRudyCoefficients half_coeff = coeff;
+    half_coeff.dt = 0.5 * dt_;
+    
+    for (int y = y_begin; y < y_end; ++y) {
+        const double* V_row = V.row(y);
+        double* m = state_[State::m].row(y);
+        double* h = state_[State::h].row(y);
+        double* xr = state_[State::xr].row(y);
+        double* Cai = state_[State::Cai].row(y);
+        
+        const double* diffusion = diffusionRow(V, y, columns, diffusion_row);
+        
+        // Currents are evaluated at the current state; V advances into
+        // V_next_, the gates and Cai in place
+        LuoRudyRowPointers row_pointers = {
+            V_row, V_row, diffusion, rates[K1Denominator], Cai, V_next_.row(y), Cai,
+            {m, m, rates[AlphaM], rates[BetaM], exponential ? m_step : nullptr, m},
+            {h, h, rates[AlphaH], rates[BetaH], exponential ? h_step : nullptr, h},
+            {xr, xr, rates[AlphaXr], rates[BetaXr], exponential ? xr_step : nullptr, xr}, {}};
+        tissueRow(y, row_pointers.tissue);
+        
+        // Only excitable spans are updated; scar cells keep their state
+        for (const CellSpan& live : scar_.liveSpans(y)) {
+            const CellSpan span = live.clip(columns);
+            const int x_begin = span.begin;
+            const int x_end = span.end;
+            if (x_begin >= x_end) {
                 continue;
             }
+            LuoRudyRowPointers rows = row_pointers;
+            evaluateRateRow(V_row, rates, x_begin, x_end);
             
-            auto currents = calculateIonicCurrents(x, y);
-            
-            // Total ionic current
-            double I_total = currents["INa"] + currents["ICaL"] + currents["IK"] + 
-                           currents["IK1"] + currents["Ib"] + currents["ICaT"];
-            
-            // Update membrane potential: dV/dt = -(I_ion + I_diff)/C_m
-            double dV = -(I_total + dV_dt[y][x]) * dt_;
-            V_new[y][x] = V_[y][x] + dV;
-            
-            // Update gating variables (simplified)
-            double V_val = V_[y][x];
-            
-            // Sodium gates
-            double alpha_m = 0.32 * (V_val + 47.13) / (1 - exp(-0.1 * (V_val + 47.13)));
-            double beta_m = 0.08 * exp(-V_val / 11.0);
-            m_[y][x] += dt_ * (alpha_m * (1 - m_[y][x]) - beta_m * m_[y][x]);
-            
-            double alpha_h = 0.135 * exp(-(V_val + 80) / 6.8);
-            double beta_h = 3.56 * exp(0.079 * V_val) + 3.1e6 * exp(0.35 * V_val);
-            h_[y][x] += dt_ * (alpha_h * (1 - h_[y][x]) - beta_h * h_[y][x]);
-            
-            // Potassium gates (simplified)
-            double alpha_xr = 0.0005 * exp(0.083 * (V_val + 50)) / (1 + exp(0.057 * (V_val + 50)));
-            double beta_xr = 0.0013 * exp(-0.06 * (V_val + 20)) / (1 + exp(-0.04 * (V_val + 20)));
-            xr_[y][x] += dt_ * (alpha_xr * (1 - xr_[y][x]) - beta_xr * xr_[y][x]);
-            
-            // Calcium handling (simplified)
-            Cai_[y][x] += dt_ * 0.001 * (-currents["ICaL"] - 0.0001 * Cai_[y][x]);
-            Cai_[y][x] = std::max(0.0001, std::min(0.01, Cai_[y][x]));
+            if (gate_integrator_ == GateIntegrator::GeneralizedRushLarsen2) {
+                // Midpoint state half a step on, whose currents and rates drive the full step
+                gateStepRow(rates[AlphaM], rates[BetaM], half_coeff.dt, m_step, x_begin, x_end);
+                gateStepRow(rates[AlphaH], rates[BetaH], half_coeff.dt, h_step, x_begin, x_end);
+                gateStepRow(rates[AlphaXr], rates[BetaXr], half_coeff.dt, xr_step, x_begin, x_end);
+                LuoRudyRowPointers half = rows;
+                half.V_out = V_half;
+                half.Cai_out = Cai_half;
+                half.m.out = m_half;
+                half.h.out = h_half;
+                half.xr.out = xr_half;
+                StencilKernels::luoRudyRow(half, x_begin, x_end, half_coeff);
+                
+                evaluateRateRow(V_half, rates, x_begin, x_end);
+                rows.V_eval = V_half;
+                rows.m.eval = m_half;
+                rows.h.eval = h_half;
+                rows.xr.eval = xr_half;
+            }
+            if (exponential) {
+                gateStepRow(rates[AlphaM], rates[BetaM], dt_, m_step, x_begin, x_end);
+                gateStepRow(rates[AlphaH], rates[BetaH], dt_, h_step, x_begin, x_end);
+                gateStepRow(rates[AlphaXr], rates[BetaXr], dt_, xr_step, x_begin, x_end);
+            }
+            StencilKernels::luoRudyRow(rows, x_begin, x_end, coeff);
         }
+        copyScarCells(V_row, V_next_.row(y), y, columns);
     }
-    
-    V_ = V_new;
-    time_ += dt_;
+}
+
+void LuoRudyModel::evaluateRateRow(const double* V, double* const* rates, int x_begin, int x_end) const {
+    rateRow<kRateCount, exactRates>(rate_table_.get(), V, x_begin, x_end, rates);
 }
 
 void LuoRudyModel::setCellType(const std::string& cell_type) {
+    cellTypeConductances(cell_type, tissue_classes_[0]);
+}
+
+int LuoRudyModel::addTissueClass(const std::string& cell_type) {
+    LuoRudyConductances conductances;
+    if (getTissueClassCount() >= kMaxTissueClasses || !cellTypeConductances(cell_type, conductances)) {
+        std::cerr << "Error: Cannot add tissue class " << cell_type << std::endl;
+        return -1;
+    }
+    tissue_classes_.push_back(conductances);
+    return getTissueClassCount() - 1;
+}
+
+bool LuoRudyModel::cellTypeConductances(const std::string& cell_type, LuoRudyConductances& conductances) const {
+    double GNa, GK, GK1, Gb, GCaL;
     if (cell_type == "normal") {
-        GNa_ = 23.0;   // mS/μF
-        Gsi_ = 0.09;   // mS/μF
-        GK_ = 0.282;   // mS/μF
-        GK1_ = 0.6047; // mS/μF
-        Gb_ = 0.03921; // mS/μF
-        GCaL_ = 0.000175; // mS/μF
+        GNa = 23.0;   // mS/μF
+        GK = 0.282;   // mS/μF
+        GK1 = 0.6047; // mS/μF
+        Gb = 0.03921; // mS/μF
+        GCaL = 0.000175; // mS/μF
     } else if (cell_type == "ischemic") {
         // Reduced conductances in ischemic tissue
-        GNa_ = 15.0;
-        Gsi_ = 0.06;
-        GK_ = 0.2;
-        GK1_ = 0.4;
-        Gb_ = 0.03;
-        GCaL_ = 0.00012;
+        GNa = 15.0;
+        GK = 0.2;
+        GK1 = 0.4;
+        Gb = 0.03;
+        GCaL = 0.00012;
     } else if (cell_type == "infarcted") {
         // Severely reduced conductances in infarcted tissue
-        GNa_ = 2.0;
-        Gsi_ = 0.01;
-        GK_ = 0.05;
-        GK1_ = 0.1;
-        Gb_ = 0.01;
-        GCaL_ = 0.00002;
+        GNa = 2.0;
+        GK = 0.05;
+        GK1 = 0.1;
+        Gb = 0.01;
+        GCaL = 0.00002;
+    } else {
+        return false;
     }
+    
+    conductances[INa] = GNa;
+    conductances[ICaL] = GCaL * d_ * f_ * fca_;
+    conductances[IK] = GK;
+    conductances[IK1] = GK1;
+    conductances[Ib] = Gb;
+    conductances[ICaT] = 0.0005 * d_;
+    return true;
 }
 
-std::map<std::string, double> LuoRudyModel::calculateIonicCurrents(int x, int y) {
-    double V = V_[y][x];
-    double Cai = Cai_[y][x];
-    
-    std::map<std::string, double> currents;
+void LuoRudyModel::exactRates(double V, double* rates) {
+    GateRate m = sodiumActivation(V);
+    GateRate h = sodiumInactivation(V);
+    GateRate xr = potassiumActivation(V);
+    rates[AlphaM] = m.alpha;
+    rates[BetaM] = m.beta;
+    rates[AlphaH] = h.alpha;
+    rates[BetaH] = h.beta;
+    rates[AlphaXr] = xr.alpha;
+    rates[BetaXr] = xr.beta;
+    rates[K1Denominator] = 1 + exp(0.07 * (V + 80));
+}
+
+std::shared_ptr<const RateTable> LuoRudyModel::makeRateTable(double resolution) const {
+    return RateTable::shared("LuoRudyModel", kRateTableMinVoltage, kRateTableMaxVoltage, resolution, kRateCount,
+                             exactRates);
+}
+
+LuoRudyModel::Currents LuoRudyModel::calculateIonicCurrents(double V, double m, double h, double xr,
+                                                            const Rates& rates,
+                                                            const LuoRudyConductances& conductances) const {
+    Currents currents;
     
     // Fast sodium current: INa = GNa * m^3 * h * j * (V - ENa)
     double ENa = 54.4; // mV
-    currents["INa"] = GNa_ * m_[y][x] * m_[y][x] * m_[y][x] * h_[y][x] * j_[y][x] * (V - ENa);
+    currents[INa] = conductances[INa] * m * m * m * h * j_ * (V - ENa);
     
     // L-type calcium current: ICaL = GCaL * d * f * fca * (V - ECa)
     double ECa = 130.0; // mV
-    currents["ICaL"] = GCaL_ * d_[y][x] * f_[y][x] * fca_[y][x] * (V - ECa);
+    currents[ICaL] = conductances[ICaL] * (V - ECa);
     
     // Delayed rectifier potassium: IK = GK * xr * xs * (V - EK)
     double EK = -77.0; // mV
-    currents["IK"] = GK_ * xr_[y][x] * xs_[y][x] * (V - EK);
+    currents[IK] = conductances[IK] * xr * xs_ * (V - EK);
     
     // Inward rectifier potassium: IK1 = GK1 * (V - EK) / (1 + exp(0.07 * (V + 80)))
-    currents["IK1"] = GK1_ * (V - EK) / (1 + exp(0.07 * (V + 80)));
+    currents[IK1] = conductances[IK1] * (V - EK) / rates[K1Denominator];
     
     // Background current: Ib = Gb * (V + 59.87)
-    currents["Ib"] = Gb_ * (V + 59.87);
+    currents[Ib] = conductances[Ib] * (V + 59.87);
     
     // T-type calcium current (simplified)
-    currents["ICaT"] = 0.0005 * d_[y][x] * (V - ECa);
+    currents[ICaT] = conductances[ICaT] * (V - ECa);
     
     return currents;
 }
 
 std::map<std::string, std::vector<std::vector<double>>> LuoRudyModel::getIonicCurrents() const {
     std::map<std::string, std::vector<std::vector<double>>> current_maps;
-    
-    // Initialize current maps
-    std::vector<std::string> current_names = {"INa", "ICaL", "IK", "IK1", "Ib", "ICaT"};
-    for (const auto& name : current_names) {
+    for (const char* name : kCurrentNames) {
         current_maps[name].resize(height_, std::vector<double>(width_, 0.0));
     }
     
     // Calculate currents for all grid points
     for (int y = 0; y < height_; ++y) {
         for (int x = 0; x < width_; ++x) {
-            auto currents = const_cast<LuoRudyModel*>(this)->calculateIonicCurrents(x, y);
-            for (const auto& pair : currents) {
-                current_maps[pair.first][y][x] = pair.second;
+            double V = state_[State::V](x, y);
+            Rates rates;
+            evaluateRates(V, rates);
+            Currents currents = calculateIonicCurrents(V, state_[State::m](x, y), state_[State::h](x, y),
+                                                       state_[State::xr](x, y), rates,
+                                                       cellConductances(tissue_classes_, x, y));
+            for (int c = 0; c < kCurrentCount; ++c) {
+                current_maps[kCurrentNames[c]][y][x] = currents[c];
             }
         }
     }
@@ -217,47 +755,19 @@ std::map<std::string, std::vector<std::vector<double>>> LuoRudyModel::getIonicCu
 }
 
 // Ten Tusscher Model Implementation
+const std::array<const char*, TenTusscherModel::kCurrentCount> TenTusscherModel::kCurrentNames = {
+    "INa", "ICaL", "IKr", "IKs", "IK1", "Ito", "INaCa", "INaK"
+};
+
 TenTusscherModel::TenTusscherModel(int width, int height, double dt)
-    : CardiacElectrophysiology(width, height, dt) {
-    
-    // Initialize state variables
-    V_.resize(height_);
-    m_.resize(height_);
-    h_.resize(height_);
-    j_.resize(height_);
-    oa_.resize(height_);
-    oi_.resize(height_);
-    d_.resize(height_);
-    f_.resize(height_);
-    fca_.resize(height_);
-    u_.resize(height_);
-    v_.resize(height_);
-    w_.resize(height_);
-    Cai_.resize(height_);
-    CaSR_.resize(height_);
-    CaSS_.resize(height_);
-    Nai_.resize(height_);
-    Ki_.resize(height_);
-    
-    for (int i = 0; i < height_; ++i) {
-        V_[i].resize(width_, -86.2);  // Resting potential
-        m_[i].resize(width_, 0.0);
-        h_[i].resize(width_, 0.75);
-        j_[i].resize(width_, 0.75);
-        oa_[i].resize(width_, 0.0);
-        oi_[i].resize(width_, 1.0);
-        d_[i].resize(width_, 0.0);
-        f_[i].resize(width_, 1.0);
-        fca_[i].resize(width_, 1.0);
-        u_[i].resize(width_, 0.0);
-        v_[i].resize(width_, 1.0);
-        w_[i].resize(width_, 1.0);
-        Cai_[i].resize(width_, 0.0002);
-        CaSR_[i].resize(width_, 0.2);
-        CaSS_[i].resize(width_, 0.0002);
-        Nai_[i].resize(width_, 11.6);
-        Ki_[i].resize(width_, 138.3);
-    }
+    : CardiacElectrophysiology(width, height, dt),
+      // Resting potential, gates and calcium
+      state_(width, height, {-86.2, 0.0, 0.0, 0.0002}),
+      h_(0.75), j_(0.75), oa_(0.0), oi_(1.0), d_(0.0), f_(1.0), fca_(1.0), v_(1.0),
+      Nai_(11.6), Ki_(138.3), tissue_classes_(1) {
+    
+    allocateScratch(kScratchRowCount);
+    conductance_scale_.resize(kCurrentCount);
     
     // Set default variant
     setVariant("epi");
@@ -267,127 +777,223 @@ TenTusscherModel::~TenTusscherModel() {
     // Destructor - vectors will automatically clean up
 }
 
-void TenTusscherModel::step() {
-    std::vector<std::vector<double>> V_new(height_, std::vector<double>(width_, 0.0));
-    std::vector<std::vector<double>> dV_dt(height_, std::vector<double>(width_, 0.0));
-    
-    // Apply diffusion
-    applyDiffusion(V_, dV_dt);
+void TenTusscherModel::updateRows(int thread_index, int y_begin, int y_end, const CellSpan& columns) {
+    const AlignedGrid<double>& V = state_[State::V];
+    double* diffusion_row = scratchRow(thread_index, DiffusionRow);
+    double* V_half = scratchRow(thread_index, VHalfRow);
+    double* m_half = scratchRow(thread_index, MHalfRow);
+    double* u_half = scratchRow(thread_index, UHalfRow);
+    double* Cai_half = scratchRow(thread_index, CaiHalfRow);
+    double* m_step = scratchRow(thread_index, MStepRow);
+    double* u_step = scratchRow(thread_index, UStepRow);
+    double* rates[kRateCount];
+    for (int r = 0; r < kRateCount; ++r) {
+        rates[r] = scratchRow(thread_index, FirstRateRow + r);
+    }
     
-    // Add reaction terms and update state variables
-    for (int y = 0; y < height_; ++y) {
-        for (int x = 0; x < width_; ++x) {
-            if (mi_region_[y][x]) {
-                // Scar tissue - no electrical activity
-                V_new[y][x] = V_[y][x];
+    // Forward Euler leaves the step rows null, so the kernel uses dt
+    const bool exponential = gate_integrator_ != GateIntegrator::ForwardEuler;
+    const TenTusscherCoefficients coeff = {dt_, h_, j_, Nai_, tissue_classes_.data()};
+    TenTusscherCoefficients half_coeff = coeff;
+    half_coeff.dt = 0.5 * dt_;
+    
+    for (int y = y_begin; y < y_end; ++y) {
+        const double* V_row = V.row(y);
+        double* m = state_[State::m].row(y);
+        double* u = state_[State::u].row(y);
+        double* Cai = state_[State::Cai].row(y);
+        
+        const double* diffusion = diffusionRow(V, y, columns, diffusion_row);
+        
+        // Currents are evaluated at the current state; V advances into
+        // V_next_, the gates and Cai in place
+        TenTusscherRowPointers row_pointers = {
+            V_row, V_row, diffusion, rates[K1Denominator], rates[NaCaExpPlus], rates[NaCaExpMinus], Cai, Cai,
+            V_next_.row(y), Cai,
+            {m, m, rates[AlphaM], rates[BetaM], exponential ? m_step : nullptr, m},
+            {u, u, rates[AlphaU], rates[BetaU], exponential ? u_step : nullptr, u}, {}};
+        tissueRow(y, row_pointers.tissue);
+        
+        // Only excitable spans are updated; scar cells keep their state
+        for (const CellSpan& live : scar_.liveSpans(y)) {
+            const CellSpan span = live.clip(columns);
+            const int x_begin = span.begin;
+            const int x_end = span.end;
+            if (x_begin >= x_end) {
                 continue;
             }
+            TenTusscherRowPointers rows = row_pointers;
+            evaluateRateRow(V_row, rates, x_begin, x_end);
             
-            auto currents = calculateIonicCurrents(x, y);
-            
-            // Total ionic current
-            double I_total = currents["INa"] + currents["ICaL"] + currents["IKr"] + 
-                           currents["IKs"] + currents["IK1"] + currents["Ito"] + 
-                           currents["INaCa"] + currents["INaK"];
-            
-            // Update membrane potential
-            double dV = -(I_total + dV_dt[y][x]) * dt_;
-            V_new[y][x] = V_[y][x] + dV;
-            
-            // Update gating variables (simplified)
-            double V_val = V_[y][x];
-            
-            // Sodium gates (simplified)
-            double alpha_m = 0.32 * (V_val + 47.13) / (1 - exp(-0.1 * (V_val + 47.13)));
-            double beta_m = 0.08 * exp(-V_val / 11.0);
-            m_[y][x] += dt_ * (alpha_m * (1 - m_[y][x]) - beta_m * m_[y][x]);
-            
-            // Potassium gates (simplified)
-            double alpha_xr = 0.0005 * exp(0.083 * (V_val + 50)) / (1 + exp(0.057 * (V_val + 50)));
-            double beta_xr = 0.0013 * exp(-0.06 * (V_val + 20)) / (1 + exp(-0.04 * (V_val + 20)));
-            u_[y][x] += dt_ * (alpha_xr * (1 - u_[y][x]) - beta_xr * u_[y][x]);
-            
-            // Calcium handling (simplified)
-            Cai_[y][x] += dt_ * 0.001 * (-currents["ICaL"] - 0.0001 * Cai_[y][x]);
-            Cai_[y][x] = std::max(0.0001, std::min(0.01, Cai_[y][x]));
+            if (gate_integrator_ == GateIntegrator::GeneralizedRushLarsen2) {
+                // Midpoint state half a step on, whose currents and rates drive the full step
+                gateStepRow(rates[AlphaM], rates[BetaM], half_coeff.dt, m_step, x_begin, x_end);
+                gateStepRow(rates[AlphaU], rates[BetaU], half_coeff.dt, u_step, x_begin, x_end);
+                TenTusscherRowPointers half = rows;
+                half.V_out = V_half;
+                half.Cai_out = Cai_half;
+                half.m.out = m_half;
+                half.u.out = u_half;
+                StencilKernels::tenTusscherRow(half, x_begin, x_end, half_coeff);
+                
+                evaluateRateRow(V_half, rates, x_begin, x_end);
+                rows.V_eval = V_half;
+                rows.Cai_eval = Cai_half;
+                rows.m.eval = m_half;
+                rows.u.eval = u_half;
+            }
+            if (exponential) {
+                gateStepRow(rates[AlphaM], rates[BetaM], dt_, m_step, x_begin, x_end);
+                gateStepRow(rates[AlphaU], rates[BetaU], dt_, u_step, x_begin, x_end);
+            }
+            StencilKernels::tenTusscherRow(rows, x_begin, x_end, coeff);
         }
+        copyScarCells(V_row, V_next_.row(y), y, columns);
     }
-    
-    V_ = V_new;
-    time_ += dt_;
+}
+
+void TenTusscherModel::evaluateRateRow(const double* V, double* const* rates, int x_begin, int x_end) const {
+    rateRow<kRateCount, exactRates>(rate_table_.get(), V, x_begin, x_end, rates);
 }
 
 void TenTusscherModel::setVariant(const std::string& variant) {
+    variantConductances(variant, tissue_classes_[0]);
+}
+
+int TenTusscherModel::addTissueClass(const std::string& variant) {
+    TenTusscherConductances conductances;
+    if (getTissueClassCount() >= kMaxTissueClasses || !variantConductances(variant, conductances)) {
+        std::cerr << "Error: Cannot add tissue class " << variant << std::endl;
+        return -1;
+    }
+    tissue_classes_.push_back(conductances);
+    return getTissueClassCount() - 1;
+}
+
+bool TenTusscherModel::variantConductances(const std::string& variant,
+                                           TenTusscherConductances& conductances) const {
+    double GNa, GCaL, GKr, GKs, GK1, Gto, GNaCa, GNaK;
     if (variant == "epi") {
         // Epicardial cell parameters
-        GNa_ = 75.0;
-        GCaL_ = 0.000175;
-        GKr_ = 0.046;
-        GKs_ = 0.0034;
-        GK1_ = 0.1908;
-        Gto_ = 0.294;
-        GNaCa_ = 1000.0;
-        GNaK_ = 1.362;
+        GNa = 75.0;
+        GCaL = 0.000175;
+        GKr = 0.046;
+        GKs = 0.0034;
+        GK1 = 0.1908;
+        Gto = 0.294;
+        GNaCa = 1000.0;
+        GNaK = 1.362;
     } else if (variant == "endo") {
         // Endocardial cell parameters
-        GNa_ = 75.0;
-        GCaL_ = 0.000175;
-        GKr_ = 0.023;
-        GKs_ = 0.0034;
-        GK1_ = 0.1908;
-        Gto_ = 0.073;
-        GNaCa_ = 1000.0;
-        GNaK_ = 1.362;
+        GNa = 75.0;
+        GCaL = 0.000175;
+        GKr = 0.023;
+        GKs = 0.0034;
+        GK1 = 0.1908;
+        Gto = 0.073;
+        GNaCa = 1000.0;
+        GNaK = 1.362;
     } else if (variant == "mid") {
         // Mid-myocardial cell parameters
-        GNa_ = 75.0;
-        GCaL_ = 0.000175;
-        GKr_ = 0.023;
-        GKs_ = 0.0034;
-        GK1_ = 0.1908;
-        Gto_ = 0.294;
-        GNaCa_ = 1000.0;
-        GNaK_ = 1.362;
+        GNa = 75.0;
+        GCaL = 0.000175;
+        GKr = 0.023;
+        GKs = 0.0034;
+        GK1 = 0.1908;
+        Gto = 0.294;
+        GNaCa = 1000.0;
+        GNaK = 1.362;
+    } else {
+        return false;
     }
+    
+    conductances[INa] = GNa;
+    conductances[ICaL] = GCaL * d_ * f_ * fca_;
+    conductances[IKr] = GKr * std::sqrt(Ki_ / 5.4);
+    conductances[IKs] = GKs * v_;
+    conductances[IK1] = GK1 * std::sqrt(Ki_ / 5.4);
+    conductances[Ito] = Gto * oa_ * oi_;
+    conductances[INaCa] = GNaCa;
+    conductances[INaK] = GNaK * Ki_ / (Ki_ + 1.0) * Nai_ / (Nai_ + 40.0);
+    return true;
+}
+
+void TenTusscherModel::exactRates(double V, double* rates) {
+    GateRate m = sodiumActivation(V);
+    GateRate u = potassiumActivation(V);
+    rates[AlphaM] = m.alpha;
+    rates[BetaM] = m.beta;
+    rates[AlphaU] = u.alpha;
+    rates[BetaU] = u.beta;
+    rates[K1Denominator] = 1 + exp(0.07 * (V + 80));
+    rates[NaCaExpPlus] = exp(0.03743 * V);
+    rates[NaCaExpMinus] = exp(-0.03743 * V);
+}
+
+std::shared_ptr<const RateTable> TenTusscherModel::makeRateTable(double resolution) const {
+    return RateTable::shared("TenTusscherModel", kRateTableMinVoltage, kRateTableMaxVoltage, resolution,
+                             kRateCount, exactRates);
 }
 
-std::map<std::string, double> TenTusscherModel::calculateIonicCurrents(int x, int y) {
-    double V = V_[y][x];
-    double Cai = Cai_[y][x];
-    double Nai = Nai_[y][x];
-    double Ki = Ki_[y][x];
+TenTusscherModel::Currents TenTusscherModel::calculateIonicCurrents(double V, double m, double u, double Cai,
+                                                                    const Rates& rates,
+                                                                    const TenTusscherConductances& conductances) const {
+    double Nai = Nai_;
     
-    std::map<std::string, double> currents;
+    Currents currents;
     
     // Fast sodium current
     double ENa = 54.4;
-    currents["INa"] = GNa_ * m_[y][x] * m_[y][x] * m_[y][x] * h_[y][x] * j_[y][x] * (V - ENa);
+    currents[INa] = conductances[INa] * m * m * m * h_ * j_ * (V - ENa);
     
     // L-type calcium current
     double ECa = 130.0;
-    currents["ICaL"] = GCaL_ * d_[y][x] * f_[y][x] * fca_[y][x] * (V - ECa);
+    currents[ICaL] = conductances[ICaL] * (V - ECa);
     
     // Rapid delayed rectifier potassium
     double EKr = -77.0;
-    currents["IKr"] = GKr_ * std::sqrt(Ki / 5.4) * u_[y][x] * (V - EKr);
+    currents[IKr] = conductances[IKr] * u * (V - EKr);
     
     // Slow delayed rectifier potassium
     double EKs = -77.0;
-    currents["IKs"] = GKs_ * v_[y][x] * (V - EKs);
+    currents[IKs] = conductances[IKs] * (V - EKs);
     
     // Inward rectifier potassium
-    currents["IK1"] = GK1_ * std::sqrt(Ki / 5.4) * (V - EKr) / (1 + exp(0.07 * (V + 80)));
+    currents[IK1] = conductances[IK1] * (V - EKr) / rates[K1Denominator];
     
     // Transient outward potassium
-    currents["Ito"] = Gto_ * oa_[y][x] * oi_[y][x] * (V - EKr);
+    currents[Ito] = conductances[Ito] * (V - EKr);
     
     // Sodium-calcium exchanger
-    currents["INaCa"] = GNaCa_ * (exp(0.03743 * V) * Nai * Nai * Nai * Cai - 
-                                 exp(-0.03743 * V) * 1.0 * 1.0 * 1.0 * 1.4) / 
-                        (1 + 0.1 * exp(-0.03743 * V));
+    currents[INaCa] = conductances[INaCa] * (rates[NaCaExpPlus] * Nai * Nai * Nai * Cai - 
+                                             rates[NaCaExpMinus] * 1.0 * 1.0 * 1.0 * 1.4) / 
+                      (1 + 0.1 * rates[NaCaExpMinus]);
     
     // Sodium-potassium pump
-    currents["INaK"] = GNaK_ * Ki / (Ki + 1.0) * Nai / (Nai + 40.0);
+    currents[INaK] = conductances[INaK];
     
     return currents;
 }
+
+std::map<std::string, std::vector<std::vector<double>>> TenTusscherModel::getIonicCurrents() const {
+    std::map<std::string, std::vector<std::vector<double>>> current_maps;
+    for (const char* name : kCurrentNames) {
+        current_maps[name].resize(height_, std::vector<double>(width_, 0.0));
+    }
+    
+    for (int y = 0; y < height_; ++y) {
+        for (int x = 0; x < width_; ++x) {
+            double V = state_[State::V](x, y);
+            Rates rates;
+            evaluateRates(V, rates);
+            Currents currents = calculateIonicCurrents(V, state_[State::m](x, y), state_[State::u](x, y),
+                                                       state_[State::Cai](x, y), rates,
+                                                       cellConductances(tissue_classes_, x, y));
+            for (int c = 0; c < kCurrentCount; ++c) {
+                current_maps[kCurrentNames[c]][y][x] = currents[c];
+            }
+        }
+    }
+    
+    return current_maps;
+}
@@ -0,0 +1,128 @@
+#include "DistributedCardiacModel.h"
+#include <algorithm>
+#include <iostream>
+
+DistributedCardiacModel::DistributedCardiacModel(int width, int height, double dt, const Factory& factory,
+                                                 MPI_Comm comm)
+    : decomposition_(width, height, comm),
+      offset_x_(decomposition_.hasWestNeighbor() ? 1 : 0),
+      offset_y_(decomposition_.hasNorthNeighbor() ? 1 : 0),
+      model_width_(decomposition_.getLocalWidth() + offset_x_ + (decomposition_.hasEastNeighbor() ? 1 : 0)),
+      model_height_(decomposition_.getLocalHeight() + offset_y_ + (decomposition_.hasSouthNeighbor() ? 1 : 0)),
+      model_(factory(model_width_, model_height_, dt)) {
+    // A periodic local model would wrap around its own block
+    if (model_->getBoundaryCondition() == BoundaryCondition::Periodic) {
+        std::cerr << "Error: Periodic boundaries are not supported by DistributedCardiacModel; "
+                  << "using zero flux" << std::endl;
+        model_->setBoundaryCondition(BoundaryCondition::ZeroFlux);
+    }
+}
+
+void DistributedCardiacModel::setMIRegion(const std::function<bool(int, int)>& is_mi) {
+    // Halo cells take the flag of the cell they mirror
+    const int x0 = decomposition_.getXBegin() - offset_x_;
+    const int y0 = decomposition_.getYBegin() - offset_y_;
+    std::vector<std::vector<bool>> region(model_height_, std::vector<bool>(model_width_));
+    for (int y = 0; y < model_height_; ++y) {
+        for (int x = 0; x < model_width_; ++x) {
+            region[y][x] = is_mi(x0 + x, y0 + y);
+        }
+    }
+    model_->setMIRegion(region);
+}
+
+void DistributedCardiacModel::setMembranePotential(const std::function<double(int, int)>& v_init) {
+    const int x0 = decomposition_.getXBegin() - offset_x_;
+    const int y0 = decomposition_.getYBegin() - offset_y_;
+    for (int y = 0; y < model_height_; ++y) {
+        double* row = model_->membranePotentialRow(y);
+        for (int x = 0; x < model_width_; ++x) {
+            row[x] = v_init(x0 + x, y0 + y);
+        }
+    }
+}
+
+bool DistributedCardiacModel::setFiberOrientation(const std::function<double(int, int)>& fiber_angle,
+                                                  double longitudinal, double transverse) {
+    const int x0 = decomposition_.getXBegin() - offset_x_;
+    const int y0 = decomposition_.getYBegin() - offset_y_;
+    std::vector<std::vector<double>> angle(model_height_, std::vector<double>(model_width_));
+    for (int y = 0; y < model_height_; ++y) {
+        for (int x = 0; x < model_width_; ++x) {
+            angle[y][x] = fiber_angle(x0 + x, y0 + y);
+        }
+    }
+    return model_->setFiberOrientation(angle, longitudinal, transverse);
+}
+
+bool DistributedCardiacModel::setBoundaryCondition(BoundaryCondition condition, double fixed_potential) {
+    if (condition == BoundaryCondition::Periodic) {
+        std::cerr << "Error: Periodic boundaries are not supported by DistributedCardiacModel" << std::endl;
+        return false;
+    }
+    model_->setBoundaryCondition(condition, fixed_potential);
+    return true;
+}
+
+void DistributedCardiacModel::setConductivity(double conductivity) {
+    model_->setConductivity(conductivity);
+}
+
+void DistributedCardiacModel::step() {
+    if (model_->getSparseDiffusion()) {
+        // The operator computes every cell's diffusion term up front, halo included
+        decomposition_.beginHaloExchange({potentialRows()}, model_->isAnisotropic());
+        decomposition_.finishHaloExchange();
+        model_->step();
+        return;
+    }
+    
+    // Ghost cells are filled before the halo is posted, as the exchange
+    // writes into V; ghosts beside halo cells then hold last step's halo, but
+    // only halo cells read them with a non-zero coupling
+    model_->beginStep();
+    decomposition_.beginHaloExchange({potentialRows()}, model_->isAnisotropic());
+    
+    // Owned cells next to a halo cell, and the halo cells, wait for the exchange
+    const int x_begin = decomposition_.hasWestNeighbor() ? 2 : 0;
+    const int y_begin = decomposition_.hasNorthNeighbor() ? 2 : 0;
+    const int x_end = std::max(x_begin, decomposition_.hasEastNeighbor() ? model_width_ - 2 : model_width_);
+    const int y_end = std::max(y_begin, decomposition_.hasSouthNeighbor() ? model_height_ - 2 : model_height_);
+    model_->stepCells(x_begin, x_end, y_begin, y_end);
+    
+    decomposition_.finishHaloExchange();
+    model_->stepCells(0, model_width_, 0, y_begin);
+    model_->stepCells(0, model_width_, y_end, model_height_);
+    model_->stepCells(0, x_begin, y_begin, y_end);
+    model_->stepCells(x_end, model_width_, y_begin, y_end);
+    model_->finishStep();
+}
+
+void DistributedCardiacModel::run(int steps) {
+    for (int i = 0; i < steps; ++i) {
+        step();
+    }
+}
+
+std::vector<std::vector<double>> DistributedCardiacModel::gatherMembranePotential(int root) const {
+    GridView<const double> potential = model_->getMembranePotential();
+    const int local_height = decomposition_.getLocalHeight();
+    DomainDecomposition::ConstFieldRows rows(local_height + 2, nullptr);
+    for (int y = 0; y < local_height; ++y) {
+        rows[y + 1] = potential[offset_y_ + y].data() + offset_x_;
+    }
+    return decomposition_.gather(rows, root);
+}
+
+DomainDecomposition::FieldRows DistributedCardiacModel::potentialRows() {
+    // Halo rows that do not exist (global edges) are never touched
+    const int local_height = decomposition_.getLocalHeight();
+    DomainDecomposition::FieldRows rows(local_height + 2, nullptr);
+    for (int y = -1; y <= local_height; ++y) {
+        int model_y = offset_y_ + y;
+        if (model_y >= 0 && model_y < model_height_) {
+            rows[y + 1] = model_->membranePotentialRow(model_y) + offset_x_;
+        }
+    }
+    return rows;
+}
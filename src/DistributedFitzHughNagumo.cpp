@@ -0,0 +1,155 @@
+#include "DistributedFitzHughNagumo.h"
+#include "StencilKernels.h"
+#include <algorithm>
+#include <iostream>
+
+template <typename Rows, typename Grid>
+Rows DistributedFitzHughNagumo::fieldRows(Grid& grid) {
+    Rows rows(grid.height() + 2);
+    for (int y = -1; y <= grid.height(); ++y) {
+        rows[y + 1] = grid.row(y);
+    }
+    return rows;
+}
+
+DistributedFitzHughNagumo::DistributedFitzHughNagumo(int width, int height, double dt, MPI_Comm comm)
+    : decomposition_(width, height, comm), width_(width), height_(height),
+      local_width_(decomposition_.getLocalWidth()), local_height_(decomposition_.getLocalHeight()),
+      x_begin_(decomposition_.getXBegin()), y_begin_(decomposition_.getYBegin()),
+      dt_(dt), time_(0.0), a_(0.1), b_(0.5), c_(1.0), d_(0.0), du_(0.1), dv_(0.0),
+      u_(local_width_, local_height_), v_(local_width_, local_height_),
+      u_new_(local_width_, local_height_), v_new_(local_width_, local_height_) {
+    compileStimulus();
+}
+
+void DistributedFitzHughNagumo::setParameters(double a, double b, double c, double d) {
+    a_ = a;
+    b_ = b;
+    c_ = c;
+    d_ = d;
+}
+
+void DistributedFitzHughNagumo::setDiffusionCoefficients(double du, double dv) {
+    du_ = du;
+    dv_ = dv;
+}
+
+void DistributedFitzHughNagumo::setInitialConditions(const std::function<double(int, int)>& u_init,
+                                                     const std::function<double(int, int)>& v_init) {
+    for (int y = 0; y < local_height_; ++y) {
+        for (int x = 0; x < local_width_; ++x) {
+            u_(x, y) = u_init(x_begin_ + x, y_begin_ + y);
+            v_(x, y) = v_init(x_begin_ + x, y_begin_ + y);
+        }
+    }
+}
+
+void DistributedFitzHughNagumo::addStimulus(int x, int y, double strength, double duration) {
+    if (x < 0 || x >= width_ || y < 0 || y >= height_) {
+        std::cerr << "Error: Invalid stimulus coordinates (" << x << ", " << y << ")" << std::endl;
+        return;
+    }
+    stimulus_schedule_.addPulse(StimulusRegion::point(x, y), strength, time_, duration);
+    compileStimulus();
+}
+
+void DistributedFitzHughNagumo::setStimulusSchedule(const StimulusSchedule& schedule) {
+    stimulus_schedule_ = schedule;
+    compileStimulus();
+}
+
+void DistributedFitzHughNagumo::step() {
+    selectStimulus(time_ + 0.5 * dt_);
+
+    // v only diffuses when dv != 0; otherwise its halo is never read
+    std::vector<DomainDecomposition::FieldRows> fields = {fieldRows<DomainDecomposition::FieldRows>(u_)};
+    if (dv_ != 0.0) {
+        fields.push_back(fieldRows<DomainDecomposition::FieldRows>(v_));
+    }
+    decomposition_.beginHaloExchange(fields);
+
+    // Cells whose stencil stays inside the block, while the halo is in flight
+    for (int y = 1; y < local_height_ - 1; ++y) {
+        updateRow(y, 1, local_width_ - 1);
+    }
+
+    decomposition_.finishHaloExchange();
+
+    // Outermost owned rows and columns read the halo
+    for (int y = 0; y < local_height_; ++y) {
+        if (y == 0 || y == local_height_ - 1) {
+            updateRow(y, 0, local_width_);
+        } else {
+            updateRow(y, 0, std::min(1, local_width_));
+            updateRow(y, std::max(local_width_ - 1, 1), local_width_);
+        }
+    }
+
+    u_.swap(u_new_);
+    v_.swap(v_new_);
+    time_ += dt_;
+}
+
+void DistributedFitzHughNagumo::run(int steps) {
+    for (int i = 0; i < steps; ++i) {
+        step();
+    }
+}
+
+std::vector<std::vector<double>> DistributedFitzHughNagumo::gatherU(int root) const {
+    return decomposition_.gather(fieldRows<DomainDecomposition::ConstFieldRows>(u_), root);
+}
+
+std::vector<std::vector<double>> DistributedFitzHughNagumo::gatherV(int root) const {
+    return decomposition_.gather(fieldRows<DomainDecomposition::ConstFieldRows>(v_), root);
+}
+
+void DistributedFitzHughNagumo::updateRow(int y, int x_begin, int x_end) {
+    if (x_begin >= x_end) {
+        return;
+    }
+    const double* u_row = u_.row(y);
+    const double* v_row = v_.row(y);
+    const double* stim_row = stimulus_rows_.row(y);
+    double* u_out = u_new_.row(y);
+    double* v_out = v_new_.row(y);
+
+    // Same split as FitzHughNagumo::updateRow in global coordinates: the
+    // outer ring of the global grid gets reaction terms only
+    auto reactionOnly = [&](int x_from, int x_to) {
+        for (int x = x_from; x < x_to; ++x) {
+            double u = u_row[x];
+            double v = v_row[x];
+            u_out[x] = u + dt_ * (u - u * u * u / 3.0 - v + stim_row[x]);
+            v_out[x] = v + dt_ * ((u + a_ - b_ * v) / c_);
+        }
+    };
+
+    const int gy = y_begin_ + y;
+    if (gy == 0 || gy == height_ - 1) {
+        reactionOnly(x_begin, x_end);
+        return;
+    }
+
+    int interior_begin = std::max(x_begin, 1 - x_begin_);
+    int interior_end = std::min(x_end, width_ - 1 - x_begin_);
+    if (interior_begin < interior_end) {
+        FHNRowPointers<double> rows = {u_.row(y - 1), u_row, u_.row(y + 1),
+                                       v_.row(y - 1), v_row, v_.row(y + 1),
+                                       stim_row, u_out, v_out};
+        FHNCoefficients<double> coeff = {dt_, du_, dv_, a_, b_, c_};
+        StencilKernels::fhnRow(rows, interior_begin, interior_end, coeff);
+    }
+    reactionOnly(x_begin, std::min(x_end, interior_begin));
+    reactionOnly(std::max(x_begin, interior_end), x_end);
+}
+
+void DistributedFitzHughNagumo::compileStimulus() {
+    stimulus_schedule_.compile(width_, height_);
+    stimulus_rows_.build(stimulus_schedule_, local_width_, local_height_, x_begin_, y_begin_);
+    selectStimulus(time_ + 0.5 * dt_);
+}
+
+void DistributedFitzHughNagumo::selectStimulus(double t) {
+    stimulus_rows_.select(stimulus_schedule_.patternAt(t));
+}
@@ -0,0 +1,201 @@
+#include "DomainDecomposition.h"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+
+// Start of part i of n equal parts of [0, extent)
+int partBegin(int extent, int parts, int i) {
+    return static_cast<int>(static_cast<long long>(extent) * i / parts);
+}
+
+} // namespace
+
+DomainDecomposition::DomainDecomposition(int global_width, int global_height, MPI_Comm comm)
+    : global_width_(global_width), global_height_(global_height), cart_comm_(MPI_COMM_NULL),
+      rank_(0), size_(1), dims_x_(1), dims_y_(1), x_begin_(0), y_begin_(0),
+      local_width_(global_width), local_height_(global_height) {
+    int size = 1;
+    MPI_Comm_size(comm, &size);
+
+    // Most balanced factorization, with more ranks along the longer side
+    int dims[2] = {0, 0};
+    MPI_Dims_create(size, 2, dims);
+    if ((global_width > global_height) != (dims[1] > dims[0])) {
+        std::swap(dims[0], dims[1]);
+    }
+    dims_y_ = dims[0];
+    dims_x_ = dims[1];
+    if (dims_x_ > global_width || dims_y_ > global_height) {
+        std::cerr << "Error: Grid " << global_width << "x" << global_height
+                  << " is too small for " << size << " ranks" << std::endl;
+    }
+
+    int periods[2] = {0, 0};
+    MPI_Cart_create(comm, 2, dims, periods, 0, &cart_comm_);
+    MPI_Comm_rank(cart_comm_, &rank_);
+    MPI_Comm_size(cart_comm_, &size_);
+
+    int coords[2] = {0, 0};
+    MPI_Cart_coords(cart_comm_, rank_, 2, coords);
+    y_begin_ = partBegin(global_height, dims_y_, coords[0]);
+    x_begin_ = partBegin(global_width, dims_x_, coords[1]);
+    local_height_ = partBegin(global_height, dims_y_, coords[0] + 1) - y_begin_;
+    local_width_ = partBegin(global_width, dims_x_, coords[1] + 1) - x_begin_;
+
+    MPI_Cart_shift(cart_comm_, 0, 1, &neighbors_[kNorth], &neighbors_[kSouth]);
+    MPI_Cart_shift(cart_comm_, 1, 1, &neighbors_[kWest], &neighbors_[kEast]);
+    for (bool north : {true, false}) {
+        for (bool east : {true, false}) {
+            int corner[2] = {coords[0] + (north ? -1 : 1), coords[1] + (east ? 1 : -1)};
+            int& neighbor = neighbors_[cornerSide(north, east)];
+            neighbor = MPI_PROC_NULL;
+            if (corner[0] >= 0 && corner[0] < dims_y_ && corner[1] >= 0 && corner[1] < dims_x_) {
+                MPI_Cart_rank(cart_comm_, corner, &neighbor);
+            }
+        }
+    }
+}
+
+DomainDecomposition::~DomainDecomposition() {
+    if (!requests_.empty()) {
+        finishHaloExchange();
+    }
+    if (cart_comm_ != MPI_COMM_NULL) {
+        MPI_Comm_free(&cart_comm_);
+    }
+}
+
+void DomainDecomposition::beginHaloExchange(const std::vector<FieldRows>& fields, bool corners) {
+    if (!requests_.empty()) {
+        finishHaloExchange();
+    }
+    pending_fields_ = fields;
+    column_send_.resize(2 * fields.size());
+    column_recv_.resize(2 * fields.size());
+
+    // Tags name the direction of travel, so a halo is received with the
+    // tag of the opposite side
+    const int opposite[kSideCount] = {kEast, kWest, kSouth, kNorth,
+                                      kSouthEast, kSouthWest, kNorthEast, kNorthWest};
+    for (int f = 0; f < static_cast<int>(fields.size()); ++f) {
+        const FieldRows& rows = fields[f];
+        auto row = [&](int y) { return rows[y + 1]; };
+
+        // Rows are contiguous: receive into and send from the grid directly
+        for (int side : {kNorth, kSouth}) {
+            if (neighbors_[side] == MPI_PROC_NULL) {
+                continue;
+            }
+            int halo_row = side == kNorth ? -1 : local_height_;
+            int edge_row = side == kNorth ? 0 : local_height_ - 1;
+            requests_.emplace_back();
+            MPI_Irecv(row(halo_row), local_width_, MPI_DOUBLE, neighbors_[side],
+                      kSideCount * f + opposite[side], cart_comm_, &requests_.back());
+            requests_.emplace_back();
+            MPI_Isend(row(edge_row), local_width_, MPI_DOUBLE, neighbors_[side], kSideCount * f + side,
+                      cart_comm_, &requests_.back());
+        }
+
+        // Columns are strided: pack the owned edge column
+        for (int side : {kWest, kEast}) {
+            if (neighbors_[side] == MPI_PROC_NULL) {
+                continue;
+            }
+            int edge_column = side == kWest ? 0 : local_width_ - 1;
+            std::vector<double>& send = column_send_[2 * f + side];
+            std::vector<double>& recv = column_recv_[2 * f + side];
+            send.resize(local_height_);
+            recv.resize(local_height_);
+            for (int y = 0; y < local_height_; ++y) {
+                send[y] = row(y)[edge_column];
+            }
+            requests_.emplace_back();
+            MPI_Irecv(recv.data(), local_height_, MPI_DOUBLE, neighbors_[side],
+                      kSideCount * f + opposite[side], cart_comm_, &requests_.back());
+            requests_.emplace_back();
+            MPI_Isend(send.data(), local_height_, MPI_DOUBLE, neighbors_[side], kSideCount * f + side,
+                      cart_comm_, &requests_.back());
+        }
+
+        // Corners are single cells, received into the halo directly
+        for (int side : {kNorthWest, kNorthEast, kSouthWest, kSouthEast}) {
+            if (!corners || neighbors_[side] == MPI_PROC_NULL) {
+                continue;
+            }
+            const bool north = side == kNorthWest || side == kNorthEast;
+            const bool east = side == kNorthEast || side == kSouthEast;
+            double* halo = row(north ? -1 : local_height_) + (east ? local_width_ : -1);
+            double* edge = row(north ? 0 : local_height_ - 1) + (east ? local_width_ - 1 : 0);
+            requests_.emplace_back();
+            MPI_Irecv(halo, 1, MPI_DOUBLE, neighbors_[side], kSideCount * f + opposite[side], cart_comm_,
+                      &requests_.back());
+            requests_.emplace_back();
+            MPI_Isend(edge, 1, MPI_DOUBLE, neighbors_[side], kSideCount * f + side, cart_comm_,
+                      &requests_.back());
+        }
+    }
+}
+
+void DomainDecomposition::finishHaloExchange() {
+    MPI_Waitall(static_cast<int>(requests_.size()), requests_.data(), MPI_STATUSES_IGNORE);
+    requests_.clear();
+
+    for (int f = 0; f < static_cast<int>(pending_fields_.size()); ++f) {
+        const FieldRows& rows = pending_fields_[f];
+        for (int side : {kWest, kEast}) {
+            if (neighbors_[side] == MPI_PROC_NULL) {
+                continue;
+            }
+            int halo_column = side == kWest ? -1 : local_width_;
+            const std::vector<double>& recv = column_recv_[2 * f + side];
+            for (int y = 0; y < local_height_; ++y) {
+                rows[y + 1][halo_column] = recv[y];
+            }
+        }
+    }
+    pending_fields_.clear();
+}
+
+std::vector<std::vector<double>> DomainDecomposition::gather(const ConstFieldRows& field, int root) const {
+    std::vector<double> local(static_cast<std::size_t>(local_width_) * local_height_);
+    for (int y = 0; y < local_height_; ++y) {
+        std::copy(field[y + 1], field[y + 1] + local_width_, local.begin() + static_cast<std::size_t>(y) * local_width_);
+    }
+
+    int extent[4] = {x_begin_, y_begin_, local_width_, local_height_};
+    std::vector<int> extents(rank_ == root ? 4 * size_ : 0);
+    MPI_Gather(extent, 4, MPI_INT, extents.data(), 4, MPI_INT, root, cart_comm_);
+
+    std::vector<int> counts, displacements;
+    std::vector<double> blocks;
+    if (rank_ == root) {
+        counts.resize(size_);
+        displacements.resize(size_);
+        int offset = 0;
+        for (int r = 0; r < size_; ++r) {
+            counts[r] = extents[4 * r + 2] * extents[4 * r + 3];
+            displacements[r] = offset;
+            offset += counts[r];
+        }
+        blocks.resize(offset);
+    }
+    MPI_Gatherv(local.data(), static_cast<int>(local.size()), MPI_DOUBLE,
+                blocks.data(), counts.data(), displacements.data(), MPI_DOUBLE, root, cart_comm_);
+
+    std::vector<std::vector<double>> result;
+    if (rank_ != root) {
+        return result;
+    }
+    result.assign(global_height_, std::vector<double>(global_width_, 0.0));
+    for (int r = 0; r < size_; ++r) {
+        const int x0 = extents[4 * r], y0 = extents[4 * r + 1];
+        const int w = extents[4 * r + 2], h = extents[4 * r + 3];
+        const double* block = blocks.data() + displacements[r];
+        for (int y = 0; y < h; ++y) {
+            std::copy(block + static_cast<std::size_t>(y) * w, block + static_cast<std::size_t>(y + 1) * w,
+                      result[y0 + y].begin() + x0);
+        }
+    }
+    return result;
+}
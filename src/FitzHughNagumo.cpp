@@ -1,34 +1,91 @@
 #include "FitzHughNagumo.h"
+#include "StencilKernels.h"
+#include "ThreadPool.h"
 #include <fstream>
 #include <iostream>
 #include <cmath>
 #include <random>
+#include <initializer_list>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include "MappedFile.h"
+#include "SnapshotWriter.h"
 
-FitzHughNagumo::FitzHughNagumo(int width, int height, double dt)
-    : width_(width), height_(height), dt_(dt), time_(0.0),
-      a_(0.1), b_(0.5), c_(1.0), d_(0.0), du_(0.1), dv_(0.0) {
-    
-    // Initialize state grids
-    u_.resize(height_);
-    v_.resize(height_);
-    u_new_.resize(height_);
-    v_new_.resize(height_);
-    stimulus_.resize(height_);
-    
-    for (int i = 0; i < height_; ++i) {
-        u_[i].resize(width_, 0.0);
-        v_[i].resize(width_, 0.0);
-        u_new_[i].resize(width_, 0.0);
-        v_new_[i].resize(width_, 0.0);
-        stimulus_[i].resize(width_, 0.0);
+namespace {
+
+// Binary checkpoint layout, version 1 (native byte order):
+//   FHNCheckpointHeader, zero padding up to payload_offset, then u and v,
+//   each as height rows of width values of the stored dtype
+const char kCheckpointMagic[8] = {'M', 'I', 'F', 'H', 'N', 'C', 'K', 'P'};
+const std::uint32_t kCheckpointVersion = 1;
+const std::size_t kCheckpointPayloadOffset = 128;
+
+struct FHNCheckpointHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t dtype;          ///< CheckpointDType of the payload
+    std::int32_t width;
+    std::int32_t height;
+    std::uint64_t payload_offset; ///< Byte offset of the u field
+    double time;
+    double a, b, c, d;
+    double du, dv;
+};
+
+static_assert(sizeof(FHNCheckpointHeader) <= kCheckpointPayloadOffset, "Checkpoint header exceeds payload offset");
+
+template <typename T> struct CheckpointDType;
+template <> struct CheckpointDType<float> { static constexpr std::uint32_t value = 1; };
+template <> struct CheckpointDType<double> { static constexpr std::uint32_t value = 2; };
+
+/**
+ * @brief Copy one mapped field into a grid, converting precision if needed
+ */
+template <typename Stored, typename T>
+void copyCheckpointField(const unsigned char* payload, AlignedGrid<T>& grid) {
+    const std::size_t row_bytes = static_cast<std::size_t>(grid.width()) * sizeof(Stored);
+    for (int y = 0; y < grid.height(); ++y) {
+        const unsigned char* source = payload + y * row_bytes;
+        if (std::is_same<Stored, T>::value) {
+            std::memcpy(grid.row(y), source, row_bytes);
+            continue;
+        }
+        T* row = grid.row(y);
+        for (int x = 0; x < grid.width(); ++x) {
+            Stored value;
+            std::memcpy(&value, source + x * sizeof(Stored), sizeof(Stored));
+            row[x] = static_cast<T>(value);
+        }
     }
 }
 
-FitzHughNagumo::~FitzHughNagumo() {
-    // Destructor - vectors will automatically clean up
+} // namespace
+
+template <typename T>
+BasicFitzHughNagumo<T>::BasicFitzHughNagumo(int width, int height, double dt)
+    : width_(width), height_(height), dt_(dt), time_(0.0),
+      a_(0.1), b_(0.5), c_(1.0), d_(0.0), du_(0.1), dv_(0.0),
+      u_(width, height), v_(width, height),
+      u_new_(width, height), v_new_(width, height),
+      block_steps_(1), block_tile_width_(0),
+      integrator_(TimeIntegrator::ForwardEuler), rel_tol_(1e-4), abs_tol_(1e-6),
+      adaptive_step_(dt), accepted_steps_(0), rejected_steps_(0),
+      active_tiles_(false), active_threshold_(0.0), activity_valid_(false),
+      tiles_x_(0), tiles_y_(0), last_active_count_(0),
+      output_(nullptr), output_interval_(1), step_count_(0),
+      deviation_{0.0, 0.0, 0} {
+    compileStimulus();
+}
+
+template <typename T>
+BasicFitzHughNagumo<T>::~BasicFitzHughNagumo() {
+    // Destructor - grids will automatically clean up
 }
 
-void FitzHughNagumo::initialize() {
+template <typename T>
+void BasicFitzHughNagumo<T>::initialize() {
     // Initialize with small random perturbations
     std::random_device rd;
     std::mt19937 gen(rd());
@@ -36,109 +93,736 @@ void FitzHughNagumo::initialize() {
     
     for (int y = 0; y < height_; ++y) {
         for (int x = 0; x < width_; ++x) {
-            u_[y][x] = dis(gen);
-            v_[y][x] = dis(gen);
-            stimulus_[y][x] = 0.0;
+            u_(x, y) = static_cast<T>(dis(gen));
+            v_(x, y) = static_cast<T>(dis(gen));
         }
     }
     
     time_ = 0.0;
+    stimulus_schedule_.clear();
+    compileStimulus();
+    activity_valid_ = false;
+    
+    if (reference_) {
+        syncReference();
+    }
 }
 
-void FitzHughNagumo::setParameters(double a, double b, double c, double d) {
+template <typename T>
+void BasicFitzHughNagumo<T>::setParameters(double a, double b, double c, double d) {
     a_ = a;
     b_ = b;
     c_ = c;
     d_ = d;
+    activity_valid_ = false;
+    
+    if (reference_) {
+        reference_->setParameters(a, b, c, d);
+    }
 }
 
-void FitzHughNagumo::setDiffusionCoefficients(double du, double dv) {
+template <typename T>
+void BasicFitzHughNagumo<T>::setDiffusionCoefficients(double du, double dv) {
     du_ = du;
     dv_ = dv;
+    activity_valid_ = false;
+    
+    if (reference_) {
+        reference_->setDiffusionCoefficients(du, dv);
+    }
 }
 
-void FitzHughNagumo::setInitialConditions(const std::vector<std::vector<double>>& u_init,
-                                         const std::vector<std::vector<double>>& v_init) {
-    if (u_init.size() != height_ || v_init.size() != height_ ||
-        (height_ > 0 && (u_init[0].size() != width_ || v_init[0].size() != width_))) {
+template <typename T>
+void BasicFitzHughNagumo<T>::setInitialConditions(const std::vector<std::vector<double>>& u_init,
+                                                  const std::vector<std::vector<double>>& v_init) {
+    if (static_cast<int>(u_init.size()) != height_ || static_cast<int>(v_init.size()) != height_ ||
+        (height_ > 0 && (static_cast<int>(u_init[0].size()) != width_ ||
+                         static_cast<int>(v_init[0].size()) != width_))) {
         std::cerr << "Error: Initial condition dimensions do not match grid size" << std::endl;
         return;
     }
     
     for (int y = 0; y < height_; ++y) {
         for (int x = 0; x < width_; ++x) {
-            u_[y][x] = u_init[y][x];
-            v_[y][x] = v_init[y][x];
+            u_(x, y) = static_cast<T>(u_init[y][x]);
+            v_(x, y) = static_cast<T>(v_init[y][x]);
         }
     }
+    activity_valid_ = false;
+    
+    if (reference_) {
+        reference_->setInitialConditions(u_init, v_init);
+    }
 }
 
-void FitzHughNagumo::addStimulus(int x, int y, double strength, double duration) {
+template <typename T>
+void BasicFitzHughNagumo<T>::addStimulus(int x, int y, double strength, double duration) {
     if (!isValidCoordinate(x, y)) {
         std::cerr << "Error: Invalid stimulus coordinates (" << x << ", " << y << ")" << std::endl;
         return;
     }
     
-    stimulus_[y][x] = strength;
-    // Note: In a more sophisticated implementation, duration would be handled
-    // by tracking stimulus timing and decay
+    stimulus_schedule_.addPulse(StimulusRegion::point(x, y), strength, time_, duration);
+    compileStimulus();
+    
+    if (reference_) {
+        reference_->addStimulus(x, y, strength, duration);
+    }
+}
+
+template <typename T>
+void BasicFitzHughNagumo<T>::setStimulusSchedule(const StimulusSchedule& schedule) {
+    stimulus_schedule_ = schedule;
+    compileStimulus();
+    
+    if (reference_) {
+        reference_->setStimulusSchedule(schedule);
+    }
+}
+
+template <typename T>
+void BasicFitzHughNagumo<T>::setOutput(SnapshotWriter* writer, int interval) {
+    if (writer && interval <= 0) {
+        std::cerr << "Error: Output interval must be positive" << std::endl;
+        return;
+    }
+    output_ = writer;
+    output_interval_ = writer ? interval : 1;
+}
+
+template <typename T>
+void BasicFitzHughNagumo<T>::setNumThreads(int num_threads) {
+    if (num_threads <= 0) {
+        num_threads = ThreadPool::hardwareConcurrency();
+    }
+    // Every band needs at least one row
+    num_threads = std::max(1, std::min(num_threads, height_));
+    
+    if (num_threads == getNumThreads()) {
+        return;
+    }
+    pool_.reset(num_threads > 1 ? new ThreadPool(num_threads) : nullptr);
+}
+
+template <typename T>
+int BasicFitzHughNagumo<T>::getNumThreads() const {
+    return pool_ ? pool_->size() : 1;
+}
+
+template <typename T>
+void BasicFitzHughNagumo<T>::setTemporalBlocking(int steps_per_block, int tile_width) {
+    block_steps_ = std::max(1, steps_per_block);
+    block_tile_width_ = std::max(0, tile_width);
 }
 
-void FitzHughNagumo::step() {
-    // Apply diffusion and reaction terms
-    std::vector<std::vector<double>> du_dt(height_, std::vector<double>(width_, 0.0));
-    std::vector<std::vector<double>> dv_dt(height_, std::vector<double>(width_, 0.0));
+template <typename T>
+void BasicFitzHughNagumo<T>::setActiveTiles(bool enabled, double threshold) {
+    active_tiles_ = enabled;
+    active_threshold_ = std::max(threshold, 0.0);
+    activity_valid_ = false;
     
-    // Calculate diffusion terms
-    if (du_ > 0.0) {
-        applyDiffusion(u_, du_, du_dt);
+    tiles_x_ = enabled ? (width_ + kActiveTileWidth - 1) / kActiveTileWidth : 0;
+    tiles_y_ = enabled ? (height_ + kActiveTileHeight - 1) / kActiveTileHeight : 0;
+    tile_active_.assign(tiles_x_ * tiles_y_, 1);
+    tile_changed_.assign(tiles_x_ * tiles_y_, 1);
+    last_active_count_ = tiles_x_ * tiles_y_;
+}
+
+template <typename T>
+double BasicFitzHughNagumo<T>::getActiveTileFraction() const {
+    if (!active_tiles_ || tile_active_.empty()) {
+        return 1.0;
+    }
+    return static_cast<double>(last_active_count_) / static_cast<double>(tile_active_.size());
+}
+
+template <typename T>
+void BasicFitzHughNagumo<T>::setIntegrator(TimeIntegrator integrator, double rel_tol, double abs_tol) {
+    integrator_ = integrator;
+    rel_tol_ = std::max(rel_tol, 0.0);
+    abs_tol_ = std::max(abs_tol, 0.0);
+    if (rel_tol_ == 0.0 && abs_tol_ == 0.0) {
+        std::cerr << "Error: Adaptive tolerances must not both be zero, using defaults" << std::endl;
+        rel_tol_ = 1e-4;
+        abs_tol_ = 1e-6;
+    }
+    adaptive_step_ = dt_;
+    activity_valid_ = false;
+    accepted_steps_ = 0;
+    rejected_steps_ = 0;
+    
+    // Stage buffers are only kept while the adaptive integrator is selected
+    for (int i = 0; i < 4; ++i) {
+        rate_u_[i] = integrator == TimeIntegrator::AdaptiveRK23 ? AlignedGrid<T>(width_, height_) : AlignedGrid<T>();
+        rate_v_[i] = integrator == TimeIntegrator::AdaptiveRK23 ? AlignedGrid<T>(width_, height_) : AlignedGrid<T>();
     }
-    if (dv_ > 0.0) {
-        applyDiffusion(v_, dv_, dv_dt);
+    for (int i = 0; i < 2; ++i) {
+        stage_u_[i] = integrator == TimeIntegrator::AdaptiveRK23 ? AlignedGrid<T>(width_, height_) : AlignedGrid<T>();
+        stage_v_[i] = integrator == TimeIntegrator::AdaptiveRK23 ? AlignedGrid<T>(width_, height_) : AlignedGrid<T>();
     }
     
-    // Add reaction terms and update
+    if (reference_) {
+        reference_->setIntegrator(integrator, rel_tol, abs_tol);
+    }
+}
+
+template <typename T>
+TimeIntegrator BasicFitzHughNagumo<T>::getIntegrator() const {
+    return integrator_;
+}
+
+template <typename T>
+long long BasicFitzHughNagumo<T>::getAcceptedSteps() const {
+    return accepted_steps_;
+}
+
+template <typename T>
+long long BasicFitzHughNagumo<T>::getRejectedSteps() const {
+    return rejected_steps_;
+}
+
+template <typename T>
+double BasicFitzHughNagumo<T>::getAdaptiveStepSize() const {
+    return adaptive_step_;
+}
+
+template <typename T>
+void BasicFitzHughNagumo<T>::setAccuracyComparison(bool enabled) {
+    deviation_ = PrecisionDeviation{0.0, 0.0, 0};
+    if (!enabled) {
+        reference_.reset();
+        return;
+    }
+    
+    reference_.reset(new BasicFitzHughNagumo<double>(width_, height_, dt_));
+    reference_->setIntegrator(integrator_, rel_tol_, abs_tol_);
+    syncReference();
+}
+
+template <typename T>
+PrecisionDeviation BasicFitzHughNagumo<T>::getPrecisionDeviation() const {
+    return deviation_;
+}
+
+template <typename T>
+void BasicFitzHughNagumo<T>::syncReference() {
+    reference_->setParameters(a_, b_, c_, d_);
+    reference_->setDiffusionCoefficients(du_, dv_);
+    reference_->time_ = time_;
+    
+    for (int y = 0; y < height_; ++y) {
+        for (int x = 0; x < width_; ++x) {
+            reference_->u_(x, y) = u_(x, y);
+            reference_->v_(x, y) = v_(x, y);
+        }
+    }
+    reference_->setStimulusSchedule(stimulus_schedule_);
+}
+
+template <typename T>
+void BasicFitzHughNagumo<T>::compareWithReference() {
+    reference_->step();
+    
     for (int y = 0; y < height_; ++y) {
+        const T* u_row = u_.row(y);
+        const T* v_row = v_.row(y);
+        const double* u_ref = reference_->u_.row(y);
+        const double* v_ref = reference_->v_.row(y);
         for (int x = 0; x < width_; ++x) {
-            double u_val = u_[y][x];
-            double v_val = v_[y][x];
-            double stim_val = stimulus_[y][x];
+            deviation_.max_abs_u = std::max(deviation_.max_abs_u, std::abs(u_row[x] - u_ref[x]));
+            deviation_.max_abs_v = std::max(deviation_.max_abs_v, std::abs(v_row[x] - v_ref[x]));
+        }
+    }
+    ++deviation_.steps_compared;
+}
+
+template <typename T>
+void BasicFitzHughNagumo<T>::step() {
+    if (integrator_ == TimeIntegrator::AdaptiveRK23) {
+        advanceAdaptive(dt_);
+        recordOutput(1);
+    } else if (integrator_ == TimeIntegrator::ImexADI) {
+        advanceImex();
+    } else if (active_tiles_) {
+        selectStimulus(time_ + 0.5 * dt_);
+        prepareActiveTiles();
+        if (pool_) {
+            pool_->run([this](int thread_index) {
+                auto band = pool_->partition(thread_index, 0, tiles_y_);
+                updateActiveTiles(band.first, band.second);
+            });
+        } else {
+            updateActiveTiles(0, tiles_y_);
+        }
+        finishActiveStep();
+    } else {
+        selectStimulus(time_ + 0.5 * dt_);
+        if (pool_) {
+            pool_->run([this](int thread_index) {
+                auto band = pool_->partition(thread_index, 0, height_);
+                updateRows(band.first, band.second);
+            });
+        } else {
+            // Diffusion, reaction and Euler update in one pass into the step buffers
+            updateRows(0, height_);
+        }
+        finishStep();
+    }
+    
+    if (reference_) {
+        compareWithReference();
+    }
+}
+
+template <typename T>
+void BasicFitzHughNagumo<T>::run(int steps) {
+    if (reference_) {
+        // Compare after every step
+        for (int i = 0; i < steps; ++i) {
+            step();
+        }
+        return;
+    }
+    
+    if (integrator_ == TimeIntegrator::AdaptiveRK23) {
+        // The whole interval (up to the next frame) is one adaptive
+        // integration, so internal steps may grow beyond dt
+        for (int done = 0; done < steps;) {
+            int chunk = std::min(steps - done, stepsUntilOutput());
+            advanceAdaptive(chunk * dt_);
+            recordOutput(chunk);
+            done += chunk;
+        }
+        return;
+    }
+    
+    if (integrator_ == TimeIntegrator::ImexADI) {
+        for (int i = 0; i < steps; ++i) {
+            advanceImex();
+        }
+        return;
+    }
+    
+    if (active_tiles_ && pool_) {
+        // Bands of tile rows; the last thread at the barrier derives the next
+        // active set and swaps the buffers
+        selectStimulus(time_ + 0.5 * dt_);
+        prepareActiveTiles();
+        pool_->run([this, steps](int thread_index) {
+            auto band = pool_->partition(thread_index, 0, tiles_y_);
+            for (int i = 0; i < steps; ++i) {
+                updateActiveTiles(band.first, band.second);
+                pool_->barrier([this] { finishActiveStep(); });
+            }
+        });
+        return;
+    }
+    
+    if (!pool_ && block_steps_ > 1 && !active_tiles_) {
+        // Blocks end where the stimulus changes, so every level of a sweep
+        // reads the same stimulus rows
+        for (int done = 0; done < steps;) {
+            int block = stepsWithCurrentStimulus(std::min({block_steps_, steps - done, stepsUntilOutput()}));
+            advanceBlock(block);
+            done += block;
+        }
+        return;
+    }
+    
+    if (!pool_) {
+        for (int i = 0; i < steps; ++i) {
+            step();
+        }
+        return;
+    }
+    
+    // One fork/join for the whole run; bands meet at a barrier after each step
+    // and the last thread to arrive swaps the buffers
+    selectStimulus(time_ + 0.5 * dt_);
+    pool_->run([this, steps](int thread_index) {
+        auto band = pool_->partition(thread_index, 0, height_);
+        for (int i = 0; i < steps; ++i) {
+            updateRows(band.first, band.second);
+            pool_->barrier([this] { finishStep(); });
+        }
+    });
+}
+
+template <typename T>
+void BasicFitzHughNagumo<T>::advanceAdaptive(double interval) {
+    // Bogacki-Shampine 3(2): third-order solution from k1..k3, error estimate
+    // from the embedded second-order solution, which also uses k4 = f(new
+    // state); k4 is reused as k1 of the next step (first same as last)
+    static const double kStage2[] = {0.5};
+    static const double kStage3[] = {0.0, 0.75};
+    static const double kSolution[] = {2.0 / 9.0, 1.0 / 3.0, 4.0 / 9.0};
+    static const double kError[] = {-5.0 / 72.0, 1.0 / 12.0, 1.0 / 9.0, -1.0 / 8.0};
+    
+    if (interval <= 0.0) {
+        return;
+    }
+    
+    const double t_end = time_ + interval;
+    std::vector<double> band_error(getNumThreads(), 0.0);
+    
+    selectStimulus(time_);
+    forEachBand([this](int, int y_begin, int y_end) {
+        evaluateRates(u_, v_, rate_u_[0], rate_v_[0], y_begin, y_end);
+    });
+    
+    while (time_ < t_end) {
+        // Steps end where the stimulus switches, so the right-hand side is
+        // smooth within every step
+        const double t_stop = std::min(t_end, stimulus_schedule_.nextChange(time_));
+        const double remaining = t_stop - time_;
+        const bool clamped = adaptive_step_ >= remaining;
+        const double h = clamped ? remaining : adaptive_step_;
+        if (h <= 1e-12 * std::max(1.0, std::abs(time_))) {
+            std::cerr << "Error: Adaptive step size underflow at t = " << time_ << std::endl;
+            return;
+        }
+        
+        // Each pass finishes the rates of one stage and builds the input of
+        // the next for its rows. The rates read neighbouring rows owned by
+        // other bands, so consecutive stage inputs go to different buffers
+        // and passes are separated by the pool's join
+        forEachBand([&](int, int y_begin, int y_end) {
+            combineStage(h, kStage2, 1, stage_u_[0], stage_v_[0], y_begin, y_end);
+        });
+        forEachBand([&](int, int y_begin, int y_end) {
+            evaluateRates(stage_u_[0], stage_v_[0], rate_u_[1], rate_v_[1], y_begin, y_end);
+            combineStage(h, kStage3, 2, stage_u_[1], stage_v_[1], y_begin, y_end);
+        });
+        forEachBand([&](int, int y_begin, int y_end) {
+            evaluateRates(stage_u_[1], stage_v_[1], rate_u_[2], rate_v_[2], y_begin, y_end);
+            combineStage(h, kSolution, 3, stage_u_[0], stage_v_[0], y_begin, y_end);
+        });
+        forEachBand([&](int thread_index, int y_begin, int y_end) {
+            evaluateRates(stage_u_[0], stage_v_[0], rate_u_[3], rate_v_[3], y_begin, y_end);
+            
+            // Max-norm of the error scaled by the tolerances
+            const T weight[4] = {static_cast<T>(h * kError[0]), static_cast<T>(h * kError[1]),
+                                 static_cast<T>(h * kError[2]), static_cast<T>(h * kError[3])};
+            const T abs_tol = static_cast<T>(abs_tol_);
+            const T rel_tol = static_cast<T>(rel_tol_);
+            auto scaled_error = [&](const AlignedGrid<T>& state, const AlignedGrid<T>& candidate,
+                                    const AlignedGrid<T>* rates) {
+                T band_max = T(0);
+                for (int y = y_begin; y < y_end; ++y) {
+                    const T* old_row = state.row(y);
+                    const T* new_row = candidate.row(y);
+                    const T* k1 = rates[0].row(y);
+                    const T* k2 = rates[1].row(y);
+                    const T* k3 = rates[2].row(y);
+                    const T* k4 = rates[3].row(y);
+                    for (int x = 0; x < width_; ++x) {
+                        T error = weight[0] * k1[x] + weight[1] * k2[x] + weight[2] * k3[x] + weight[3] * k4[x];
+                        T scale = abs_tol + rel_tol * std::max(std::abs(old_row[x]), std::abs(new_row[x]));
+                        band_max = std::max(band_max, std::abs(error) / scale);
+                    }
+                }
+                return band_max;
+            };
+            band_error[thread_index] = std::max(scaled_error(u_, stage_u_[0], rate_u_),
+                                                scaled_error(v_, stage_v_[0], rate_v_));
+        });
+        
+        double error = *std::max_element(band_error.begin(), band_error.end());
+        
+        // Standard controller with safety factor 0.9 and growth limited to [0.2, 5]
+        double factor = error > 0.0 ? 0.9 * std::pow(error, -1.0 / 3.0) : 5.0;
+        double proposed = h * std::min(5.0, std::max(0.2, factor));
+        
+        if (error <= 1.0) {
+            u_.swap(stage_u_[0]);
+            v_.swap(stage_v_[0]);
+            rate_u_[0].swap(rate_u_[3]);
+            rate_v_[0].swap(rate_v_[3]);
+            time_ = clamped ? t_stop : time_ + h;
+            ++accepted_steps_;
+            // A step shortened to hit t_stop says little about the usable size
+            adaptive_step_ = clamped ? std::max(adaptive_step_, proposed) : proposed;
+            
+            // k4 used the old stimulus; first-same-as-last does not hold across a switch
+            if (selectStimulus(time_)) {
+                forEachBand([this](int, int y_begin, int y_end) {
+                    evaluateRates(u_, v_, rate_u_[0], rate_v_[0], y_begin, y_end);
+                });
+            }
+        } else {
+            ++rejected_steps_;
+            adaptive_step_ = proposed;
+        }
+    }
+}
+
+template <typename T>
+void BasicFitzHughNagumo<T>::advanceImex() {
+    // Reaction for every cell (boundary included) into the step buffers;
+    // reciprocals instead of divisions, as in the vector stencil kernels
+    const T dt = static_cast<T>(dt_);
+    const T a = static_cast<T>(a_);
+    const T b = static_cast<T>(b_);
+    const T inv_c = static_cast<T>(1.0 / c_);
+    const T third = static_cast<T>(1.0 / 3.0);
+    selectStimulus(time_ + 0.5 * dt_);
+    forEachBand([&](int, int y_begin, int y_end) {
+        for (int y = y_begin; y < y_end; ++y) {
+            const T* u_row = u_.row(y);
+            const T* v_row = v_.row(y);
+            const T* stim_row = stimulus_rows_.row(y);
+            T* u_out = u_new_.row(y);
+            T* v_out = v_new_.row(y);
+            for (int x = 0; x < width_; ++x) {
+                T u = u_row[x];
+                T v = v_row[x];
+                u_out[x] = u + dt * (u - u * u * u * third - v + stim_row[x]);
+                v_out[x] = v + dt * (u + a - b * v) * inv_c;
+            }
+        }
+    });
+    
+    // Implicit diffusion back into the state grids
+    adi_u_.configure(width_, height_, du_ * dt_);
+    adi_u_.apply(u_new_, u_, pool_.get());
+    if (dv_ != 0.0) {
+        adi_v_.configure(width_, height_, dv_ * dt_);
+        adi_v_.apply(v_new_, v_, pool_.get());
+    } else {
+        v_.swap(v_new_);
+    }
+    
+    time_ += dt_;
+    recordOutput(1);
+}
+
+template <typename T>
+void BasicFitzHughNagumo<T>::forEachBand(const std::function<void(int, int, int)>& task) {
+    if (!pool_) {
+        task(0, 0, height_);
+        return;
+    }
+    pool_->run([this, &task](int thread_index) {
+        auto band = pool_->partition(thread_index, 0, height_);
+        task(thread_index, band.first, band.second);
+    });
+}
+
+template <typename T>
+void BasicFitzHughNagumo<T>::evaluateRates(const AlignedGrid<T>& u_src, const AlignedGrid<T>& v_src,
+                                           AlignedGrid<T>& rate_u, AlignedGrid<T>& rate_v,
+                                           int y_begin, int y_end) {
+    const T du = static_cast<T>(du_);
+    const T dv = static_cast<T>(dv_);
+    
+    for (int y = y_begin; y < y_end; ++y) {
+        const T* u_row = u_src.row(y);
+        const T* v_row = v_src.row(y);
+        const T* stim_row = stimulus_rows_.row(y);
+        T* ku = rate_u.row(y);
+        T* kv = rate_v.row(y);
+        
+        // Outer ring: reaction terms only
+        if (y == 0 || y == height_ - 1) {
+            for (int x = 0; x < width_; ++x) {
+                ku[x] = reactionU(u_row[x], v_row[x], stim_row[x]);
+                kv[x] = reactionV(u_row[x], v_row[x]);
+            }
+            continue;
+        }
+        
+        const T* u_up = u_src.row(y - 1);
+        const T* u_down = u_src.row(y + 1);
+        const T* v_up = v_src.row(y - 1);
+        const T* v_down = v_src.row(y + 1);
+        for (int x = 1; x < width_ - 1; ++x) {
+            T lap_u = u_up[x] + u_down[x] + u_row[x - 1] + u_row[x + 1] - T(4) * u_row[x];
+            T lap_v = v_up[x] + v_down[x] + v_row[x - 1] + v_row[x + 1] - T(4) * v_row[x];
+            ku[x] = du * lap_u + reactionU(u_row[x], v_row[x], stim_row[x]);
+            kv[x] = dv * lap_v + reactionV(u_row[x], v_row[x]);
+        }
+        for (int x : {0, width_ - 1}) {
+            ku[x] = reactionU(u_row[x], v_row[x], stim_row[x]);
+            kv[x] = reactionV(u_row[x], v_row[x]);
+        }
+    }
+}
+
+template <typename T>
+void BasicFitzHughNagumo<T>::combineStage(double h, const double* weights, int num_rates,
+                                          AlignedGrid<T>& out_u, AlignedGrid<T>& out_v,
+                                          int y_begin, int y_end) {
+    for (int y = y_begin; y < y_end; ++y) {
+        for (int field = 0; field < 2; ++field) {
+            const T* state = (field == 0 ? u_ : v_).row(y);
+            const AlignedGrid<T>* rates = field == 0 ? rate_u_ : rate_v_;
+            T* out = (field == 0 ? out_u : out_v).row(y);
+            
+            std::copy(state, state + width_, out);
+            for (int i = 0; i < num_rates; ++i) {
+                if (weights[i] == 0.0) {
+                    continue;
+                }
+                const T weight = static_cast<T>(h * weights[i]);
+                const T* k = rates[i].row(y);
+                for (int x = 0; x < width_; ++x) {
+                    out[x] += weight * k[x];
+                }
+            }
+        }
+    }
+}
+
+template <typename T>
+void BasicFitzHughNagumo<T>::prepareActiveTiles() {
+    if (!activity_valid_) {
+        // State was changed from outside: nothing is known to be at rest
+        std::fill(tile_active_.begin(), tile_active_.end(), 1);
+        activity_valid_ = true;
+    }
+}
+
+template <typename T>
+void BasicFitzHughNagumo<T>::updateActiveTiles(int tile_row_begin, int tile_row_end) {
+    const T threshold = static_cast<T>(active_threshold_);
+    
+    for (int tile_y = tile_row_begin; tile_y < tile_row_end; ++tile_y) {
+        int y_begin = tile_y * kActiveTileHeight;
+        int y_end = std::min(height_, y_begin + kActiveTileHeight);
+        for (int tile_x = 0; tile_x < tiles_x_; ++tile_x) {
+            int tile = tile_y * tiles_x_ + tile_x;
+            tile_changed_[tile] = 0;
+            if (!tile_active_[tile]) {
+                continue;
+            }
             
-            du_dt[y][x] += reactionU(u_val, v_val, stim_val);
-            dv_dt[y][x] += reactionV(u_val, v_val);
+            int x_begin = tile_x * kActiveTileWidth;
+            int x_end = std::min(width_, x_begin + kActiveTileWidth);
+            bool changed = false;
+            for (int y = y_begin; y < y_end; ++y) {
+                updateRow(u_, v_, u_new_, v_new_, y, x_begin, x_end);
+                
+                const T* u_row = u_.row(y);
+                const T* v_row = v_.row(y);
+                const T* u_out = u_new_.row(y);
+                const T* v_out = v_new_.row(y);
+                for (int x = x_begin; x < x_end; ++x) {
+                    changed |= std::abs(u_out[x] - u_row[x]) > threshold ||
+                               std::abs(v_out[x] - v_row[x]) > threshold;
+                }
+            }
             
-            // Update state using Euler method
-            u_new_[y][x] = u_val + dt_ * du_dt[y][x];
-            v_new_[y][x] = v_val + dt_ * dv_dt[y][x];
+            if (!changed) {
+                // Keep the tile exactly as it was, so both buffers agree on it
+                for (int y = y_begin; y < y_end; ++y) {
+                    std::copy(u_.row(y) + x_begin, u_.row(y) + x_end, u_new_.row(y) + x_begin);
+                    std::copy(v_.row(y) + x_begin, v_.row(y) + x_end, v_new_.row(y) + x_begin);
+                }
+            }
+            tile_changed_[tile] = changed ? 1 : 0;
+        }
+    }
+}
+
+template <typename T>
+void BasicFitzHughNagumo<T>::finishActiveStep() {
+    // A cell's update reads only itself and its four neighbours, so a tile
+    // whose cells and halo (in the four adjacent tiles) did not change gets
+    // exactly the same inputs as last step and would reproduce its values
+    last_active_count_ = 0;
+    for (int tile_y = 0; tile_y < tiles_y_; ++tile_y) {
+        for (int tile_x = 0; tile_x < tiles_x_; ++tile_x) {
+            int tile = tile_y * tiles_x_ + tile_x;
+            bool active = tile_changed_[tile] ||
+                          (tile_x > 0 && tile_changed_[tile - 1]) ||
+                          (tile_x + 1 < tiles_x_ && tile_changed_[tile + 1]) ||
+                          (tile_y > 0 && tile_changed_[tile - tiles_x_]) ||
+                          (tile_y + 1 < tiles_y_ && tile_changed_[tile + tiles_x_]);
+            tile_active_[tile] = active ? 1 : 0;
+            last_active_count_ += active ? 1 : 0;
         }
     }
     
-    // Swap grids
+    finishStep();
+    // A stimulus switch invalidates the active set
+    prepareActiveTiles();
+}
+
+template <typename T>
+void BasicFitzHughNagumo<T>::finishStep() {
     u_.swap(u_new_);
     v_.swap(v_new_);
     
     time_ += dt_;
+    selectStimulus(time_ + 0.5 * dt_);
+    recordOutput(1);
 }
 
-void FitzHughNagumo::run(int steps) {
-    for (int i = 0; i < steps; ++i) {
-        step();
+template <typename T>
+void BasicFitzHughNagumo<T>::recordOutput(int steps) {
+    step_count_ += steps;
+    if (output_ && step_count_ % output_interval_ == 0) {
+        output_->push(time_, step_count_, u_, v_);
     }
 }
 
-const std::vector<std::vector<double>>& FitzHughNagumo::getU() const {
-    return u_;
+template <typename T>
+int BasicFitzHughNagumo<T>::stepsUntilOutput() const {
+    if (!output_) {
+        return std::numeric_limits<int>::max();
+    }
+    return output_interval_ - static_cast<int>(step_count_ % output_interval_);
 }
 
-const std::vector<std::vector<double>>& FitzHughNagumo::getV() const {
-    return v_;
+template <typename T>
+void BasicFitzHughNagumo<T>::compileStimulus() {
+    stimulus_schedule_.compile(width_, height_);
+    stimulus_rows_.build(stimulus_schedule_, width_, height_);
+    activity_valid_ = false;
+    selectStimulus(time_ + 0.5 * dt_);
 }
 
-double FitzHughNagumo::getTime() const {
+template <typename T>
+bool BasicFitzHughNagumo<T>::selectStimulus(double t) {
+    if (!stimulus_rows_.select(stimulus_schedule_.patternAt(t))) {
+        return false;
+    }
+    activity_valid_ = false;
+    return true;
+}
+
+template <typename T>
+int BasicFitzHughNagumo<T>::stepsWithCurrentStimulus(int max_steps) {
+    selectStimulus(time_ + 0.5 * dt_);
+    int steps = 1;
+    while (steps < max_steps &&
+           stimulus_schedule_.patternAt(time_ + (steps + 0.5) * dt_) == stimulus_rows_.pattern()) {
+        ++steps;
+    }
+    return steps;
+}
+
+template <typename T>
+GridView<const T> BasicFitzHughNagumo<T>::getU() const {
+    return u_.view();
+}
+
+template <typename T>
+GridView<const T> BasicFitzHughNagumo<T>::getV() const {
+    return v_.view();
+}
+
+template <typename T>
+double BasicFitzHughNagumo<T>::getTime() const {
     return time_;
 }
 
-bool FitzHughNagumo::saveState(const std::string& filename) const {
+template <typename T>
+bool BasicFitzHughNagumo<T>::saveState(const std::string& filename, StateFormat format) const {
+    if (format == StateFormat::Binary) {
+        return saveBinaryState(filename);
+    }
+    
     std::ofstream file(filename);
     if (!file.is_open()) {
         std::cerr << "Error: Cannot create file " << filename << std::endl;
@@ -146,27 +830,27 @@ bool FitzHughNagumo::saveState(const std::string& filename) const {
     }
     
     try {
-        // Write header
-        file << width_ << " " << height_ << " " << time_ << std::endl;
-        file << a_ << " " << b_ << " " << c_ << " " << d_ << std::endl;
-        file << du_ << " " << dv_ << std::endl;
+        // Write header ('\n' rather than std::endl: one flush at close, not per row)
+        file << width_ << " " << height_ << " " << time_ << '\n';
+        file << a_ << " " << b_ << " " << c_ << " " << d_ << '\n';
+        file << du_ << " " << dv_ << '\n';
         
         // Write u values
         for (int y = 0; y < height_; ++y) {
             for (int x = 0; x < width_; ++x) {
-                file << u_[y][x];
+                file << u_(x, y);
                 if (x < width_ - 1) file << " ";
             }
-            file << std::endl;
+            file << '\n';
         }
         
         // Write v values
         for (int y = 0; y < height_; ++y) {
             for (int x = 0; x < width_; ++x) {
-                file << v_[y][x];
+                file << v_(x, y);
                 if (x < width_ - 1) file << " ";
             }
-            file << std::endl;
+            file << '\n';
         }
         
         file.close();
@@ -180,7 +864,20 @@ bool FitzHughNagumo::saveState(const std::string& filename) const {
     }
 }
 
-bool FitzHughNagumo::loadState(const std::string& filename) {
+template <typename T>
+bool BasicFitzHughNagumo<T>::loadState(const std::string& filename) {
+    activity_valid_ = false;
+    
+    MappedFile mapped;
+    if (!mapped.open(filename)) {
+        return false;
+    }
+    if (mapped.size() >= sizeof(kCheckpointMagic) &&
+        std::memcmp(mapped.data(), kCheckpointMagic, sizeof(kCheckpointMagic)) == 0) {
+        return loadBinaryState(mapped.data(), mapped.size(), filename);
+    }
+    mapped.close();
+    
     std::ifstream file(filename);
     if (!file.is_open()) {
         std::cerr << "Error: Cannot open file " << filename << std::endl;
@@ -203,7 +900,7 @@ bool FitzHughNagumo::loadState(const std::string& filename) {
         // Read u values
         for (int y = 0; y < height_; ++y) {
             for (int x = 0; x < width_; ++x) {
-                if (!(file >> u_[y][x])) {
+                if (!(file >> u_(x, y))) {
                     std::cerr << "Error reading u values" << std::endl;
                     return false;
                 }
@@ -213,7 +910,7 @@ bool FitzHughNagumo::loadState(const std::string& filename) {
         // Read v values
         for (int y = 0; y < height_; ++y) {
             for (int x = 0; x < width_; ++x) {
-                if (!(file >> v_[y][x])) {
+                if (!(file >> v_(x, y))) {
                     std::cerr << "Error reading v values" << std::endl;
                     return false;
                 }
@@ -221,6 +918,9 @@ bool FitzHughNagumo::loadState(const std::string& filename) {
         }
         
         file.close();
+        if (reference_) {
+            syncReference();
+        }
         std::cout << "State loaded from " << filename << std::endl;
         return true;
         
@@ -231,28 +931,236 @@ bool FitzHughNagumo::loadState(const std::string& filename) {
     }
 }
 
-void FitzHughNagumo::applyDiffusion(const std::vector<std::vector<double>>& grid,
-                                   double coeff,
-                                   std::vector<std::vector<double>>& result) {
-    // Apply 5-point stencil for 2D diffusion
-    for (int y = 1; y < height_ - 1; ++y) {
-        for (int x = 1; x < width_ - 1; ++x) {
-            double laplacian = grid[y-1][x] + grid[y+1][x] + grid[y][x-1] + grid[y][x+1] - 4.0 * grid[y][x];
-            result[y][x] = coeff * laplacian;
+template <typename T>
+bool BasicFitzHughNagumo<T>::saveBinaryState(const std::string& filename) const {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Cannot create file " << filename << std::endl;
+        return false;
+    }
+    
+    FHNCheckpointHeader header = {};
+    std::memcpy(header.magic, kCheckpointMagic, sizeof(kCheckpointMagic));
+    header.version = kCheckpointVersion;
+    header.dtype = CheckpointDType<T>::value;
+    header.width = width_;
+    header.height = height_;
+    header.payload_offset = kCheckpointPayloadOffset;
+    header.time = time_;
+    header.a = a_;
+    header.b = b_;
+    header.c = c_;
+    header.d = d_;
+    header.du = du_;
+    header.dv = dv_;
+    
+    char padding[kCheckpointPayloadOffset - sizeof(FHNCheckpointHeader)] = {};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(padding, sizeof(padding));
+    
+    // Rows are written straight from the grids, without the stride padding
+    const std::streamsize row_bytes = static_cast<std::streamsize>(width_) * sizeof(T);
+    for (const AlignedGrid<T>* field : {&u_, &v_}) {
+        for (int y = 0; y < height_; ++y) {
+            file.write(reinterpret_cast<const char*>(field->row(y)), row_bytes);
         }
     }
+    
+    file.close();
+    if (!file) {
+        std::cerr << "Error: Failed writing checkpoint " << filename << std::endl;
+        return false;
+    }
+    std::cout << "State saved to " << filename << std::endl;
+    return true;
 }
 
-double FitzHughNagumo::reactionU(double u_val, double v_val, double stim_val) {
+template <typename T>
+bool BasicFitzHughNagumo<T>::loadBinaryState(const unsigned char* bytes, std::size_t size,
+                                             const std::string& filename) {
+    if (size < sizeof(FHNCheckpointHeader)) {
+        std::cerr << "Error: Truncated checkpoint header in " << filename << std::endl;
+        return false;
+    }
+    FHNCheckpointHeader header;
+    std::memcpy(&header, bytes, sizeof(header));
+    
+    if (header.version != kCheckpointVersion) {
+        std::cerr << "Error: Unsupported checkpoint version " << header.version << std::endl;
+        return false;
+    }
+    if (header.width != width_ || header.height != height_) {
+        std::cerr << "Error: File grid size does not match current grid size" << std::endl;
+        return false;
+    }
+    
+    std::size_t value_size;
+    if (header.dtype == CheckpointDType<float>::value) {
+        value_size = sizeof(float);
+    } else if (header.dtype == CheckpointDType<double>::value) {
+        value_size = sizeof(double);
+    } else {
+        std::cerr << "Error: Unknown checkpoint dtype " << header.dtype << std::endl;
+        return false;
+    }
+    
+    std::size_t field_bytes = static_cast<std::size_t>(width_) * height_ * value_size;
+    if (header.payload_offset > size || size - header.payload_offset < 2 * field_bytes) {
+        std::cerr << "Error: Truncated checkpoint payload in " << filename << std::endl;
+        return false;
+    }
+    
+    const unsigned char* payload = bytes + header.payload_offset;
+    if (value_size == sizeof(float)) {
+        copyCheckpointField<float>(payload, u_);
+        copyCheckpointField<float>(payload + field_bytes, v_);
+    } else {
+        copyCheckpointField<double>(payload, u_);
+        copyCheckpointField<double>(payload + field_bytes, v_);
+    }
+    
+    time_ = header.time;
+    a_ = header.a;
+    b_ = header.b;
+    c_ = header.c;
+    d_ = header.d;
+    du_ = header.du;
+    dv_ = header.dv;
+    
+    if (reference_) {
+        syncReference();
+    }
+    std::cout << "State loaded from " << filename << std::endl;
+    return true;
+}
+
+template <typename T>
+void BasicFitzHughNagumo<T>::updateRows(int y_begin, int y_end) {
+    for (int y = y_begin; y < y_end; ++y) {
+        updateRow(u_, v_, u_new_, v_new_, y, 0, width_);
+    }
+}
+
+template <typename T>
+void BasicFitzHughNagumo<T>::updateRow(const AlignedGrid<T>& u_src, const AlignedGrid<T>& v_src,
+                                       AlignedGrid<T>& u_dst, AlignedGrid<T>& v_dst,
+                                       int y, int x_begin, int x_end) {
+    const T* u_row = u_src.row(y);
+    const T* v_row = v_src.row(y);
+    const T* stim_row = stimulus_rows_.row(y);
+    T* u_out = u_dst.row(y);
+    T* v_out = v_dst.row(y);
+    const T dt = static_cast<T>(dt_);
+    
+    // Outer ring: no diffusion, reaction terms only
+    if (y == 0 || y == height_ - 1) {
+        for (int x = x_begin; x < x_end; ++x) {
+            u_out[x] = u_row[x] + dt * reactionU(u_row[x], v_row[x], stim_row[x]);
+            v_out[x] = v_row[x] + dt * reactionV(u_row[x], v_row[x]);
+        }
+        return;
+    }
+    
+    FHNRowPointers<T> rows;
+    rows.u_up = u_src.row(y - 1);
+    rows.u_row = u_row;
+    rows.u_down = u_src.row(y + 1);
+    rows.v_up = v_src.row(y - 1);
+    rows.v_row = v_row;
+    rows.v_down = v_src.row(y + 1);
+    rows.stim = stim_row;
+    rows.u_out = u_out;
+    rows.v_out = v_out;
+    
+    // Interior columns: vectorized stencil + reaction kernel for this CPU
+    FHNCoefficients<T> coeff = {dt, static_cast<T>(du_), static_cast<T>(dv_),
+                                static_cast<T>(a_), static_cast<T>(b_), static_cast<T>(c_)};
+    int interior_begin = std::max(x_begin, 1);
+    int interior_end = std::min(x_end, width_ - 1);
+    if (interior_begin < interior_end) {
+        StencilKernels::fhnRow(rows, interior_begin, interior_end, coeff);
+    }
+    
+    // Edge columns: no diffusion, reaction terms only
+    for (int x : {0, width_ - 1}) {
+        if (x < x_begin || x >= x_end) {
+            continue;
+        }
+        u_out[x] = u_row[x] + dt * reactionU(u_row[x], v_row[x], stim_row[x]);
+        v_out[x] = v_row[x] + dt * reactionV(u_row[x], v_row[x]);
+    }
+}
+
+template <typename T>
+void BasicFitzHughNagumo<T>::advanceBlock(int steps) {
+    // Level L of the sweep lives in buffer L % 2; level 0 is the current state
+    const AlignedGrid<T>* u_src[2] = {&u_, &u_new_};
+    const AlignedGrid<T>* v_src[2] = {&v_, &v_new_};
+    AlignedGrid<T>* u_dst[2] = {&u_, &u_new_};
+    AlignedGrid<T>* v_dst[2] = {&v_, &v_new_};
+    
+    // Size tiles so that the rows touched by one wavefront position (about
+    // steps + 2 rows of u, v, their step buffers and the stimulus) stay in a
+    // 256 KiB cache
+    int tile = block_tile_width_;
+    if (tile <= 0) {
+        const int cache_bytes = 256 * 1024;
+        tile = cache_bytes / ((steps + 2) * 5 * static_cast<int>(sizeof(T)));
+        tile = std::max(64, tile / AlignedGrid<T>::kLanes * AlignedGrid<T>::kLanes);
+    }
+    
+    // Tiles and rows are skewed by one cell per level, so level L of a cell
+    // is computed only after level L-1 of all its neighbours, and a buffer
+    // entry is overwritten (level L+1) only after its last reader (level L)
+    int num_tiles = (width_ + steps - 1 + tile - 1) / tile;
+    for (int tile_index = 0; tile_index < num_tiles; ++tile_index) {
+        for (int wave = 0; wave < height_ + steps - 1; ++wave) {
+            for (int level = 1; level <= steps; ++level) {
+                int y = wave - (level - 1);
+                if (y < 0) {
+                    break;
+                }
+                if (y >= height_) {
+                    continue;
+                }
+                
+                int x_begin = std::max(0, tile_index * tile - (level - 1));
+                int x_end = std::min(width_, (tile_index + 1) * tile - (level - 1));
+                if (x_begin < x_end) {
+                    updateRow(*u_src[(level - 1) % 2], *v_src[(level - 1) % 2],
+                              *u_dst[level % 2], *v_dst[level % 2], y, x_begin, x_end);
+                }
+            }
+        }
+    }
+    
+    // Same clock arithmetic as stepping one step at a time
+    for (int level = 0; level < steps; ++level) {
+        time_ += dt_;
+    }
+    if (steps % 2 != 0) {
+        u_.swap(u_new_);
+        v_.swap(v_new_);
+    }
+    recordOutput(steps);
+}
+
+template <typename T>
+T BasicFitzHughNagumo<T>::reactionU(T u_val, T v_val, T stim_val) {
     // FitzHugh-Nagumo reaction term for u: du/dt = u - u^3/3 - v + stimulus
-    return u_val - u_val * u_val * u_val / 3.0 - v_val + stim_val;
+    return u_val - u_val * u_val * u_val / T(3) - v_val + stim_val;
 }
 
-double FitzHughNagumo::reactionV(double u_val, double v_val) {
+template <typename T>
+T BasicFitzHughNagumo<T>::reactionV(T u_val, T v_val) {
     // FitzHugh-Nagumo reaction term for v: dv/dt = (u + a - b*v)/c
-    return (u_val + a_ - b_ * v_val) / c_;
+    return (u_val + static_cast<T>(a_) - static_cast<T>(b_) * v_val) / static_cast<T>(c_);
 }
 
-bool FitzHughNagumo::isValidCoordinate(int x, int y) const {
+template <typename T>
+bool BasicFitzHughNagumo<T>::isValidCoordinate(int x, int y) const {
     return x >= 0 && x < width_ && y >= 0 && y < height_;
 }
+
+template class BasicFitzHughNagumo<double>;
+template class BasicFitzHughNagumo<float>;
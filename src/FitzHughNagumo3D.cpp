@@ -0,0 +1,284 @@
+#include "FitzHughNagumo3D.h"
+#include "StencilKernels.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <iostream>
+#include <random>
+
+namespace {
+
+// Budget for the three input planes of one brick (u and v), sized for L2
+constexpr std::size_t kBrickBytes = 512 * 1024;
+
+} // namespace
+
+FitzHughNagumo3D::FitzHughNagumo3D(int width, int height, int depth, double dt)
+    : width_(width), height_(height), depth_(depth), dt_(dt), time_(0.0),
+      a_(0.1), b_(0.5), c_(1.0), d_(0.0), du_(0.1), dv_(0.0),
+      u_(width, height * depth), v_(width, height * depth),
+      u_new_(width, height * depth), v_new_(width, height * depth),
+      stencil_(Stencil3D::SevenPoint), block_height_(0) {
+    compileStimulus();
+}
+
+FitzHughNagumo3D::~FitzHughNagumo3D() {
+}
+
+void FitzHughNagumo3D::initialize() {
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_real_distribution<double> dis(-0.01, 0.01);
+
+    for (int row = 0; row < height_ * depth_; ++row) {
+        for (int x = 0; x < width_; ++x) {
+            u_(x, row) = dis(gen);
+            v_(x, row) = dis(gen);
+        }
+    }
+
+    time_ = 0.0;
+    stimulus_schedule_.clear();
+    compileStimulus();
+}
+
+void FitzHughNagumo3D::setParameters(double a, double b, double c, double d) {
+    a_ = a;
+    b_ = b;
+    c_ = c;
+    d_ = d;
+}
+
+void FitzHughNagumo3D::setDiffusionCoefficients(double du, double dv) {
+    du_ = du;
+    dv_ = dv;
+}
+
+void FitzHughNagumo3D::setInitialConditions(const std::vector<std::vector<std::vector<double>>>& u_init,
+                                            const std::vector<std::vector<std::vector<double>>>& v_init) {
+    bool matches = static_cast<int>(u_init.size()) == depth_ && static_cast<int>(v_init.size()) == depth_;
+    for (int z = 0; matches && z < depth_; ++z) {
+        matches = static_cast<int>(u_init[z].size()) == height_ && static_cast<int>(v_init[z].size()) == height_;
+        for (int y = 0; matches && y < height_; ++y) {
+            matches = static_cast<int>(u_init[z][y].size()) == width_ &&
+                      static_cast<int>(v_init[z][y].size()) == width_;
+        }
+    }
+    if (!matches) {
+        std::cerr << "Error: Initial condition dimensions do not match grid size" << std::endl;
+        return;
+    }
+
+    for (int z = 0; z < depth_; ++z) {
+        for (int y = 0; y < height_; ++y) {
+            std::copy(u_init[z][y].begin(), u_init[z][y].end(), u_.row(rowIndex(y, z)));
+            std::copy(v_init[z][y].begin(), v_init[z][y].end(), v_.row(rowIndex(y, z)));
+        }
+    }
+}
+
+void FitzHughNagumo3D::addStimulus(int x, int y, int z, double strength, double duration) {
+    if (!isValidCoordinate(x, y, z)) {
+        std::cerr << "Error: Invalid stimulus coordinates (" << x << ", " << y << ", " << z << ")" << std::endl;
+        return;
+    }
+
+    stimulus_schedule_.addPulse(StimulusRegion::point(x, rowIndex(y, z)), strength, time_, duration);
+    compileStimulus();
+}
+
+void FitzHughNagumo3D::setStencil(Stencil3D stencil) {
+    stencil_ = stencil;
+}
+
+void FitzHughNagumo3D::setBlockHeight(int rows) {
+    block_height_ = std::max(0, rows);
+}
+
+void FitzHughNagumo3D::setNumThreads(int num_threads) {
+    if (num_threads <= 0) {
+        num_threads = ThreadPool::hardwareConcurrency();
+    }
+    // Every slab needs at least one plane
+    num_threads = std::max(1, std::min(num_threads, depth_));
+
+    if (num_threads == getNumThreads()) {
+        return;
+    }
+    pool_.reset(num_threads > 1 ? new ThreadPool(num_threads) : nullptr);
+}
+
+int FitzHughNagumo3D::getNumThreads() const {
+    return pool_ ? pool_->size() : 1;
+}
+
+void FitzHughNagumo3D::step() {
+    if (pool_) {
+        pool_->run([this](int thread_index) {
+            auto slab = pool_->partition(thread_index, 0, depth_);
+            updateSlab(slab.first, slab.second);
+        });
+    } else {
+        updateSlab(0, depth_);
+    }
+    finishStep();
+}
+
+void FitzHughNagumo3D::run(int steps) {
+    if (!pool_) {
+        for (int i = 0; i < steps; ++i) {
+            step();
+        }
+        return;
+    }
+
+    // One fork/join for the whole run; slabs meet at a barrier after each step
+    pool_->run([this, steps](int thread_index) {
+        auto slab = pool_->partition(thread_index, 0, depth_);
+        for (int i = 0; i < steps; ++i) {
+            updateSlab(slab.first, slab.second);
+            pool_->barrier([this] { finishStep(); });
+        }
+    });
+}
+
+GridView<const double> FitzHughNagumo3D::getU(int z) const {
+    if (z < 0 || z >= depth_) {
+        std::cerr << "Error: Invalid plane " << z << std::endl;
+        return GridView<const double>();
+    }
+    return GridView<const double>(u_.row(rowIndex(0, z)), width_, height_, u_.stride());
+}
+
+GridView<const double> FitzHughNagumo3D::getV(int z) const {
+    if (z < 0 || z >= depth_) {
+        std::cerr << "Error: Invalid plane " << z << std::endl;
+        return GridView<const double>();
+    }
+    return GridView<const double>(v_.row(rowIndex(0, z)), width_, height_, v_.stride());
+}
+
+void FitzHughNagumo3D::updateSlab(int z_begin, int z_end) {
+    const int block_height = effectiveBlockHeight();
+    for (int y_begin = 0; y_begin < height_; y_begin += block_height) {
+        int y_end = std::min(height_, y_begin + block_height);
+        for (int z = z_begin; z < z_end; ++z) {
+            for (int y = y_begin; y < y_end; ++y) {
+                updateRow(y, z);
+            }
+        }
+    }
+}
+
+void FitzHughNagumo3D::updateRow(int y, int z) {
+    // Outer faces: no diffusion, reaction terms only
+    if (y == 0 || y == height_ - 1 || z == 0 || z == depth_ - 1) {
+        updateBoundary(y, z, 0, width_);
+        return;
+    }
+
+    if (width_ > 2) {
+        if (stencil_ == Stencil3D::NineteenPoint) {
+            updateRow19(y, z);
+        } else {
+            const int row = rowIndex(y, z);
+            FHNRowPointers3D rows;
+            rows.plane = {u_.row(row - 1), u_.row(row), u_.row(row + 1),
+                          v_.row(row - 1), v_.row(row), v_.row(row + 1),
+                          stimulus_rows_.row(row), u_new_.row(row), v_new_.row(row)};
+            rows.u_front = u_.row(row - height_);
+            rows.u_back = u_.row(row + height_);
+            rows.v_front = v_.row(row - height_);
+            rows.v_back = v_.row(row + height_);
+
+            FHNCoefficients<double> coeff = {dt_, du_, dv_, a_, b_, c_};
+            StencilKernels::fhnRow7(rows, 1, width_ - 1, coeff);
+        }
+    }
+
+    // Edge columns: no diffusion, reaction terms only
+    updateBoundary(y, z, 0, std::min(1, width_));
+    updateBoundary(y, z, std::max(width_ - 1, 1), width_);
+}
+
+void FitzHughNagumo3D::updateRow19(int y, int z) {
+    const int row = rowIndex(y, z);
+    const double sixth = 1.0 / 6.0;
+
+    // 19-point Laplacian: (2 * faces + edges - 24 * center) / 6
+    auto laplacian = [&](const AlignedGrid<double>& grid, int x) {
+        const double* center = grid.row(row);
+        const double* up = grid.row(row - 1);
+        const double* down = grid.row(row + 1);
+        const double* front = grid.row(row - height_);
+        const double* back = grid.row(row + height_);
+        const double* front_up = grid.row(row - height_ - 1);
+        const double* front_down = grid.row(row - height_ + 1);
+        const double* back_up = grid.row(row + height_ - 1);
+        const double* back_down = grid.row(row + height_ + 1);
+
+        double faces = center[x - 1] + center[x + 1] + up[x] + down[x] + front[x] + back[x];
+        double edges = up[x - 1] + up[x + 1] + down[x - 1] + down[x + 1]
+                       + front[x - 1] + front[x + 1] + back[x - 1] + back[x + 1]
+                       + front_up[x] + front_down[x] + back_up[x] + back_down[x];
+        return (2.0 * faces + edges - 24.0 * center[x]) * sixth;
+    };
+
+    const double* u_row = u_.row(row);
+    const double* v_row = v_.row(row);
+    const double* stim_row = stimulus_rows_.row(row);
+    double* u_out = u_new_.row(row);
+    double* v_out = v_new_.row(row);
+    for (int x = 1; x < width_ - 1; ++x) {
+        u_out[x] = u_row[x] + dt_ * (du_ * laplacian(u_, x) + reactionU(u_row[x], v_row[x], stim_row[x]));
+        v_out[x] = v_row[x] + dt_ * (dv_ * laplacian(v_, x) + reactionV(u_row[x], v_row[x]));
+    }
+}
+
+void FitzHughNagumo3D::updateBoundary(int y, int z, int x_begin, int x_end) {
+    const int row = rowIndex(y, z);
+    const double* u_row = u_.row(row);
+    const double* v_row = v_.row(row);
+    const double* stim_row = stimulus_rows_.row(row);
+    double* u_out = u_new_.row(row);
+    double* v_out = v_new_.row(row);
+
+    for (int x = x_begin; x < x_end; ++x) {
+        u_out[x] = u_row[x] + dt_ * reactionU(u_row[x], v_row[x], stim_row[x]);
+        v_out[x] = v_row[x] + dt_ * reactionV(u_row[x], v_row[x]);
+    }
+}
+
+void FitzHughNagumo3D::finishStep() {
+    u_.swap(u_new_);
+    v_.swap(v_new_);
+    time_ += dt_;
+    stimulus_rows_.select(stimulus_schedule_.patternAt(time_ + 0.5 * dt_));
+}
+
+void FitzHughNagumo3D::compileStimulus() {
+    stimulus_schedule_.compile(width_, height_ * depth_);
+    stimulus_rows_.build(stimulus_schedule_, width_, height_ * depth_);
+    stimulus_rows_.select(stimulus_schedule_.patternAt(time_ + 0.5 * dt_));
+}
+
+int FitzHughNagumo3D::effectiveBlockHeight() const {
+    if (block_height_ > 0) {
+        return block_height_;
+    }
+    // Three planes of u and v per brick row
+    std::size_t row_bytes = static_cast<std::size_t>(u_.stride()) * sizeof(double) * 6;
+    int rows = static_cast<int>(kBrickBytes / std::max<std::size_t>(row_bytes, 1));
+    return std::max(4, rows);
+}
+
+double FitzHughNagumo3D::reactionU(double u_val, double v_val, double stim_val) const {
+    return u_val - u_val * u_val * u_val / 3.0 - v_val + stim_val;
+}
+
+double FitzHughNagumo3D::reactionV(double u_val, double v_val) const {
+    return (u_val + a_ - b_ * v_val) / c_;
+}
+
+bool FitzHughNagumo3D::isValidCoordinate(int x, int y, int z) const {
+    return x >= 0 && x < width_ && y >= 0 && y < height_ && z >= 0 && z < depth_;
+}
@@ -0,0 +1,220 @@
+#include "FitzHughNagumoEnsemble.h"
+#include "StencilKernels.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <iostream>
+
+FitzHughNagumoEnsemble::FitzHughNagumoEnsemble(int width, int height, int members, double dt)
+    : width_(width), height_(height), members_(std::max(members, 0)),
+      slots_((std::max(members, 1) + StencilKernels::kEnsembleBlock - 1) /
+             StencilKernels::kEnsembleBlock * StencilKernels::kEnsembleBlock),
+      dt_(dt), time_(0.0),
+      parameters_(members_),
+      du_(slots_, 0.0), dv_(slots_, 0.0), a_(slots_, 0.0), b_(slots_, 0.0), inv_c_(slots_, 1.0),
+      u_(width * slots_, height), v_(width * slots_, height),
+      u_new_(width * slots_, height), v_new_(width * slots_, height) {
+    // Padding slots keep zero coefficients, so their zero state never changes
+    for (int m = 0; m < members_; ++m) {
+        setMemberParameters(m, parameters_[m]);
+    }
+    compileStimulus();
+}
+
+FitzHughNagumoEnsemble::~FitzHughNagumoEnsemble() {
+}
+
+void FitzHughNagumoEnsemble::setMemberParameters(int member, const FHNMemberParameters& parameters) {
+    if (!isValidMember(member)) {
+        std::cerr << "Error: Invalid ensemble member " << member << std::endl;
+        return;
+    }
+
+    parameters_[member] = parameters;
+    du_[member] = parameters.du;
+    dv_[member] = parameters.dv;
+    a_[member] = parameters.a;
+    b_[member] = parameters.b;
+    inv_c_[member] = 1.0 / parameters.c;
+}
+
+FHNMemberParameters FitzHughNagumoEnsemble::getMemberParameters(int member) const {
+    if (!isValidMember(member)) {
+        std::cerr << "Error: Invalid ensemble member " << member << std::endl;
+        return FHNMemberParameters();
+    }
+    return parameters_[member];
+}
+
+void FitzHughNagumoEnsemble::setInitialConditions(int member, const std::vector<std::vector<double>>& u_init,
+                                                  const std::vector<std::vector<double>>& v_init) {
+    if (!isValidMember(member)) {
+        std::cerr << "Error: Invalid ensemble member " << member << std::endl;
+        return;
+    }
+    if (static_cast<int>(u_init.size()) != height_ || static_cast<int>(v_init.size()) != height_ ||
+        (height_ > 0 && (static_cast<int>(u_init[0].size()) != width_ ||
+                         static_cast<int>(v_init[0].size()) != width_))) {
+        std::cerr << "Error: Initial condition dimensions do not match grid size" << std::endl;
+        return;
+    }
+
+    for (int y = 0; y < height_; ++y) {
+        double* u_row = u_.row(y);
+        double* v_row = v_.row(y);
+        for (int x = 0; x < width_; ++x) {
+            u_row[x * slots_ + member] = u_init[y][x];
+            v_row[x * slots_ + member] = v_init[y][x];
+        }
+    }
+}
+
+void FitzHughNagumoEnsemble::setInitialConditions(const std::vector<std::vector<double>>& u_init,
+                                                  const std::vector<std::vector<double>>& v_init) {
+    for (int m = 0; m < members_; ++m) {
+        setInitialConditions(m, u_init, v_init);
+    }
+}
+
+void FitzHughNagumoEnsemble::addStimulus(int member, int x, int y, double strength, double duration) {
+    if (!isValidMember(member)) {
+        std::cerr << "Error: Invalid ensemble member " << member << std::endl;
+        return;
+    }
+    if (!isValidCoordinate(x, y)) {
+        std::cerr << "Error: Invalid stimulus coordinates (" << x << ", " << y << ")" << std::endl;
+        return;
+    }
+
+    stimulus_schedule_.addPulse(StimulusRegion::point(x * slots_ + member, y), strength, time_, duration);
+    compileStimulus();
+}
+
+void FitzHughNagumoEnsemble::addStimulus(int x, int y, double strength, double duration) {
+    for (int m = 0; m < members_; ++m) {
+        addStimulus(m, x, y, strength, duration);
+    }
+}
+
+void FitzHughNagumoEnsemble::setNumThreads(int num_threads) {
+    if (num_threads <= 0) {
+        num_threads = ThreadPool::hardwareConcurrency();
+    }
+    num_threads = std::max(1, std::min(num_threads, height_));
+
+    if (num_threads == getNumThreads()) {
+        return;
+    }
+    pool_.reset(num_threads > 1 ? new ThreadPool(num_threads) : nullptr);
+}
+
+int FitzHughNagumoEnsemble::getNumThreads() const {
+    return pool_ ? pool_->size() : 1;
+}
+
+void FitzHughNagumoEnsemble::step() {
+    if (pool_) {
+        pool_->run([this](int thread_index) {
+            auto band = pool_->partition(thread_index, 0, height_);
+            updateRows(band.first, band.second);
+        });
+    } else {
+        updateRows(0, height_);
+    }
+    finishStep();
+}
+
+void FitzHughNagumoEnsemble::run(int steps) {
+    if (!pool_) {
+        for (int i = 0; i < steps; ++i) {
+            step();
+        }
+        return;
+    }
+
+    pool_->run([this, steps](int thread_index) {
+        auto band = pool_->partition(thread_index, 0, height_);
+        for (int i = 0; i < steps; ++i) {
+            updateRows(band.first, band.second);
+            pool_->barrier([this] { finishStep(); });
+        }
+    });
+}
+
+StridedGridView<const double> FitzHughNagumoEnsemble::getU(int member) const {
+    if (!isValidMember(member)) {
+        std::cerr << "Error: Invalid ensemble member " << member << std::endl;
+        return StridedGridView<const double>();
+    }
+    return StridedGridView<const double>(u_.row(0) + member, width_, height_, u_.stride(), slots_);
+}
+
+StridedGridView<const double> FitzHughNagumoEnsemble::getV(int member) const {
+    if (!isValidMember(member)) {
+        std::cerr << "Error: Invalid ensemble member " << member << std::endl;
+        return StridedGridView<const double>();
+    }
+    return StridedGridView<const double>(v_.row(0) + member, width_, height_, v_.stride(), slots_);
+}
+
+void FitzHughNagumoEnsemble::updateRows(int y_begin, int y_end) {
+    FHNEnsembleCoefficients coeff = {dt_, du_.data(), dv_.data(), a_.data(), b_.data(), inv_c_.data()};
+
+    for (int y = y_begin; y < y_end; ++y) {
+        // Outer ring: no diffusion, reaction terms only
+        if (y == 0 || y == height_ - 1) {
+            updateBoundary(y, 0, width_);
+            continue;
+        }
+
+        FHNRowPointers<double> rows = {u_.row(y - 1), u_.row(y), u_.row(y + 1),
+                                       v_.row(y - 1), v_.row(y), v_.row(y + 1),
+                                       stimulus_rows_.row(y), u_new_.row(y), v_new_.row(y)};
+        if (width_ > 2) {
+            StencilKernels::fhnEnsembleRow(rows, 1, width_ - 1, slots_, coeff);
+        }
+        updateBoundary(y, 0, std::min(1, width_));
+        updateBoundary(y, std::max(width_ - 1, 1), width_);
+    }
+}
+
+void FitzHughNagumoEnsemble::updateBoundary(int y, int x_begin, int x_end) {
+    const double* u_row = u_.row(y);
+    const double* v_row = v_.row(y);
+    const double* stim_row = stimulus_rows_.row(y);
+    double* u_out = u_new_.row(y);
+    double* v_out = v_new_.row(y);
+    const double third = 1.0 / 3.0;
+
+    for (int x = x_begin; x < x_end; ++x) {
+        for (int m = 0; m < slots_; ++m) {
+            const int i = x * slots_ + m;
+            double u_val = u_row[i];
+            double v_val = v_row[i];
+            double react_u = u_val - u_val * u_val * u_val * third - v_val + stim_row[i];
+            double react_v = (u_val + a_[m] - b_[m] * v_val) * inv_c_[m];
+            u_out[i] = u_val + dt_ * react_u;
+            v_out[i] = v_val + dt_ * react_v;
+        }
+    }
+}
+
+void FitzHughNagumoEnsemble::finishStep() {
+    u_.swap(u_new_);
+    v_.swap(v_new_);
+    time_ += dt_;
+    stimulus_rows_.select(stimulus_schedule_.patternAt(time_ + 0.5 * dt_));
+}
+
+void FitzHughNagumoEnsemble::compileStimulus() {
+    stimulus_schedule_.compile(width_ * slots_, height_);
+    stimulus_rows_.build(stimulus_schedule_, width_ * slots_, height_);
+    stimulus_rows_.select(stimulus_schedule_.patternAt(time_ + 0.5 * dt_));
+}
+
+bool FitzHughNagumoEnsemble::isValidMember(int member) const {
+    return member >= 0 && member < members_;
+}
+
+bool FitzHughNagumoEnsemble::isValidCoordinate(int x, int y) const {
+    return x >= 0 && x < width_ && y >= 0 && y < height_;
+}
@@ -0,0 +1,58 @@
+#include "RateTable.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <utility>
+
+RateTable::RateTable(double v_min, double v_max, double resolution, int columns, Function function)
+    : v_min_(v_min), resolution_(resolution), inverse_resolution_(1.0 / resolution),
+      intervals_(static_cast<int>(std::ceil((v_max - v_min) / resolution))), columns_(columns),
+      function_(std::move(function)), samples_(static_cast<std::size_t>(intervals_ + 1) * columns),
+      max_error_(columns, 0.0), max_relative_error_(0.0) {
+
+    for (int i = 0; i <= intervals_; ++i) {
+        function_(v_min_ + i * resolution_, &samples_[static_cast<std::size_t>(i) * columns_]);
+    }
+
+    // Linear interpolation error peaks inside each interval
+    std::vector<double> exact(columns_), interpolated(columns_);
+    for (int i = 0; i < intervals_; ++i) {
+        for (double t : {0.25, 0.5, 0.75}) {
+            double V = v_min_ + (i + t) * resolution_;
+            function_(V, exact.data());
+            lookup(V, interpolated.data());
+            for (int c = 0; c < columns_; ++c) {
+                double error = std::abs(interpolated[c] - exact[c]);
+                max_error_[c] = std::max(max_error_[c], error);
+                if (exact[c] != 0.0) {
+                    max_relative_error_ = std::max(max_relative_error_, error / std::abs(exact[c]));
+                }
+            }
+        }
+    }
+}
+
+std::shared_ptr<const RateTable> RateTable::shared(const std::string& key, double v_min, double v_max,
+                                                   double resolution, int columns, const Function& function) {
+    if (!(resolution > 0.0) || !(v_max > v_min) || columns <= 0 || columns > kMaxColumns ||
+        (v_max - v_min) / resolution > 1e8) {
+        std::cerr << "Error: Invalid rate table range or resolution" << std::endl;
+        return nullptr;
+    }
+
+    static std::mutex mutex;
+    static std::map<std::tuple<std::string, double, double, double>, std::weak_ptr<const RateTable>> tables;
+
+    // Building under the lock keeps concurrent requests from tabulating twice
+    std::lock_guard<std::mutex> lock(mutex);
+    std::weak_ptr<const RateTable>& entry = tables[std::make_tuple(key, v_min, v_max, resolution)];
+    std::shared_ptr<const RateTable> table = entry.lock();
+    if (!table) {
+        table = std::make_shared<const RateTable>(v_min, v_max, resolution, columns, function);
+        entry = table;
+    }
+    return table;
+}
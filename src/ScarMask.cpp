@@ -0,0 +1,115 @@
+#include "ScarMask.h"
+#include <iostream>
+#include <utility>
+
+namespace {
+
+int countTrailingZeros(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#else
+    int count = 0;
+    while (!(word & 1)) {
+        word >>= 1;
+        ++count;
+    }
+    return count;
+#endif
+}
+
+// First column at or after x (up to width) whose bit differs from the bit at x
+int runEnd(const uint64_t* row, int x, int width, bool scar) {
+    const uint64_t flip = scar ? ~uint64_t(0) : 0;
+    std::size_t word = static_cast<std::size_t>(x) >> 6;
+    uint64_t changes = (row[word] ^ flip) & (~uint64_t(0) << (x & 63));
+    while (!changes) {
+        ++word;
+        if (word * 64 >= static_cast<std::size_t>(width)) {
+            return width;
+        }
+        changes = row[word] ^ flip;
+    }
+    int end = static_cast<int>(word * 64) + countTrailingZeros(changes);
+    return end < width ? end : width;
+}
+
+} // namespace
+
+ScarMask::ScarMask() : ScarMask(0, 0, 0) {
+    buildSpans();
+}
+
+ScarMask::ScarMask(int width, int height) : ScarMask(width, height, wordsPerRow(width)) {
+    storage_.assign(height * stride_, 0);
+    words_ = storage_.data();
+    buildSpans();
+}
+
+ScarMask::ScarMask(const std::vector<std::vector<bool>>& region)
+    : ScarMask(region.empty() ? 0 : static_cast<int>(region[0].size()), static_cast<int>(region.size()),
+               wordsPerRow(region.empty() ? 0 : static_cast<int>(region[0].size()))) {
+    storage_.assign(height_ * stride_, 0);
+    words_ = storage_.data();
+    for (int y = 0; y < height_; ++y) {
+        uint64_t* words = storage_.data() + y * stride_;
+        for (int x = 0; x < width_; ++x) {
+            if (region[y][x]) {
+                words[x >> 6] |= uint64_t(1) << (x & 63);
+            }
+        }
+    }
+    buildSpans();
+}
+
+ScarMask::ScarMask(int width, int height, std::size_t stride)
+    : width_(width), height_(height), stride_(stride), words_(nullptr), owns_words_(true), scar_cells_(0) {
+}
+
+ScarMask ScarMask::fromWords(std::vector<uint64_t> words, int width, int height) {
+    if (width < 0 || height < 0 || words.size() != height * wordsPerRow(width)) {
+        std::cerr << "Error: Scar mask words do not match grid size" << std::endl;
+        return ScarMask();
+    }
+    ScarMask mask(width, height, wordsPerRow(width));
+    mask.storage_ = std::move(words);
+    mask.words_ = mask.storage_.data();
+    mask.buildSpans();
+    return mask;
+}
+
+ScarMask ScarMask::view(const uint64_t* words, int width, int height, std::size_t stride) {
+    if (width < 0 || height < 0 || stride < wordsPerRow(width) || (!words && width > 0 && height > 0)) {
+        std::cerr << "Error: Invalid scar mask view" << std::endl;
+        return ScarMask();
+    }
+    ScarMask mask(width, height, stride);
+    mask.words_ = words;
+    mask.owns_words_ = false;
+    mask.buildSpans();
+    return mask;
+}
+
+void ScarMask::buildSpans() {
+    live_spans_.clear();
+    scar_spans_.clear();
+    live_offsets_.assign(1, 0);
+    scar_offsets_.assign(1, 0);
+    scar_cells_ = 0;
+
+    for (int y = 0; y < height_; ++y) {
+        const uint64_t* words = row(y);
+        for (int x = 0; x < width_;) {
+            const bool scar = (words[x >> 6] >> (x & 63)) & 1;
+            const int end = runEnd(words, x, width_, scar);
+            if (scar) {
+                scar_spans_.push_back({x, end});
+                scar_cells_ += end - x;
+            } else {
+                live_spans_.push_back({x, end});
+            }
+            x = end;
+        }
+        live_offsets_.push_back(static_cast<int>(live_spans_.size()));
+        scar_offsets_.push_back(static_cast<int>(scar_spans_.size()));
+    }
+}
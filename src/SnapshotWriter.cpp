@@ -0,0 +1,269 @@
+#include "SnapshotWriter.h"
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+namespace {
+
+// Frame file layout, version 1 (native byte order):
+//   SnapshotHeader, zero padding up to kHeaderBytes, then frames of
+//   time (double), step (int64) and the selected fields
+const char kSnapshotMagic[8] = {'M', 'I', 'F', 'H', 'N', 'F', 'R', 'M'};
+const std::uint32_t kSnapshotVersion = 1;
+const std::size_t kFramePrefixBytes = sizeof(double) + sizeof(std::int64_t);
+
+struct SnapshotHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t dtype;        ///< 1 = float, 2 = double
+    std::int32_t width;
+    std::int32_t height;
+    std::uint32_t fields;       ///< SnapshotField mask
+    std::uint32_t reserved;
+    std::uint64_t frame_bytes;  ///< Size of one frame, prefix included
+};
+
+static_assert(sizeof(SnapshotHeader) <= SnapshotWriter::kHeaderBytes, "Snapshot header exceeds header size");
+
+int fieldCount(unsigned int fields) {
+    return ((fields & kSnapshotU) ? 1 : 0) + ((fields & kSnapshotV) ? 1 : 0);
+}
+
+} // namespace
+
+SnapshotWriter::SnapshotWriter()
+    : file_(nullptr), width_(0), height_(0), fields_(0), element_size_(0), field_bytes_(0),
+      head_(0), tail_(0), stop_(false), failed_(false), frames_written_(0), frames_dropped_(0),
+      drop_when_full_(false) {
+}
+
+SnapshotWriter::~SnapshotWriter() {
+    close();
+}
+
+bool SnapshotWriter::open(const std::string& filename, int width, int height, bool single_precision,
+                          unsigned int fields, int queue_frames) {
+    close();
+
+    fields &= kSnapshotU | kSnapshotV;
+    if (width <= 0 || height <= 0 || fields == 0 || queue_frames <= 0) {
+        std::cerr << "Error: Invalid snapshot configuration for " << filename << std::endl;
+        return false;
+    }
+
+    std::FILE* file = std::fopen(filename.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Error: Cannot create file " << filename << std::endl;
+        return false;
+    }
+    // Large stdio buffer so that each frame goes out in few system calls
+    std::setvbuf(file, nullptr, _IOFBF, 1 << 20);
+
+    width_ = width;
+    height_ = height;
+    fields_ = fields;
+    element_size_ = single_precision ? sizeof(float) : sizeof(double);
+    field_bytes_ = static_cast<std::size_t>(width) * height * element_size_;
+
+    SnapshotHeader header = {};
+    std::memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+    header.version = kSnapshotVersion;
+    header.dtype = single_precision ? 1 : 2;
+    header.width = width;
+    header.height = height;
+    header.fields = fields;
+    header.frame_bytes = kFramePrefixBytes + fieldCount(fields) * field_bytes_;
+
+    unsigned char block[kHeaderBytes] = {};
+    std::memcpy(block, &header, sizeof(header));
+    if (std::fwrite(block, 1, sizeof(block), file) != sizeof(block)) {
+        std::cerr << "Error: Cannot write snapshot header to " << filename << std::endl;
+        std::fclose(file);
+        return false;
+    }
+
+    // All frame buffers are allocated up front; push() never allocates
+    slots_.assign(queue_frames, Slot());
+    for (Slot& slot : slots_) {
+        slot.payload.resize(fieldCount(fields) * field_bytes_);
+    }
+    head_.store(0, std::memory_order_relaxed);
+    tail_.store(0, std::memory_order_relaxed);
+    stop_.store(false, std::memory_order_relaxed);
+    failed_.store(false, std::memory_order_relaxed);
+    frames_written_.store(0, std::memory_order_relaxed);
+    frames_dropped_ = 0;
+
+    file_ = file;
+    thread_ = std::thread(&SnapshotWriter::writerLoop, this);
+    return true;
+}
+
+bool SnapshotWriter::close() {
+    if (!file_) {
+        return true;
+    }
+
+    stop_.store(true, std::memory_order_release);
+    thread_.join();
+
+    bool ok = !failed_.load(std::memory_order_acquire);
+    if (std::fclose(file_) != 0) {
+        ok = false;
+    }
+    file_ = nullptr;
+    slots_.clear();
+    if (!ok) {
+        std::cerr << "Error: Writing snapshot frames failed" << std::endl;
+    }
+    return ok;
+}
+
+SnapshotWriter::Slot* SnapshotWriter::acquireSlot() {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    for (int spins = 0; head - tail_.load(std::memory_order_acquire) >= slots_.size(); ++spins) {
+        if (drop_when_full_ || failed_.load(std::memory_order_relaxed)) {
+            ++frames_dropped_;
+            return nullptr;
+        }
+        if (spins > 64) {
+            std::this_thread::yield();
+        }
+    }
+    return &slots_[head % slots_.size()];
+}
+
+void SnapshotWriter::commitSlot() {
+    head_.fetch_add(1, std::memory_order_release);
+}
+
+void SnapshotWriter::writerLoop() {
+    int idle = 0;
+    for (;;) {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) {
+            // Check the stop flag only with an empty queue, so close() drains it
+            if (stop_.load(std::memory_order_acquire) && tail == head_.load(std::memory_order_acquire)) {
+                break;
+            }
+            if (++idle > 64) {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            } else {
+                std::this_thread::yield();
+            }
+            continue;
+        }
+        idle = 0;
+
+        const Slot& slot = slots_[tail % slots_.size()];
+        if (!failed_.load(std::memory_order_relaxed)) {
+            std::int64_t step = slot.step;
+            bool ok = std::fwrite(&slot.time, sizeof(slot.time), 1, file_) == 1 &&
+                      std::fwrite(&step, sizeof(step), 1, file_) == 1 &&
+                      std::fwrite(slot.payload.data(), 1, slot.payload.size(), file_) == slot.payload.size();
+            if (ok) {
+                frames_written_.fetch_add(1, std::memory_order_release);
+            } else {
+                failed_.store(true, std::memory_order_release);
+            }
+        }
+        tail_.store(tail + 1, std::memory_order_release);
+    }
+
+    if (std::fflush(file_) != 0) {
+        failed_.store(true, std::memory_order_release);
+    }
+}
+
+SnapshotReader::SnapshotReader()
+    : width_(0), height_(0), fields_(0), element_size_(0), frame_bytes_(0), frame_count_(0) {
+}
+
+bool SnapshotReader::open(const std::string& filename) {
+    frame_count_ = 0;
+    if (!file_.open(filename)) {
+        return false;
+    }
+
+    SnapshotHeader header;
+    if (file_.size() < SnapshotWriter::kHeaderBytes ||
+        std::memcmp(file_.data(), kSnapshotMagic, sizeof(kSnapshotMagic)) != 0) {
+        std::cerr << "Error: " << filename << " is not a snapshot file" << std::endl;
+        file_.close();
+        return false;
+    }
+    std::memcpy(&header, file_.data(), sizeof(header));
+    if (header.version != kSnapshotVersion || (header.dtype != 1 && header.dtype != 2) ||
+        header.width <= 0 || header.height <= 0) {
+        std::cerr << "Error: Unsupported snapshot file " << filename << std::endl;
+        file_.close();
+        return false;
+    }
+
+    width_ = header.width;
+    height_ = header.height;
+    fields_ = header.fields;
+    element_size_ = header.dtype == 1 ? sizeof(float) : sizeof(double);
+    frame_bytes_ = static_cast<std::size_t>(header.frame_bytes);
+    if (frame_bytes_ != kFramePrefixBytes + fieldCount(fields_) * static_cast<std::size_t>(width_) * height_ * element_size_) {
+        std::cerr << "Error: Inconsistent frame size in " << filename << std::endl;
+        file_.close();
+        return false;
+    }
+    // A frame cut short by an interrupted run is ignored
+    frame_count_ = static_cast<long long>((file_.size() - SnapshotWriter::kHeaderBytes) / frame_bytes_);
+    return true;
+}
+
+const unsigned char* SnapshotReader::frameData(long long frame) const {
+    if (frame < 0 || frame >= frame_count_) {
+        return nullptr;
+    }
+    return file_.data() + SnapshotWriter::kHeaderBytes + static_cast<std::size_t>(frame) * frame_bytes_;
+}
+
+double SnapshotReader::getTime(long long frame) const {
+    const unsigned char* data = frameData(frame);
+    double time = 0.0;
+    if (data) {
+        std::memcpy(&time, data, sizeof(time));
+    }
+    return time;
+}
+
+long long SnapshotReader::getStep(long long frame) const {
+    const unsigned char* data = frameData(frame);
+    std::int64_t step = 0;
+    if (data) {
+        std::memcpy(&step, data + sizeof(double), sizeof(step));
+    }
+    return step;
+}
+
+std::vector<std::vector<double>> SnapshotReader::getField(long long frame, SnapshotField field) const {
+    const unsigned char* data = frameData(frame);
+    if (!data || !hasField(field)) {
+        return std::vector<std::vector<double>>();
+    }
+
+    const std::size_t field_bytes = static_cast<std::size_t>(width_) * height_ * element_size_;
+    const unsigned char* values = data + kFramePrefixBytes;
+    if (field == kSnapshotV && hasField(kSnapshotU)) {
+        values += field_bytes;
+    }
+
+    std::vector<std::vector<double>> result(height_, std::vector<double>(width_));
+    for (int y = 0; y < height_; ++y) {
+        for (int x = 0; x < width_; ++x) {
+            const unsigned char* value = values + (static_cast<std::size_t>(y) * width_ + x) * element_size_;
+            if (element_size_ == sizeof(float)) {
+                float stored;
+                std::memcpy(&stored, value, sizeof(stored));
+                result[y][x] = stored;
+            } else {
+                std::memcpy(&result[y][x], value, sizeof(double));
+            }
+        }
+    }
+    return result;
+}
@@ -0,0 +1,213 @@
+#include "SparseDiffusion.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+
+int degree(const std::vector<int>& row_begin, int cell) {
+    return row_begin[cell + 1] - row_begin[cell];
+}
+
+// Breadth-first level structure of the component of start: the cells in
+// visiting order, level l being [level_begin[l], level_begin[l + 1]).
+// Visited cells are marked with stamp in seen.
+std::vector<int> levelStructure(const std::vector<int>& row_begin, const std::vector<int>& columns, int start,
+                                std::vector<int>& seen, int stamp, std::vector<int>& level_begin) {
+    std::vector<int> cells(1, start);
+    level_begin.assign(1, 0);
+    seen[start] = stamp;
+    for (std::size_t level_end = 1, i = 0; i < cells.size(); ) {
+        for (; i < level_end; ++i) {
+            for (int k = row_begin[cells[i]]; k < row_begin[cells[i] + 1]; ++k) {
+                if (seen[columns[k]] != stamp) {
+                    seen[columns[k]] = stamp;
+                    cells.push_back(columns[k]);
+                }
+            }
+        }
+        level_begin.push_back(static_cast<int>(level_end));
+        level_end = cells.size();
+    }
+    return cells;
+}
+
+} // namespace
+
+SparseDiffusion::SparseDiffusion() : row_begin_(1, 0) {
+}
+
+bool SparseDiffusion::assemble(const std::vector<int>& row_begin, const std::vector<int>& columns,
+                               const std::vector<double>& values, const std::vector<double>& constant) {
+    const int cells = static_cast<int>(row_begin.size()) - 1;
+    bool valid = cells >= 0 && row_begin[0] == 0 && columns.size() == values.size() &&
+                 static_cast<std::size_t>(row_begin.back()) == columns.size() &&
+                 (constant.empty() || constant.size() == static_cast<std::size_t>(cells));
+    for (int i = 0; valid && i < cells; ++i) {
+        valid = row_begin[i] <= row_begin[i + 1];
+    }
+    for (std::size_t k = 0; valid && k < columns.size(); ++k) {
+        valid = columns[k] >= 0 && columns[k] < cells;
+    }
+    if (!valid) {
+        std::cerr << "Error: Inconsistent sparse diffusion operator" << std::endl;
+        return false;
+    }
+
+    // Renumber by the pattern of the off-diagonal entries
+    std::vector<int> pattern_begin(1, 0), pattern;
+    pattern.reserve(columns.size());
+    for (int i = 0; i < cells; ++i) {
+        for (int k = row_begin[i]; k < row_begin[i + 1]; ++k) {
+            if (columns[k] != i) {
+                pattern.push_back(columns[k]);
+            }
+        }
+        pattern_begin.push_back(static_cast<int>(pattern.size()));
+    }
+    order_ = reverseCuthillMcKee(pattern_begin, pattern);
+    std::vector<int> position(cells);
+    for (int i = 0; i < cells; ++i) {
+        position[order_[i]] = i;
+    }
+
+    row_begin_.assign(1, 0);
+    columns_.clear();
+    values_.clear();
+    diagonal_.assign(cells, 0.0);
+    constant_.clear();
+    bool has_constant = false;
+    for (double b : constant) {
+        has_constant = has_constant || b != 0.0;
+    }
+    if (has_constant) {
+        constant_.resize(cells);
+    }
+
+    // Off-diagonal entries of each row sorted by column, so a row reads v forwards
+    std::vector<std::pair<int, double>> row;
+    for (int i = 0; i < cells; ++i) {
+        const int old = order_[i];
+        row.clear();
+        for (int k = row_begin[old]; k < row_begin[old + 1]; ++k) {
+            if (columns[k] == old) {
+                diagonal_[i] += values[k];
+            } else {
+                row.emplace_back(position[columns[k]], values[k]);
+            }
+        }
+        std::sort(row.begin(), row.end(), [](const std::pair<int, double>& a, const std::pair<int, double>& b) {
+            return a.first < b.first;
+        });
+        for (const auto& entry : row) {
+            columns_.push_back(entry.first);
+            values_.push_back(entry.second);
+        }
+        row_begin_.push_back(static_cast<int>(columns_.size()));
+        if (has_constant) {
+            constant_[i] = constant[old];
+        }
+    }
+    return true;
+}
+
+void SparseDiffusion::apply(const double* in, double* out, int row_begin, int row_end) const {
+    const int* begin = row_begin_.data();
+    const int* columns = columns_.data();
+    const double* values = values_.data();
+    const double* diagonal = diagonal_.data();
+    if (constant_.empty()) {
+        for (int i = row_begin; i < row_end; ++i) {
+            double sum = diagonal[i] * in[i];
+            for (int k = begin[i]; k < begin[i + 1]; ++k) {
+                sum += values[k] * in[columns[k]];
+            }
+            out[i] = sum;
+        }
+        return;
+    }
+    const double* constant = constant_.data();
+    for (int i = row_begin; i < row_end; ++i) {
+        double sum = constant[i] + diagonal[i] * in[i];
+        for (int k = begin[i]; k < begin[i + 1]; ++k) {
+            sum += values[k] * in[columns[k]];
+        }
+        out[i] = sum;
+    }
+}
+
+int SparseDiffusion::getBandwidth() const {
+    int bandwidth = 0;
+    for (int i = 0; i < size(); ++i) {
+        for (int k = row_begin_[i]; k < row_begin_[i + 1]; ++k) {
+            bandwidth = std::max(bandwidth, std::abs(columns_[k] - i));
+        }
+    }
+    return bandwidth;
+}
+
+std::vector<int> SparseDiffusion::reverseCuthillMcKee(const std::vector<int>& row_begin,
+                                                      const std::vector<int>& columns) {
+    const int cells = static_cast<int>(row_begin.size()) - 1;
+    std::vector<int> order;
+    order.reserve(cells);
+    std::vector<bool> numbered(cells, false);
+    std::vector<int> seen(cells, -1);
+    std::vector<int> level_begin, neighbours;
+    int stamp = 0;
+
+    for (int first = 0; first < cells; ++first) {
+        if (numbered[first]) {
+            continue;
+        }
+
+        // Pseudo-peripheral start (George-Liu): move to a lowest-degree cell
+        // of the last level while that deepens the level structure
+        int start = first;
+        std::vector<int> component = levelStructure(row_begin, columns, start, seen, stamp++, level_begin);
+        for (int c : component) {
+            if (degree(row_begin, c) < degree(row_begin, start)) {
+                start = c;
+            }
+        }
+        component = levelStructure(row_begin, columns, start, seen, stamp++, level_begin);
+        for (;;) {
+            const int depth = static_cast<int>(level_begin.size());
+            int candidate = component[level_begin[depth - 2]];
+            for (int i = level_begin[depth - 2]; i < level_begin[depth - 1]; ++i) {
+                if (degree(row_begin, component[i]) < degree(row_begin, candidate)) {
+                    candidate = component[i];
+                }
+            }
+            std::vector<int> candidate_levels;
+            std::vector<int> candidate_component =
+                levelStructure(row_begin, columns, candidate, seen, stamp++, candidate_levels);
+            if (candidate_levels.size() <= level_begin.size()) {
+                break;
+            }
+            start = candidate;
+            component.swap(candidate_component);
+            level_begin.swap(candidate_levels);
+        }
+
+        // Cuthill-McKee: breadth first, unnumbered neighbours by increasing degree
+        const std::size_t component_begin = order.size();
+        order.push_back(start);
+        numbered[start] = true;
+        for (std::size_t i = component_begin; i < order.size(); ++i) {
+            neighbours.clear();
+            for (int k = row_begin[order[i]]; k < row_begin[order[i] + 1]; ++k) {
+                if (!numbered[columns[k]]) {
+                    numbered[columns[k]] = true;
+                    neighbours.push_back(columns[k]);
+                }
+            }
+            std::stable_sort(neighbours.begin(), neighbours.end(), [&](int a, int b) {
+                return degree(row_begin, a) < degree(row_begin, b);
+            });
+            order.insert(order.end(), neighbours.begin(), neighbours.end());
+        }
+    }
+    std::reverse(order.begin(), order.end());
+    return order;
+}
@@ -0,0 +1,1537 @@
+#include "StencilKernels.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define MI_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+template <typename T>
+using FHNRowFn = void (*)(const FHNRowPointers<T>&, int, int, const FHNCoefficients<T>&);
+typedef void (*LaplacianRowFn)(const double*, const double*, const double*, double, double*, int, int);
+typedef void (*NinePointRowFn)(const NinePointRowPointers&, int, int);
+typedef void (*FHNRow7Fn)(const FHNRowPointers3D&, int, int, const FHNCoefficients<double>&);
+typedef void (*FHNEnsembleRowFn)(const FHNRowPointers<double>&, int, int, int, const FHNEnsembleCoefficients&);
+typedef void (*LuoRudyRowFn)(const LuoRudyRowPointers&, int, int, const LuoRudyCoefficients&);
+typedef void (*TenTusscherRowFn)(const TenTusscherRowPointers&, int, int, const TenTusscherCoefficients&);
+
+struct KernelTable {
+    SimdLevel level;
+    FHNRowFn<double> fhn_row;
+    FHNRowFn<float> fhn_row_float;
+    FHNRow7Fn fhn_row7;
+    FHNEnsembleRowFn fhn_ensemble_row;
+    LaplacianRowFn laplacian_row;
+    NinePointRowFn nine_point_row;
+    NinePointRowFn five_point_row;
+    LuoRudyRowFn luo_rudy_row;
+    TenTusscherRowFn ten_tusscher_row;
+};
+
+// Scalar kernels (also used for the tails of the vector loops)
+
+template <typename T>
+void fhnRowScalar(const FHNRowPointers<T>& r, int x_begin, int x_end, const FHNCoefficients<T>& k) {
+    for (int x = x_begin; x < x_end; ++x) {
+        T u_val = r.u_row[x];
+        T v_val = r.v_row[x];
+
+        // 5-point stencil Laplacian
+        T lap_u = r.u_up[x] + r.u_down[x] + r.u_row[x-1] + r.u_row[x+1] - T(4) * u_val;
+        T lap_v = r.v_up[x] + r.v_down[x] + r.v_row[x-1] + r.v_row[x+1] - T(4) * v_val;
+
+        // Reaction terms: du/dt = u - u^3/3 - v + I, dv/dt = (u + a - b*v)/c
+        T react_u = u_val - u_val * u_val * u_val / T(3) - v_val + r.stim[x];
+        T react_v = (u_val + k.a - k.b * v_val) / k.c;
+
+        // Euler update
+        r.u_out[x] = u_val + k.dt * (k.du * lap_u + react_u);
+        r.v_out[x] = v_val + k.dt * (k.dv * lap_v + react_v);
+    }
+}
+
+void fhnRow7Scalar(const FHNRowPointers3D& r3, int x_begin, int x_end, const FHNCoefficients<double>& k) {
+    const FHNRowPointers<double>& r = r3.plane;
+    for (int x = x_begin; x < x_end; ++x) {
+        double u_val = r.u_row[x];
+        double v_val = r.v_row[x];
+
+        // 7-point stencil Laplacian
+        double lap_u = r.u_up[x] + r.u_down[x] + r.u_row[x-1] + r.u_row[x+1]
+                       + r3.u_front[x] + r3.u_back[x] - 6.0 * u_val;
+        double lap_v = r.v_up[x] + r.v_down[x] + r.v_row[x-1] + r.v_row[x+1]
+                       + r3.v_front[x] + r3.v_back[x] - 6.0 * v_val;
+
+        double react_u = u_val - u_val * u_val * u_val / 3.0 - v_val + r.stim[x];
+        double react_v = (u_val + k.a - k.b * v_val) / k.c;
+
+        r.u_out[x] = u_val + k.dt * (k.du * lap_u + react_u);
+        r.v_out[x] = v_val + k.dt * (k.dv * lap_v + react_v);
+    }
+}
+
+// Ensemble kernels use reciprocals at every level, so all levels agree to rounding
+void fhnEnsembleRowScalar(const FHNRowPointers<double>& r, int x_begin, int x_end, int members,
+                          const FHNEnsembleCoefficients& k) {
+    const double third = 1.0 / 3.0;
+    for (int x = x_begin; x < x_end; ++x) {
+        const std::ptrdiff_t cell = static_cast<std::ptrdiff_t>(x) * members;
+        for (int m = 0; m < members; ++m) {
+            const std::ptrdiff_t i = cell + m;
+            double u_val = r.u_row[i];
+            double v_val = r.v_row[i];
+
+            double lap_u = r.u_up[i] + r.u_down[i] + r.u_row[i - members] + r.u_row[i + members] - 4.0 * u_val;
+            double lap_v = r.v_up[i] + r.v_down[i] + r.v_row[i - members] + r.v_row[i + members] - 4.0 * v_val;
+
+            double react_u = u_val - u_val * u_val * u_val * third - v_val + r.stim[i];
+            double react_v = (u_val + k.a[m] - k.b[m] * v_val) * k.inv_c[m];
+
+            r.u_out[i] = u_val + k.dt * (k.du[m] * lap_u + react_u);
+            r.v_out[i] = v_val + k.dt * (k.dv[m] * lap_v + react_v);
+        }
+    }
+}
+
+void laplacianRowScalar(const double* up, const double* row, const double* down,
+                        double coeff, double* out, int x_begin, int x_end) {
+    for (int x = x_begin; x < x_end; ++x) {
+        double laplacian = up[x] + down[x] + row[x-1] + row[x+1] - 4.0 * row[x];
+        out[x] = coeff * laplacian;
+    }
+}
+
+// Diagonal = false is the 5-point form: only the east and south weights are read
+template <bool Diagonal>
+void ninePointRowScalar(const NinePointRowPointers& r, int x_begin, int x_end) {
+    for (int x = x_begin; x < x_end; ++x) {
+        double center = r.row[x];
+        double sum = r.east[x] * (r.row[x+1] - center) + r.east[x-1] * (r.row[x-1] - center);
+        sum += r.south[x] * (r.down[x] - center) + r.south_up[x] * (r.up[x] - center);
+        if (Diagonal) {
+            sum += r.south_east[x] * (r.down[x+1] - center) + r.south_east_up[x-1] * (r.up[x-1] - center);
+            sum += r.north_east[x] * (r.up[x+1] - center) + r.north_east_down[x-1] * (r.down[x-1] - center);
+        }
+        r.out[x] = sum;
+    }
+}
+
+// Membrane kernels: currents at the evaluation state, then an update of V, the
+// gates and Cai. Callers pass only excitable spans, so no cell is masked.
+
+// Conductance positions in the tissue tables and scale rows (the models' Current order)
+enum LuoRudyConductance { kLRNa, kLRCaL, kLRK, kLRK1, kLRb, kLRCaT };
+enum TenTusscherConductance { kTTNa, kTTCaL, kTTKr, kTTKs, kTTK1, kTTto, kTTNaCa, kTTNaK };
+
+constexpr int kLuoRudyStride = static_cast<int>(std::tuple_size<LuoRudyConductances>::value);
+constexpr int kTenTusscherStride = static_cast<int>(std::tuple_size<TenTusscherConductances>::value);
+
+inline double scaledConductance(double g, const double* scale, int x) {
+    return scale ? g * scale[x] : g;
+}
+
+inline double advanceGateScalar(const GateRowPointers& g, int x, double dt) {
+    double value = g.value[x];
+    double drift = g.alpha[x] * (1 - value) - g.beta[x] * value;
+    return value + (g.step ? g.step[x] : dt) * drift;
+}
+
+inline double clampCalcium(double Cai) {
+    return std::max(0.0001, std::min(0.01, Cai));
+}
+
+// The scalar membrane kernels keep the models' original order of operations
+void luoRudyRowScalar(const LuoRudyRowPointers& r, int x_begin, int x_end, const LuoRudyCoefficients& k) {
+    const auto& t = r.tissue;
+    for (int x = x_begin; x < x_end; ++x) {
+        const LuoRudyConductances& g = k.tissue[t.tissue_class ? t.tissue_class[x] : 0];
+        double V = r.V_eval[x];
+        double m = r.m.eval[x];
+        double I_Na = scaledConductance(g[kLRNa], t.scale[kLRNa], x) * m * m * m * r.h.eval[x] * k.j * (V - 54.4);
+        double I_CaL = scaledConductance(g[kLRCaL], t.scale[kLRCaL], x) * (V - 130.0);
+        double I_K = scaledConductance(g[kLRK], t.scale[kLRK], x) * r.xr.eval[x] * k.xs * (V + 77.0);
+        double I_K1 = scaledConductance(g[kLRK1], t.scale[kLRK1], x) * (V + 77.0) / r.k1_denominator[x];
+        double I_b = scaledConductance(g[kLRb], t.scale[kLRb], x) * (V + 59.87);
+        double I_CaT = scaledConductance(g[kLRCaT], t.scale[kLRCaT], x) * (V - 130.0);
+        double I_total = I_Na + I_CaL + I_K + I_K1 + I_b + I_CaT;
+
+        double dV = (r.diffusion[x] - I_total) * k.dt;
+        double Cai_new = clampCalcium(r.Cai[x] + k.dt * 0.001 * (-I_CaL - 0.0001 * r.Cai[x]));
+        double m_new = advanceGateScalar(r.m, x, k.dt);
+        double h_new = advanceGateScalar(r.h, x, k.dt);
+        double xr_new = advanceGateScalar(r.xr, x, k.dt);
+
+        r.V_out[x] = r.V[x] + dV;
+        r.m.out[x] = m_new;
+        r.h.out[x] = h_new;
+        r.xr.out[x] = xr_new;
+        r.Cai_out[x] = Cai_new;
+    }
+}
+
+void tenTusscherRowScalar(const TenTusscherRowPointers& r, int x_begin, int x_end,
+                          const TenTusscherCoefficients& k) {
+    const auto& t = r.tissue;
+    for (int x = x_begin; x < x_end; ++x) {
+        const TenTusscherConductances& g = k.tissue[t.tissue_class ? t.tissue_class[x] : 0];
+        double V = r.V_eval[x];
+        double m = r.m.eval[x];
+        double Cai = r.Cai_eval[x];
+        double I_Na = scaledConductance(g[kTTNa], t.scale[kTTNa], x) * m * m * m * k.h * k.j * (V - 54.4);
+        double I_CaL = scaledConductance(g[kTTCaL], t.scale[kTTCaL], x) * (V - 130.0);
+        double I_Kr = scaledConductance(g[kTTKr], t.scale[kTTKr], x) * r.u.eval[x] * (V + 77.0);
+        double I_Ks = scaledConductance(g[kTTKs], t.scale[kTTKs], x) * (V + 77.0);
+        double I_K1 = scaledConductance(g[kTTK1], t.scale[kTTK1], x) * (V + 77.0) / r.k1_denominator[x];
+        double I_to = scaledConductance(g[kTTto], t.scale[kTTto], x) * (V + 77.0);
+        double I_NaCa = scaledConductance(g[kTTNaCa], t.scale[kTTNaCa], x) *
+                        (r.naca_exp_plus[x] * k.Nai * k.Nai * k.Nai * Cai - r.naca_exp_minus[x] * 1.4) /
+                        (1 + 0.1 * r.naca_exp_minus[x]);
+        double I_NaK = scaledConductance(g[kTTNaK], t.scale[kTTNaK], x);
+        double I_total = I_Na + I_CaL + I_Kr + I_Ks + I_K1 + I_to + I_NaCa + I_NaK;
+
+        double dV = (r.diffusion[x] - I_total) * k.dt;
+        double Cai_new = clampCalcium(r.Cai[x] + k.dt * 0.001 * (-I_CaL - 0.0001 * Cai));
+        double m_new = advanceGateScalar(r.m, x, k.dt);
+        double u_new = advanceGateScalar(r.u, x, k.dt);
+
+        r.V_out[x] = r.V[x] + dV;
+        r.m.out[x] = m_new;
+        r.u.out[x] = u_new;
+        r.Cai_out[x] = Cai_new;
+    }
+}
+
+#ifdef MI_SIMD_X86
+
+// Widest vector (16 floats) handled by the padded tail buffers
+constexpr int kMaxLanes = 16;
+
+// Vector kernels finish a row by running the remaining (< lanes) cells through
+// the same vector code on a zero-padded copy. Every cell then takes the same
+// arithmetic path wherever a row is split, which keeps tiled and untiled
+// sweeps bit-identical.
+
+template <typename T>
+void fhnRowTail(FHNRowFn<T> kernel, int lanes, const FHNRowPointers<T>& r,
+                int x, int x_end, const FHNCoefficients<T>& k) {
+    int n = x_end - x;
+    if (n <= 0) {
+        return;
+    }
+
+    // Index i + 1 of every buffer holds column x + i
+    T u_up[kMaxLanes + 2] = {}, u_row[kMaxLanes + 2] = {}, u_down[kMaxLanes + 2] = {};
+    T v_up[kMaxLanes + 2] = {}, v_row[kMaxLanes + 2] = {}, v_down[kMaxLanes + 2] = {};
+    T stim[kMaxLanes + 2] = {}, u_out[kMaxLanes + 2] = {}, v_out[kMaxLanes + 2] = {};
+
+    u_row[0] = r.u_row[x - 1];
+    v_row[0] = r.v_row[x - 1];
+    for (int i = 0; i <= n; ++i) {
+        u_row[i + 1] = r.u_row[x + i];
+        v_row[i + 1] = r.v_row[x + i];
+    }
+    for (int i = 0; i < n; ++i) {
+        u_up[i + 1] = r.u_up[x + i];
+        u_down[i + 1] = r.u_down[x + i];
+        v_up[i + 1] = r.v_up[x + i];
+        v_down[i + 1] = r.v_down[x + i];
+        stim[i + 1] = r.stim[x + i];
+    }
+
+    FHNRowPointers<T> padded = {u_up, u_row, u_down, v_up, v_row, v_down, stim, u_out, v_out};
+    kernel(padded, 1, 1 + lanes, k);
+
+    for (int i = 0; i < n; ++i) {
+        r.u_out[x + i] = u_out[i + 1];
+        r.v_out[x + i] = v_out[i + 1];
+    }
+}
+
+void laplacianRowTail(LaplacianRowFn kernel, int lanes, const double* up, const double* row,
+                      const double* down, double coeff, double* out, int x, int x_end) {
+    int n = x_end - x;
+    if (n <= 0) {
+        return;
+    }
+
+    double up_buf[kMaxLanes + 2] = {}, row_buf[kMaxLanes + 2] = {};
+    double down_buf[kMaxLanes + 2] = {}, out_buf[kMaxLanes + 2] = {};
+
+    row_buf[0] = row[x - 1];
+    for (int i = 0; i <= n; ++i) {
+        row_buf[i + 1] = row[x + i];
+    }
+    for (int i = 0; i < n; ++i) {
+        up_buf[i + 1] = up[x + i];
+        down_buf[i + 1] = down[x + i];
+    }
+
+    kernel(up_buf, row_buf, down_buf, coeff, out_buf, 1, 1 + lanes);
+
+    for (int i = 0; i < n; ++i) {
+        out[x + i] = out_buf[i + 1];
+    }
+}
+
+void ninePointRowTail(NinePointRowFn kernel, int lanes, const NinePointRowPointers& r, int x, int x_end) {
+    int n = x_end - x;
+    if (n <= 0) {
+        return;
+    }
+
+    // Index i + 1 of every buffer holds column x + i; columns x - 1 .. x_end are in the row.
+    // Absent (5-point) diagonal rows stay absent.
+    double buffers[10][kMaxLanes + 2] = {};
+    const double* sources[10] = {r.up, r.row, r.down, r.east, r.south_up, r.south,
+                                 r.south_east_up, r.south_east, r.north_east, r.north_east_down};
+    const double* padded_rows[10] = {};
+    for (int b = 0; b < 10; ++b) {
+        if (sources[b]) {
+            std::copy(sources[b] + x - 1, sources[b] + x_end + 1, buffers[b]);
+            padded_rows[b] = buffers[b];
+        }
+    }
+    double out[kMaxLanes + 2] = {};
+
+    NinePointRowPointers padded = {padded_rows[0], padded_rows[1], padded_rows[2], padded_rows[3],
+                                   padded_rows[4], padded_rows[5], padded_rows[6], padded_rows[7],
+                                   padded_rows[8], padded_rows[9], out};
+    kernel(padded, 1, 1 + lanes);
+
+    for (int i = 0; i < n; ++i) {
+        r.out[x + i] = out[i + 1];
+    }
+}
+
+// Padded copy of one gate's rows for the membrane tails
+struct GateTailBuffers {
+    double eval[kMaxLanes] = {}, value[kMaxLanes] = {}, alpha[kMaxLanes] = {}, beta[kMaxLanes] = {};
+    double step[kMaxLanes] = {}, out[kMaxLanes] = {};
+
+    GateRowPointers load(const GateRowPointers& g, int x, int n) {
+        for (int i = 0; i < n; ++i) {
+            eval[i] = g.eval[x + i];
+            value[i] = g.value[x + i];
+            alpha[i] = g.alpha[x + i];
+            beta[i] = g.beta[x + i];
+            if (g.step) {
+                step[i] = g.step[x + i];
+            }
+        }
+        return {eval, value, alpha, beta, g.step ? step : nullptr, out};
+    }
+
+    void store(const GateRowPointers& g, int x, int n) const {
+        for (int i = 0; i < n; ++i) {
+            g.out[x + i] = out[i];
+        }
+    }
+};
+
+// Padded copy of the tissue rows for the membrane tails; padding lanes use class 0
+template <int Count>
+struct TissueTailBuffers {
+    unsigned char tissue_class[kMaxLanes] = {};
+    double scale[Count][kMaxLanes] = {};
+
+    TissueRowPointers<Count> load(const TissueRowPointers<Count>& t, int x, int n) {
+        TissueRowPointers<Count> padded = {t.tissue_class ? tissue_class : nullptr, {}};
+        for (int i = 0; i < n && t.tissue_class; ++i) {
+            tissue_class[i] = t.tissue_class[x + i];
+        }
+        for (int c = 0; c < Count; ++c) {
+            if (t.scale[c]) {
+                std::copy(t.scale[c] + x, t.scale[c] + x + n, scale[c]);
+                padded.scale[c] = scale[c];
+            }
+        }
+        return padded;
+    }
+};
+
+// Padding lanes see unit denominators and are discarded
+void luoRudyRowTail(LuoRudyRowFn kernel, int lanes, const LuoRudyRowPointers& r,
+                    int x, int x_end, const LuoRudyCoefficients& k) {
+    int n = x_end - x;
+    if (n <= 0) {
+        return;
+    }
+
+    double V_eval[kMaxLanes] = {}, V[kMaxLanes] = {}, diffusion[kMaxLanes] = {}, Cai[kMaxLanes] = {};
+    double k1_denominator[kMaxLanes], V_out[kMaxLanes] = {}, Cai_out[kMaxLanes] = {};
+    std::fill(k1_denominator, k1_denominator + kMaxLanes, 1.0);
+    for (int i = 0; i < n; ++i) {
+        V_eval[i] = r.V_eval[x + i];
+        V[i] = r.V[x + i];
+        diffusion[i] = r.diffusion[x + i];
+        k1_denominator[i] = r.k1_denominator[x + i];
+        Cai[i] = r.Cai[x + i];
+    }
+    GateTailBuffers m, h, xr;
+    TissueTailBuffers<kLuoRudyStride> tissue;
+
+    LuoRudyRowPointers padded = {V_eval, V, diffusion, k1_denominator, Cai, V_out, Cai_out,
+                                 m.load(r.m, x, n), h.load(r.h, x, n), xr.load(r.xr, x, n),
+                                 tissue.load(r.tissue, x, n)};
+    kernel(padded, 0, lanes, k);
+
+    for (int i = 0; i < n; ++i) {
+        r.V_out[x + i] = V_out[i];
+        r.Cai_out[x + i] = Cai_out[i];
+    }
+    m.store(r.m, x, n);
+    h.store(r.h, x, n);
+    xr.store(r.xr, x, n);
+}
+
+void tenTusscherRowTail(TenTusscherRowFn kernel, int lanes, const TenTusscherRowPointers& r,
+                        int x, int x_end, const TenTusscherCoefficients& k) {
+    int n = x_end - x;
+    if (n <= 0) {
+        return;
+    }
+
+    double V_eval[kMaxLanes] = {}, V[kMaxLanes] = {}, diffusion[kMaxLanes] = {};
+    double k1_denominator[kMaxLanes], exp_plus[kMaxLanes] = {}, exp_minus[kMaxLanes] = {};
+    double Cai_eval[kMaxLanes] = {}, Cai[kMaxLanes] = {}, V_out[kMaxLanes] = {}, Cai_out[kMaxLanes] = {};
+    std::fill(k1_denominator, k1_denominator + kMaxLanes, 1.0);
+    for (int i = 0; i < n; ++i) {
+        V_eval[i] = r.V_eval[x + i];
+        V[i] = r.V[x + i];
+        diffusion[i] = r.diffusion[x + i];
+        k1_denominator[i] = r.k1_denominator[x + i];
+        exp_plus[i] = r.naca_exp_plus[x + i];
+        exp_minus[i] = r.naca_exp_minus[x + i];
+        Cai_eval[i] = r.Cai_eval[x + i];
+        Cai[i] = r.Cai[x + i];
+    }
+    GateTailBuffers m, u;
+    TissueTailBuffers<kTenTusscherStride> tissue;
+
+    TenTusscherRowPointers padded = {V_eval, V, diffusion, k1_denominator, exp_plus, exp_minus, Cai_eval, Cai,
+                                     V_out, Cai_out, m.load(r.m, x, n), u.load(r.u, x, n),
+                                     tissue.load(r.tissue, x, n)};
+    kernel(padded, 0, lanes, k);
+
+    for (int i = 0; i < n; ++i) {
+        r.V_out[x + i] = V_out[i];
+        r.Cai_out[x + i] = Cai_out[i];
+    }
+    m.store(r.m, x, n);
+    u.store(r.u, x, n);
+}
+
+// The vector kernels multiply by reciprocals instead of dividing by 3 and c;
+// results agree with the scalar kernel to rounding.
+
+// SSE2 kernels (2 doubles or 4 floats per register); SSE2 is part of the x86-64 baseline
+
+__attribute__((target("sse2")))
+void fhnRowSSE2(const FHNRowPointers<double>& r, int x_begin, int x_end, const FHNCoefficients<double>& k) {
+    const __m128d dt = _mm_set1_pd(k.dt);
+    const __m128d du = _mm_set1_pd(k.du);
+    const __m128d dv = _mm_set1_pd(k.dv);
+    const __m128d a = _mm_set1_pd(k.a);
+    const __m128d b = _mm_set1_pd(k.b);
+    const __m128d inv_c = _mm_set1_pd(1.0 / k.c);
+    const __m128d third = _mm_set1_pd(1.0 / 3.0);
+    const __m128d four = _mm_set1_pd(4.0);
+
+    int x = x_begin;
+    for (; x + 2 <= x_end; x += 2) {
+        __m128d u = _mm_loadu_pd(r.u_row + x);
+        __m128d v = _mm_loadu_pd(r.v_row + x);
+
+        __m128d lap_u = _mm_add_pd(_mm_add_pd(_mm_loadu_pd(r.u_up + x), _mm_loadu_pd(r.u_down + x)),
+                                   _mm_add_pd(_mm_loadu_pd(r.u_row + x - 1), _mm_loadu_pd(r.u_row + x + 1)));
+        lap_u = _mm_sub_pd(lap_u, _mm_mul_pd(four, u));
+        __m128d lap_v = _mm_add_pd(_mm_add_pd(_mm_loadu_pd(r.v_up + x), _mm_loadu_pd(r.v_down + x)),
+                                   _mm_add_pd(_mm_loadu_pd(r.v_row + x - 1), _mm_loadu_pd(r.v_row + x + 1)));
+        lap_v = _mm_sub_pd(lap_v, _mm_mul_pd(four, v));
+
+        __m128d cube = _mm_mul_pd(_mm_mul_pd(_mm_mul_pd(u, u), u), third);
+        __m128d react_u = _mm_add_pd(_mm_sub_pd(_mm_sub_pd(u, cube), v), _mm_loadu_pd(r.stim + x));
+        __m128d react_v = _mm_mul_pd(_mm_sub_pd(_mm_add_pd(u, a), _mm_mul_pd(b, v)), inv_c);
+
+        __m128d du_dt = _mm_add_pd(_mm_mul_pd(du, lap_u), react_u);
+        __m128d dv_dt = _mm_add_pd(_mm_mul_pd(dv, lap_v), react_v);
+        _mm_storeu_pd(r.u_out + x, _mm_add_pd(u, _mm_mul_pd(dt, du_dt)));
+        _mm_storeu_pd(r.v_out + x, _mm_add_pd(v, _mm_mul_pd(dt, dv_dt)));
+    }
+    fhnRowTail(fhnRowSSE2, 2, r, x, x_end, k);
+}
+
+__attribute__((target("sse2")))
+void fhnRowSSE2Float(const FHNRowPointers<float>& r, int x_begin, int x_end, const FHNCoefficients<float>& k) {
+    const __m128 dt = _mm_set1_ps(k.dt);
+    const __m128 du = _mm_set1_ps(k.du);
+    const __m128 dv = _mm_set1_ps(k.dv);
+    const __m128 a = _mm_set1_ps(k.a);
+    const __m128 b = _mm_set1_ps(k.b);
+    const __m128 inv_c = _mm_set1_ps(1.0f / k.c);
+    const __m128 third = _mm_set1_ps(1.0f / 3.0f);
+    const __m128 four = _mm_set1_ps(4.0f);
+
+    int x = x_begin;
+    for (; x + 4 <= x_end; x += 4) {
+        __m128 u = _mm_loadu_ps(r.u_row + x);
+        __m128 v = _mm_loadu_ps(r.v_row + x);
+
+        __m128 lap_u = _mm_add_ps(_mm_add_ps(_mm_loadu_ps(r.u_up + x), _mm_loadu_ps(r.u_down + x)),
+                                  _mm_add_ps(_mm_loadu_ps(r.u_row + x - 1), _mm_loadu_ps(r.u_row + x + 1)));
+        lap_u = _mm_sub_ps(lap_u, _mm_mul_ps(four, u));
+        __m128 lap_v = _mm_add_ps(_mm_add_ps(_mm_loadu_ps(r.v_up + x), _mm_loadu_ps(r.v_down + x)),
+                                  _mm_add_ps(_mm_loadu_ps(r.v_row + x - 1), _mm_loadu_ps(r.v_row + x + 1)));
+        lap_v = _mm_sub_ps(lap_v, _mm_mul_ps(four, v));
+
+        __m128 cube = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(u, u), u), third);
+        __m128 react_u = _mm_add_ps(_mm_sub_ps(_mm_sub_ps(u, cube), v), _mm_loadu_ps(r.stim + x));
+        __m128 react_v = _mm_mul_ps(_mm_sub_ps(_mm_add_ps(u, a), _mm_mul_ps(b, v)), inv_c);
+
+        __m128 du_dt = _mm_add_ps(_mm_mul_ps(du, lap_u), react_u);
+        __m128 dv_dt = _mm_add_ps(_mm_mul_ps(dv, lap_v), react_v);
+        _mm_storeu_ps(r.u_out + x, _mm_add_ps(u, _mm_mul_ps(dt, du_dt)));
+        _mm_storeu_ps(r.v_out + x, _mm_add_ps(v, _mm_mul_ps(dt, dv_dt)));
+    }
+    fhnRowTail(fhnRowSSE2Float, 4, r, x, x_end, k);
+}
+
+__attribute__((target("sse2")))
+void fhnRow7SSE2(const FHNRowPointers3D& r3, int x_begin, int x_end, const FHNCoefficients<double>& k) {
+    const FHNRowPointers<double>& r = r3.plane;
+    const __m128d dt = _mm_set1_pd(k.dt);
+    const __m128d du = _mm_set1_pd(k.du);
+    const __m128d dv = _mm_set1_pd(k.dv);
+    const __m128d a = _mm_set1_pd(k.a);
+    const __m128d b = _mm_set1_pd(k.b);
+    const __m128d inv_c = _mm_set1_pd(1.0 / k.c);
+    const __m128d third = _mm_set1_pd(1.0 / 3.0);
+    const __m128d six = _mm_set1_pd(6.0);
+
+    int x = x_begin;
+    for (; x + 2 <= x_end; x += 2) {
+        __m128d u = _mm_loadu_pd(r.u_row + x);
+        __m128d v = _mm_loadu_pd(r.v_row + x);
+
+        __m128d lap_u = _mm_add_pd(_mm_add_pd(_mm_loadu_pd(r.u_up + x), _mm_loadu_pd(r.u_down + x)),
+                                   _mm_add_pd(_mm_loadu_pd(r.u_row + x - 1), _mm_loadu_pd(r.u_row + x + 1)));
+        lap_u = _mm_add_pd(lap_u, _mm_add_pd(_mm_loadu_pd(r3.u_front + x), _mm_loadu_pd(r3.u_back + x)));
+        lap_u = _mm_sub_pd(lap_u, _mm_mul_pd(six, u));
+        __m128d lap_v = _mm_add_pd(_mm_add_pd(_mm_loadu_pd(r.v_up + x), _mm_loadu_pd(r.v_down + x)),
+                                   _mm_add_pd(_mm_loadu_pd(r.v_row + x - 1), _mm_loadu_pd(r.v_row + x + 1)));
+        lap_v = _mm_add_pd(lap_v, _mm_add_pd(_mm_loadu_pd(r3.v_front + x), _mm_loadu_pd(r3.v_back + x)));
+        lap_v = _mm_sub_pd(lap_v, _mm_mul_pd(six, v));
+
+        __m128d cube = _mm_mul_pd(_mm_mul_pd(_mm_mul_pd(u, u), u), third);
+        __m128d react_u = _mm_add_pd(_mm_sub_pd(_mm_sub_pd(u, cube), v), _mm_loadu_pd(r.stim + x));
+        __m128d react_v = _mm_mul_pd(_mm_sub_pd(_mm_add_pd(u, a), _mm_mul_pd(b, v)), inv_c);
+
+        __m128d du_dt = _mm_add_pd(_mm_mul_pd(du, lap_u), react_u);
+        __m128d dv_dt = _mm_add_pd(_mm_mul_pd(dv, lap_v), react_v);
+        _mm_storeu_pd(r.u_out + x, _mm_add_pd(u, _mm_mul_pd(dt, du_dt)));
+        _mm_storeu_pd(r.v_out + x, _mm_add_pd(v, _mm_mul_pd(dt, dv_dt)));
+    }
+    fhnRow7Scalar(r3, x, x_end, k);
+}
+
+__attribute__((target("sse2")))
+void fhnEnsembleRowSSE2(const FHNRowPointers<double>& r, int x_begin, int x_end, int members,
+                        const FHNEnsembleCoefficients& k) {
+    const __m128d dt = _mm_set1_pd(k.dt);
+    const __m128d third = _mm_set1_pd(1.0 / 3.0);
+    const __m128d four = _mm_set1_pd(4.0);
+
+    for (int x = x_begin; x < x_end; ++x) {
+        const std::ptrdiff_t cell = static_cast<std::ptrdiff_t>(x) * members;
+        for (int m = 0; m < members; m += 2) {
+            const std::ptrdiff_t i = cell + m;
+            __m128d u = _mm_loadu_pd(r.u_row + i);
+            __m128d v = _mm_loadu_pd(r.v_row + i);
+
+            __m128d lap_u = _mm_add_pd(_mm_add_pd(_mm_loadu_pd(r.u_up + i), _mm_loadu_pd(r.u_down + i)),
+                                       _mm_add_pd(_mm_loadu_pd(r.u_row + i - members), _mm_loadu_pd(r.u_row + i + members)));
+            lap_u = _mm_sub_pd(lap_u, _mm_mul_pd(four, u));
+            __m128d lap_v = _mm_add_pd(_mm_add_pd(_mm_loadu_pd(r.v_up + i), _mm_loadu_pd(r.v_down + i)),
+                                       _mm_add_pd(_mm_loadu_pd(r.v_row + i - members), _mm_loadu_pd(r.v_row + i + members)));
+            lap_v = _mm_sub_pd(lap_v, _mm_mul_pd(four, v));
+
+            __m128d cube = _mm_mul_pd(_mm_mul_pd(_mm_mul_pd(u, u), u), third);
+            __m128d react_u = _mm_add_pd(_mm_sub_pd(_mm_sub_pd(u, cube), v), _mm_loadu_pd(r.stim + i));
+            __m128d react_v = _mm_mul_pd(_mm_sub_pd(_mm_add_pd(u, _mm_loadu_pd(k.a + m)),
+                                                    _mm_mul_pd(_mm_loadu_pd(k.b + m), v)),
+                                         _mm_loadu_pd(k.inv_c + m));
+
+            __m128d du_dt = _mm_add_pd(_mm_mul_pd(_mm_loadu_pd(k.du + m), lap_u), react_u);
+            __m128d dv_dt = _mm_add_pd(_mm_mul_pd(_mm_loadu_pd(k.dv + m), lap_v), react_v);
+            _mm_storeu_pd(r.u_out + i, _mm_add_pd(u, _mm_mul_pd(dt, du_dt)));
+            _mm_storeu_pd(r.v_out + i, _mm_add_pd(v, _mm_mul_pd(dt, dv_dt)));
+        }
+    }
+}
+
+__attribute__((target("sse2")))
+void laplacianRowSSE2(const double* up, const double* row, const double* down,
+                      double coeff, double* out, int x_begin, int x_end) {
+    const __m128d scale = _mm_set1_pd(coeff);
+    const __m128d four = _mm_set1_pd(4.0);
+
+    int x = x_begin;
+    for (; x + 2 <= x_end; x += 2) {
+        __m128d center = _mm_loadu_pd(row + x);
+        __m128d sum = _mm_add_pd(_mm_add_pd(_mm_loadu_pd(up + x), _mm_loadu_pd(down + x)),
+                                 _mm_add_pd(_mm_loadu_pd(row + x - 1), _mm_loadu_pd(row + x + 1)));
+        _mm_storeu_pd(out + x, _mm_mul_pd(scale, _mm_sub_pd(sum, _mm_mul_pd(four, center))));
+    }
+    laplacianRowTail(laplacianRowSSE2, 2, up, row, down, coeff, out, x, x_end);
+}
+
+// weight * (neighbour - center)
+__attribute__((target("sse2")))
+inline __m128d couplingSSE2(const double* weight, const double* neighbour, __m128d center) {
+    return _mm_mul_pd(_mm_loadu_pd(weight), _mm_sub_pd(_mm_loadu_pd(neighbour), center));
+}
+
+template <bool Diagonal>
+__attribute__((target("sse2")))
+void ninePointRowSSE2(const NinePointRowPointers& r, int x_begin, int x_end) {
+    int x = x_begin;
+    for (; x + 2 <= x_end; x += 2) {
+        __m128d center = _mm_loadu_pd(r.row + x);
+        __m128d sum = _mm_add_pd(couplingSSE2(r.east + x, r.row + x + 1, center),
+                                 couplingSSE2(r.east + x - 1, r.row + x - 1, center));
+        sum = _mm_add_pd(sum, _mm_add_pd(couplingSSE2(r.south + x, r.down + x, center),
+                                         couplingSSE2(r.south_up + x, r.up + x, center)));
+        if (Diagonal) {
+            sum = _mm_add_pd(sum, _mm_add_pd(couplingSSE2(r.south_east + x, r.down + x + 1, center),
+                                             couplingSSE2(r.south_east_up + x - 1, r.up + x - 1, center)));
+            sum = _mm_add_pd(sum, _mm_add_pd(couplingSSE2(r.north_east + x, r.up + x + 1, center),
+                                             couplingSSE2(r.north_east_down + x - 1, r.down + x - 1, center)));
+        }
+        _mm_storeu_pd(r.out + x, sum);
+    }
+    ninePointRowTail(ninePointRowSSE2<Diagonal>, 2, r, x, x_end);
+}
+
+// Conductance c of cells x, x + 1 from their tissue classes' table entries
+template <int Count>
+__attribute__((target("sse2")))
+inline __m128d conductanceSSE2(const double* table, const TissueRowPointers<Count>& t, int c, int x) {
+    const double* field = table + c;
+    __m128d g = t.tissue_class ? _mm_set_pd(field[t.tissue_class[x + 1] * Count], field[t.tissue_class[x] * Count])
+                               : _mm_set1_pd(field[0]);
+    return t.scale[c] ? _mm_mul_pd(g, _mm_loadu_pd(t.scale[c] + x)) : g;
+}
+
+__attribute__((target("sse2")))
+inline void advanceGateSSE2(const GateRowPointers& g, int x, __m128d dt) {
+    __m128d value = _mm_loadu_pd(g.value + x);
+    __m128d drift = _mm_sub_pd(_mm_mul_pd(_mm_loadu_pd(g.alpha + x), _mm_sub_pd(_mm_set1_pd(1.0), value)),
+                               _mm_mul_pd(_mm_loadu_pd(g.beta + x), value));
+    __m128d step = g.step ? _mm_loadu_pd(g.step + x) : dt;
+    _mm_storeu_pd(g.out + x, _mm_add_pd(value, _mm_mul_pd(step, drift)));
+}
+
+__attribute__((target("sse2")))
+void luoRudyRowSSE2(const LuoRudyRowPointers& r, int x_begin, int x_end, const LuoRudyCoefficients& k) {
+    const auto& t = r.tissue;
+    const double* table = k.tissue[0].data();
+    const __m128d dt = _mm_set1_pd(k.dt);
+    const __m128d calcium_dt = _mm_set1_pd(k.dt * 0.001);
+    const __m128d j = _mm_set1_pd(k.j);
+    const __m128d xs = _mm_set1_pd(k.xs);
+    const __m128d e_na = _mm_set1_pd(54.4);
+    const __m128d e_ca = _mm_set1_pd(130.0);
+    const __m128d e_k = _mm_set1_pd(-77.0);
+    const __m128d e_b = _mm_set1_pd(-59.87);
+    const __m128d leak = _mm_set1_pd(0.0001);
+    const __m128d cai_min = _mm_set1_pd(0.0001);
+    const __m128d cai_max = _mm_set1_pd(0.01);
+
+    int x = x_begin;
+    for (; x + 2 <= x_end; x += 2) {
+        // Currents at the evaluation state (loaded before any output aliasing it is stored)
+        __m128d V = _mm_loadu_pd(r.V_eval + x);
+        __m128d m = _mm_loadu_pd(r.m.eval + x);
+        __m128d V_ca = _mm_sub_pd(V, e_ca);
+        __m128d V_k = _mm_sub_pd(V, e_k);
+        __m128d g_na = _mm_mul_pd(conductanceSSE2(table, t, kLRNa, x), j);
+        __m128d I_Na = _mm_mul_pd(_mm_mul_pd(_mm_mul_pd(g_na, _mm_mul_pd(m, _mm_mul_pd(m, m))),
+                                             _mm_loadu_pd(r.h.eval + x)),
+                                  _mm_sub_pd(V, e_na));
+        __m128d I_CaL = _mm_mul_pd(conductanceSSE2(table, t, kLRCaL, x), V_ca);
+        __m128d g_k = _mm_mul_pd(conductanceSSE2(table, t, kLRK, x), xs);
+        __m128d I_K = _mm_mul_pd(_mm_mul_pd(g_k, _mm_loadu_pd(r.xr.eval + x)), V_k);
+        __m128d I_K1 = _mm_div_pd(_mm_mul_pd(conductanceSSE2(table, t, kLRK1, x), V_k),
+                                  _mm_loadu_pd(r.k1_denominator + x));
+        __m128d I_total = _mm_add_pd(_mm_add_pd(I_Na, I_CaL), _mm_add_pd(I_K, I_K1));
+        I_total = _mm_add_pd(I_total, _mm_mul_pd(conductanceSSE2(table, t, kLRb, x), _mm_sub_pd(V, e_b)));
+        I_total = _mm_add_pd(I_total, _mm_mul_pd(conductanceSSE2(table, t, kLRCaT, x), V_ca));
+
+        __m128d V_old = _mm_loadu_pd(r.V + x);
+        __m128d V_new = _mm_add_pd(V_old, _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(r.diffusion + x), I_total), dt));
+        __m128d Cai = _mm_loadu_pd(r.Cai + x);
+        __m128d Cai_new = _mm_sub_pd(Cai, _mm_mul_pd(calcium_dt, _mm_add_pd(I_CaL, _mm_mul_pd(leak, Cai))));
+        Cai_new = _mm_max_pd(_mm_min_pd(Cai_new, cai_max), cai_min);
+
+        advanceGateSSE2(r.m, x, dt);
+        advanceGateSSE2(r.h, x, dt);
+        advanceGateSSE2(r.xr, x, dt);
+        _mm_storeu_pd(r.V_out + x, V_new);
+        _mm_storeu_pd(r.Cai_out + x, Cai_new);
+    }
+    luoRudyRowTail(luoRudyRowSSE2, 2, r, x, x_end, k);
+}
+
+__attribute__((target("sse2")))
+void tenTusscherRowSSE2(const TenTusscherRowPointers& r, int x_begin, int x_end,
+                        const TenTusscherCoefficients& k) {
+    const auto& t = r.tissue;
+    const double* table = k.tissue[0].data();
+    const __m128d dt = _mm_set1_pd(k.dt);
+    const __m128d calcium_dt = _mm_set1_pd(k.dt * 0.001);
+    const __m128d hj = _mm_set1_pd(k.h * k.j);
+    const __m128d nai3 = _mm_set1_pd(k.Nai * k.Nai * k.Nai);
+    const __m128d e_na = _mm_set1_pd(54.4);
+    const __m128d e_ca = _mm_set1_pd(130.0);
+    const __m128d e_k = _mm_set1_pd(-77.0);
+    const __m128d ca_o = _mm_set1_pd(1.4);
+    const __m128d sat = _mm_set1_pd(0.1);
+    const __m128d one = _mm_set1_pd(1.0);
+    const __m128d leak = _mm_set1_pd(0.0001);
+    const __m128d cai_min = _mm_set1_pd(0.0001);
+    const __m128d cai_max = _mm_set1_pd(0.01);
+
+    int x = x_begin;
+    for (; x + 2 <= x_end; x += 2) {
+        __m128d V = _mm_loadu_pd(r.V_eval + x);
+        __m128d m = _mm_loadu_pd(r.m.eval + x);
+        __m128d Cai_eval = _mm_loadu_pd(r.Cai_eval + x);
+        __m128d g_na = _mm_mul_pd(conductanceSSE2(table, t, kTTNa, x), hj);
+        __m128d I_Na = _mm_mul_pd(_mm_mul_pd(g_na, _mm_mul_pd(m, _mm_mul_pd(m, m))), _mm_sub_pd(V, e_na));
+        __m128d I_CaL = _mm_mul_pd(conductanceSSE2(table, t, kTTCaL, x), _mm_sub_pd(V, e_ca));
+        __m128d V_k = _mm_sub_pd(V, e_k);
+        __m128d g_k = _mm_add_pd(conductanceSSE2(table, t, kTTKs, x), conductanceSSE2(table, t, kTTto, x));
+        g_k = _mm_add_pd(_mm_mul_pd(conductanceSSE2(table, t, kTTKr, x), _mm_loadu_pd(r.u.eval + x)), g_k);
+        __m128d I_K = _mm_mul_pd(g_k, V_k);
+        __m128d I_K1 = _mm_div_pd(_mm_mul_pd(conductanceSSE2(table, t, kTTK1, x), V_k),
+                                  _mm_loadu_pd(r.k1_denominator + x));
+        __m128d exp_minus = _mm_loadu_pd(r.naca_exp_minus + x);
+        __m128d naca = _mm_sub_pd(_mm_mul_pd(_mm_mul_pd(_mm_loadu_pd(r.naca_exp_plus + x), nai3), Cai_eval),
+                                  _mm_mul_pd(exp_minus, ca_o));
+        __m128d I_NaCa = _mm_div_pd(_mm_mul_pd(conductanceSSE2(table, t, kTTNaCa, x), naca),
+                                    _mm_add_pd(one, _mm_mul_pd(sat, exp_minus)));
+        __m128d I_total = _mm_add_pd(_mm_add_pd(I_Na, I_CaL), _mm_add_pd(I_K, I_K1));
+        I_total = _mm_add_pd(I_total, _mm_add_pd(I_NaCa, conductanceSSE2(table, t, kTTNaK, x)));
+
+        __m128d V_old = _mm_loadu_pd(r.V + x);
+        __m128d V_new = _mm_add_pd(V_old, _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(r.diffusion + x), I_total), dt));
+        __m128d Cai = _mm_loadu_pd(r.Cai + x);
+        __m128d Cai_new = _mm_sub_pd(Cai, _mm_mul_pd(calcium_dt, _mm_add_pd(I_CaL, _mm_mul_pd(leak, Cai_eval))));
+        Cai_new = _mm_max_pd(_mm_min_pd(Cai_new, cai_max), cai_min);
+
+        advanceGateSSE2(r.m, x, dt);
+        advanceGateSSE2(r.u, x, dt);
+        _mm_storeu_pd(r.V_out + x, V_new);
+        _mm_storeu_pd(r.Cai_out + x, Cai_new);
+    }
+    tenTusscherRowTail(tenTusscherRowSSE2, 2, r, x, x_end, k);
+}
+
+// AVX2 + FMA kernels (4 doubles or 8 floats per register)
+
+__attribute__((target("avx2,fma")))
+void fhnRowAVX2(const FHNRowPointers<double>& r, int x_begin, int x_end, const FHNCoefficients<double>& k) {
+    const __m256d dt = _mm256_set1_pd(k.dt);
+    const __m256d du = _mm256_set1_pd(k.du);
+    const __m256d dv = _mm256_set1_pd(k.dv);
+    const __m256d a = _mm256_set1_pd(k.a);
+    const __m256d b = _mm256_set1_pd(k.b);
+    const __m256d inv_c = _mm256_set1_pd(1.0 / k.c);
+    const __m256d third = _mm256_set1_pd(1.0 / 3.0);
+    const __m256d four = _mm256_set1_pd(4.0);
+
+    int x = x_begin;
+    for (; x + 4 <= x_end; x += 4) {
+        __m256d u = _mm256_loadu_pd(r.u_row + x);
+        __m256d v = _mm256_loadu_pd(r.v_row + x);
+
+        __m256d lap_u = _mm256_add_pd(_mm256_add_pd(_mm256_loadu_pd(r.u_up + x), _mm256_loadu_pd(r.u_down + x)),
+                                      _mm256_add_pd(_mm256_loadu_pd(r.u_row + x - 1), _mm256_loadu_pd(r.u_row + x + 1)));
+        lap_u = _mm256_fnmadd_pd(four, u, lap_u);
+        __m256d lap_v = _mm256_add_pd(_mm256_add_pd(_mm256_loadu_pd(r.v_up + x), _mm256_loadu_pd(r.v_down + x)),
+                                      _mm256_add_pd(_mm256_loadu_pd(r.v_row + x - 1), _mm256_loadu_pd(r.v_row + x + 1)));
+        lap_v = _mm256_fnmadd_pd(four, v, lap_v);
+
+        __m256d cube = _mm256_mul_pd(_mm256_mul_pd(_mm256_mul_pd(u, u), u), third);
+        __m256d react_u = _mm256_add_pd(_mm256_sub_pd(_mm256_sub_pd(u, cube), v), _mm256_loadu_pd(r.stim + x));
+        __m256d react_v = _mm256_mul_pd(_mm256_fnmadd_pd(b, v, _mm256_add_pd(u, a)), inv_c);
+
+        __m256d du_dt = _mm256_fmadd_pd(du, lap_u, react_u);
+        __m256d dv_dt = _mm256_fmadd_pd(dv, lap_v, react_v);
+        _mm256_storeu_pd(r.u_out + x, _mm256_fmadd_pd(dt, du_dt, u));
+        _mm256_storeu_pd(r.v_out + x, _mm256_fmadd_pd(dt, dv_dt, v));
+    }
+    fhnRowTail(fhnRowAVX2, 4, r, x, x_end, k);
+}
+
+__attribute__((target("avx2,fma")))
+void fhnRowAVX2Float(const FHNRowPointers<float>& r, int x_begin, int x_end, const FHNCoefficients<float>& k) {
+    const __m256 dt = _mm256_set1_ps(k.dt);
+    const __m256 du = _mm256_set1_ps(k.du);
+    const __m256 dv = _mm256_set1_ps(k.dv);
+    const __m256 a = _mm256_set1_ps(k.a);
+    const __m256 b = _mm256_set1_ps(k.b);
+    const __m256 inv_c = _mm256_set1_ps(1.0f / k.c);
+    const __m256 third = _mm256_set1_ps(1.0f / 3.0f);
+    const __m256 four = _mm256_set1_ps(4.0f);
+
+    int x = x_begin;
+    for (; x + 8 <= x_end; x += 8) {
+        __m256 u = _mm256_loadu_ps(r.u_row + x);
+        __m256 v = _mm256_loadu_ps(r.v_row + x);
+
+        __m256 lap_u = _mm256_add_ps(_mm256_add_ps(_mm256_loadu_ps(r.u_up + x), _mm256_loadu_ps(r.u_down + x)),
+                                     _mm256_add_ps(_mm256_loadu_ps(r.u_row + x - 1), _mm256_loadu_ps(r.u_row + x + 1)));
+        lap_u = _mm256_fnmadd_ps(four, u, lap_u);
+        __m256 lap_v = _mm256_add_ps(_mm256_add_ps(_mm256_loadu_ps(r.v_up + x), _mm256_loadu_ps(r.v_down + x)),
+                                     _mm256_add_ps(_mm256_loadu_ps(r.v_row + x - 1), _mm256_loadu_ps(r.v_row + x + 1)));
+        lap_v = _mm256_fnmadd_ps(four, v, lap_v);
+
+        __m256 cube = _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(u, u), u), third);
+        __m256 react_u = _mm256_add_ps(_mm256_sub_ps(_mm256_sub_ps(u, cube), v), _mm256_loadu_ps(r.stim + x));
+        __m256 react_v = _mm256_mul_ps(_mm256_fnmadd_ps(b, v, _mm256_add_ps(u, a)), inv_c);
+
+        __m256 du_dt = _mm256_fmadd_ps(du, lap_u, react_u);
+        __m256 dv_dt = _mm256_fmadd_ps(dv, lap_v, react_v);
+        _mm256_storeu_ps(r.u_out + x, _mm256_fmadd_ps(dt, du_dt, u));
+        _mm256_storeu_ps(r.v_out + x, _mm256_fmadd_ps(dt, dv_dt, v));
+    }
+    fhnRowTail(fhnRowAVX2Float, 8, r, x, x_end, k);
+}
+
+__attribute__((target("avx2,fma")))
+void fhnRow7AVX2(const FHNRowPointers3D& r3, int x_begin, int x_end, const FHNCoefficients<double>& k) {
+    const FHNRowPointers<double>& r = r3.plane;
+    const __m256d dt = _mm256_set1_pd(k.dt);
+    const __m256d du = _mm256_set1_pd(k.du);
+    const __m256d dv = _mm256_set1_pd(k.dv);
+    const __m256d a = _mm256_set1_pd(k.a);
+    const __m256d b = _mm256_set1_pd(k.b);
+    const __m256d inv_c = _mm256_set1_pd(1.0 / k.c);
+    const __m256d third = _mm256_set1_pd(1.0 / 3.0);
+    const __m256d six = _mm256_set1_pd(6.0);
+
+    int x = x_begin;
+    for (; x + 4 <= x_end; x += 4) {
+        __m256d u = _mm256_loadu_pd(r.u_row + x);
+        __m256d v = _mm256_loadu_pd(r.v_row + x);
+
+        __m256d lap_u = _mm256_add_pd(_mm256_add_pd(_mm256_loadu_pd(r.u_up + x), _mm256_loadu_pd(r.u_down + x)),
+                                      _mm256_add_pd(_mm256_loadu_pd(r.u_row + x - 1), _mm256_loadu_pd(r.u_row + x + 1)));
+        lap_u = _mm256_add_pd(lap_u, _mm256_add_pd(_mm256_loadu_pd(r3.u_front + x), _mm256_loadu_pd(r3.u_back + x)));
+        lap_u = _mm256_fnmadd_pd(six, u, lap_u);
+        __m256d lap_v = _mm256_add_pd(_mm256_add_pd(_mm256_loadu_pd(r.v_up + x), _mm256_loadu_pd(r.v_down + x)),
+                                      _mm256_add_pd(_mm256_loadu_pd(r.v_row + x - 1), _mm256_loadu_pd(r.v_row + x + 1)));
+        lap_v = _mm256_add_pd(lap_v, _mm256_add_pd(_mm256_loadu_pd(r3.v_front + x), _mm256_loadu_pd(r3.v_back + x)));
+        lap_v = _mm256_fnmadd_pd(six, v, lap_v);
+
+        __m256d cube = _mm256_mul_pd(_mm256_mul_pd(_mm256_mul_pd(u, u), u), third);
+        __m256d react_u = _mm256_add_pd(_mm256_sub_pd(_mm256_sub_pd(u, cube), v), _mm256_loadu_pd(r.stim + x));
+        __m256d react_v = _mm256_mul_pd(_mm256_fnmadd_pd(b, v, _mm256_add_pd(u, a)), inv_c);
+
+        __m256d du_dt = _mm256_fmadd_pd(du, lap_u, react_u);
+        __m256d dv_dt = _mm256_fmadd_pd(dv, lap_v, react_v);
+        _mm256_storeu_pd(r.u_out + x, _mm256_fmadd_pd(dt, du_dt, u));
+        _mm256_storeu_pd(r.v_out + x, _mm256_fmadd_pd(dt, dv_dt, v));
+    }
+    fhnRow7Scalar(r3, x, x_end, k);
+}
+
+__attribute__((target("avx2,fma")))
+void fhnEnsembleRowAVX2(const FHNRowPointers<double>& r, int x_begin, int x_end, int members,
+                        const FHNEnsembleCoefficients& k) {
+    const __m256d dt = _mm256_set1_pd(k.dt);
+    const __m256d third = _mm256_set1_pd(1.0 / 3.0);
+    const __m256d four = _mm256_set1_pd(4.0);
+
+    for (int x = x_begin; x < x_end; ++x) {
+        const std::ptrdiff_t cell = static_cast<std::ptrdiff_t>(x) * members;
+        for (int m = 0; m < members; m += 4) {
+            const std::ptrdiff_t i = cell + m;
+            __m256d u = _mm256_loadu_pd(r.u_row + i);
+            __m256d v = _mm256_loadu_pd(r.v_row + i);
+
+            __m256d lap_u = _mm256_add_pd(_mm256_add_pd(_mm256_loadu_pd(r.u_up + i), _mm256_loadu_pd(r.u_down + i)),
+                                          _mm256_add_pd(_mm256_loadu_pd(r.u_row + i - members), _mm256_loadu_pd(r.u_row + i + members)));
+            lap_u = _mm256_fnmadd_pd(four, u, lap_u);
+            __m256d lap_v = _mm256_add_pd(_mm256_add_pd(_mm256_loadu_pd(r.v_up + i), _mm256_loadu_pd(r.v_down + i)),
+                                          _mm256_add_pd(_mm256_loadu_pd(r.v_row + i - members), _mm256_loadu_pd(r.v_row + i + members)));
+            lap_v = _mm256_fnmadd_pd(four, v, lap_v);
+
+            __m256d cube = _mm256_mul_pd(_mm256_mul_pd(_mm256_mul_pd(u, u), u), third);
+            __m256d react_u = _mm256_add_pd(_mm256_sub_pd(_mm256_sub_pd(u, cube), v), _mm256_loadu_pd(r.stim + i));
+            __m256d react_v = _mm256_mul_pd(_mm256_fnmadd_pd(_mm256_loadu_pd(k.b + m), v,
+                                                             _mm256_add_pd(u, _mm256_loadu_pd(k.a + m))),
+                                            _mm256_loadu_pd(k.inv_c + m));
+
+            __m256d du_dt = _mm256_fmadd_pd(_mm256_loadu_pd(k.du + m), lap_u, react_u);
+            __m256d dv_dt = _mm256_fmadd_pd(_mm256_loadu_pd(k.dv + m), lap_v, react_v);
+            _mm256_storeu_pd(r.u_out + i, _mm256_fmadd_pd(dt, du_dt, u));
+            _mm256_storeu_pd(r.v_out + i, _mm256_fmadd_pd(dt, dv_dt, v));
+        }
+    }
+}
+
+__attribute__((target("avx2,fma")))
+void laplacianRowAVX2(const double* up, const double* row, const double* down,
+                      double coeff, double* out, int x_begin, int x_end) {
+    const __m256d scale = _mm256_set1_pd(coeff);
+    const __m256d four = _mm256_set1_pd(4.0);
+
+    int x = x_begin;
+    for (; x + 4 <= x_end; x += 4) {
+        __m256d center = _mm256_loadu_pd(row + x);
+        __m256d sum = _mm256_add_pd(_mm256_add_pd(_mm256_loadu_pd(up + x), _mm256_loadu_pd(down + x)),
+                                    _mm256_add_pd(_mm256_loadu_pd(row + x - 1), _mm256_loadu_pd(row + x + 1)));
+        _mm256_storeu_pd(out + x, _mm256_mul_pd(scale, _mm256_fnmadd_pd(four, center, sum)));
+    }
+    laplacianRowTail(laplacianRowAVX2, 4, up, row, down, coeff, out, x, x_end);
+}
+
+// sum + weight * (neighbour - center)
+__attribute__((target("avx2,fma")))
+inline __m256d couplingAVX2(const double* weight, const double* neighbour, __m256d center, __m256d sum) {
+    return _mm256_fmadd_pd(_mm256_loadu_pd(weight), _mm256_sub_pd(_mm256_loadu_pd(neighbour), center), sum);
+}
+
+template <bool Diagonal>
+__attribute__((target("avx2,fma")))
+void ninePointRowAVX2(const NinePointRowPointers& r, int x_begin, int x_end) {
+    int x = x_begin;
+    for (; x + 4 <= x_end; x += 4) {
+        __m256d center = _mm256_loadu_pd(r.row + x);
+        __m256d sum = couplingAVX2(r.east + x, r.row + x + 1, center, _mm256_setzero_pd());
+        sum = couplingAVX2(r.east + x - 1, r.row + x - 1, center, sum);
+        sum = couplingAVX2(r.south + x, r.down + x, center, sum);
+        sum = couplingAVX2(r.south_up + x, r.up + x, center, sum);
+        if (Diagonal) {
+            sum = couplingAVX2(r.south_east + x, r.down + x + 1, center, sum);
+            sum = couplingAVX2(r.south_east_up + x - 1, r.up + x - 1, center, sum);
+            sum = couplingAVX2(r.north_east + x, r.up + x + 1, center, sum);
+            sum = couplingAVX2(r.north_east_down + x - 1, r.down + x - 1, center, sum);
+        }
+        _mm256_storeu_pd(r.out + x, sum);
+    }
+    ninePointRowTail(ninePointRowAVX2<Diagonal>, 4, r, x, x_end);
+}
+
+// Table offsets (in doubles) of the tissue classes of cells x .. x + 3
+template <int Count>
+__attribute__((target("avx2,fma")))
+inline __m256i tissueIndexAVX2(const TissueRowPointers<Count>& t, int x) {
+    if (!t.tissue_class) {
+        return _mm256_setzero_si256();
+    }
+    int classes;
+    std::memcpy(&classes, t.tissue_class + x, sizeof(classes));
+    return _mm256_mul_epu32(_mm256_cvtepu8_epi64(_mm_cvtsi32_si128(classes)), _mm256_set1_epi64x(Count));
+}
+
+// Conductance c of cells x .. x + 3, gathered from the tissue table
+template <int Count>
+__attribute__((target("avx2,fma")))
+inline __m256d conductanceAVX2(const double* table, const TissueRowPointers<Count>& t, __m256i index,
+                               int c, int x) {
+    __m256d g = t.tissue_class ? _mm256_i64gather_pd(table + c, index, 8) : _mm256_broadcast_sd(table + c);
+    return t.scale[c] ? _mm256_mul_pd(g, _mm256_loadu_pd(t.scale[c] + x)) : g;
+}
+
+__attribute__((target("avx2,fma")))
+inline void advanceGateAVX2(const GateRowPointers& g, int x, __m256d dt) {
+    __m256d value = _mm256_loadu_pd(g.value + x);
+    __m256d drift = _mm256_fnmadd_pd(_mm256_loadu_pd(g.beta + x), value,
+                                     _mm256_mul_pd(_mm256_loadu_pd(g.alpha + x),
+                                                   _mm256_sub_pd(_mm256_set1_pd(1.0), value)));
+    __m256d step = g.step ? _mm256_loadu_pd(g.step + x) : dt;
+    _mm256_storeu_pd(g.out + x, _mm256_fmadd_pd(step, drift, value));
+}
+
+__attribute__((target("avx2,fma")))
+void luoRudyRowAVX2(const LuoRudyRowPointers& r, int x_begin, int x_end, const LuoRudyCoefficients& k) {
+    const auto& t = r.tissue;
+    const double* table = k.tissue[0].data();
+    const __m256d dt = _mm256_set1_pd(k.dt);
+    const __m256d calcium_dt = _mm256_set1_pd(k.dt * 0.001);
+    const __m256d j = _mm256_set1_pd(k.j);
+    const __m256d xs = _mm256_set1_pd(k.xs);
+    const __m256d e_na = _mm256_set1_pd(54.4);
+    const __m256d e_ca = _mm256_set1_pd(130.0);
+    const __m256d e_k = _mm256_set1_pd(-77.0);
+    const __m256d e_b = _mm256_set1_pd(-59.87);
+    const __m256d leak = _mm256_set1_pd(0.0001);
+    const __m256d cai_min = _mm256_set1_pd(0.0001);
+    const __m256d cai_max = _mm256_set1_pd(0.01);
+
+    int x = x_begin;
+    for (; x + 4 <= x_end; x += 4) {
+        const __m256i index = tissueIndexAVX2(t, x);
+        __m256d V = _mm256_loadu_pd(r.V_eval + x);
+        __m256d m = _mm256_loadu_pd(r.m.eval + x);
+        __m256d V_ca = _mm256_sub_pd(V, e_ca);
+        __m256d V_k = _mm256_sub_pd(V, e_k);
+        __m256d g_na = _mm256_mul_pd(conductanceAVX2(table, t, index, kLRNa, x), j);
+        __m256d I_Na = _mm256_mul_pd(_mm256_mul_pd(g_na, _mm256_mul_pd(m, _mm256_mul_pd(m, m))),
+                                     _mm256_mul_pd(_mm256_loadu_pd(r.h.eval + x), _mm256_sub_pd(V, e_na)));
+        __m256d I_CaL = _mm256_mul_pd(conductanceAVX2(table, t, index, kLRCaL, x), V_ca);
+        __m256d g_k = _mm256_mul_pd(conductanceAVX2(table, t, index, kLRK, x), xs);
+        __m256d I_K = _mm256_mul_pd(_mm256_mul_pd(g_k, _mm256_loadu_pd(r.xr.eval + x)), V_k);
+        __m256d I_K1 = _mm256_div_pd(_mm256_mul_pd(conductanceAVX2(table, t, index, kLRK1, x), V_k),
+                                     _mm256_loadu_pd(r.k1_denominator + x));
+        __m256d I_total = _mm256_add_pd(_mm256_add_pd(I_Na, I_CaL), _mm256_add_pd(I_K, I_K1));
+        I_total = _mm256_fmadd_pd(conductanceAVX2(table, t, index, kLRb, x), _mm256_sub_pd(V, e_b), I_total);
+        I_total = _mm256_fmadd_pd(conductanceAVX2(table, t, index, kLRCaT, x), V_ca, I_total);
+
+        __m256d V_old = _mm256_loadu_pd(r.V + x);
+        __m256d V_new = _mm256_fmadd_pd(_mm256_sub_pd(_mm256_loadu_pd(r.diffusion + x), I_total), dt, V_old);
+        __m256d Cai = _mm256_loadu_pd(r.Cai + x);
+        __m256d Cai_new = _mm256_fnmadd_pd(calcium_dt, _mm256_fmadd_pd(leak, Cai, I_CaL), Cai);
+        Cai_new = _mm256_max_pd(_mm256_min_pd(Cai_new, cai_max), cai_min);
+
+        advanceGateAVX2(r.m, x, dt);
+        advanceGateAVX2(r.h, x, dt);
+        advanceGateAVX2(r.xr, x, dt);
+        _mm256_storeu_pd(r.V_out + x, V_new);
+        _mm256_storeu_pd(r.Cai_out + x, Cai_new);
+    }
+    luoRudyRowTail(luoRudyRowAVX2, 4, r, x, x_end, k);
+}
+
+__attribute__((target("avx2,fma")))
+void tenTusscherRowAVX2(const TenTusscherRowPointers& r, int x_begin, int x_end,
+                        const TenTusscherCoefficients& k) {
+    const auto& t = r.tissue;
+    const double* table = k.tissue[0].data();
+    const __m256d dt = _mm256_set1_pd(k.dt);
+    const __m256d calcium_dt = _mm256_set1_pd(k.dt * 0.001);
+    const __m256d hj = _mm256_set1_pd(k.h * k.j);
+    const __m256d nai3 = _mm256_set1_pd(k.Nai * k.Nai * k.Nai);
+    const __m256d e_na = _mm256_set1_pd(54.4);
+    const __m256d e_ca = _mm256_set1_pd(130.0);
+    const __m256d e_k = _mm256_set1_pd(-77.0);
+    const __m256d ca_o = _mm256_set1_pd(1.4);
+    const __m256d sat = _mm256_set1_pd(0.1);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d leak = _mm256_set1_pd(0.0001);
+    const __m256d cai_min = _mm256_set1_pd(0.0001);
+    const __m256d cai_max = _mm256_set1_pd(0.01);
+
+    int x = x_begin;
+    for (; x + 4 <= x_end; x += 4) {
+        const __m256i index = tissueIndexAVX2(t, x);
+        __m256d V = _mm256_loadu_pd(r.V_eval + x);
+        __m256d m = _mm256_loadu_pd(r.m.eval + x);
+        __m256d Cai_eval = _mm256_loadu_pd(r.Cai_eval + x);
+        __m256d g_na = _mm256_mul_pd(conductanceAVX2(table, t, index, kTTNa, x), hj);
+        __m256d I_Na = _mm256_mul_pd(_mm256_mul_pd(g_na, _mm256_mul_pd(m, _mm256_mul_pd(m, m))),
+                                     _mm256_sub_pd(V, e_na));
+        __m256d I_CaL = _mm256_mul_pd(conductanceAVX2(table, t, index, kTTCaL, x), _mm256_sub_pd(V, e_ca));
+        __m256d V_k = _mm256_sub_pd(V, e_k);
+        __m256d g_k = _mm256_add_pd(conductanceAVX2(table, t, index, kTTKs, x),
+                                    conductanceAVX2(table, t, index, kTTto, x));
+        g_k = _mm256_fmadd_pd(conductanceAVX2(table, t, index, kTTKr, x), _mm256_loadu_pd(r.u.eval + x), g_k);
+        __m256d I_K = _mm256_mul_pd(g_k, V_k);
+        __m256d I_K1 = _mm256_div_pd(_mm256_mul_pd(conductanceAVX2(table, t, index, kTTK1, x), V_k),
+                                     _mm256_loadu_pd(r.k1_denominator + x));
+        __m256d exp_minus = _mm256_loadu_pd(r.naca_exp_minus + x);
+        __m256d naca = _mm256_fmsub_pd(_mm256_mul_pd(_mm256_loadu_pd(r.naca_exp_plus + x), nai3), Cai_eval,
+                                       _mm256_mul_pd(exp_minus, ca_o));
+        __m256d I_NaCa = _mm256_div_pd(_mm256_mul_pd(conductanceAVX2(table, t, index, kTTNaCa, x), naca),
+                                       _mm256_fmadd_pd(sat, exp_minus, one));
+        __m256d I_total = _mm256_add_pd(_mm256_add_pd(I_Na, I_CaL), _mm256_add_pd(I_K, I_K1));
+        I_total = _mm256_add_pd(I_total, _mm256_add_pd(I_NaCa, conductanceAVX2(table, t, index, kTTNaK, x)));
+
+        __m256d V_old = _mm256_loadu_pd(r.V + x);
+        __m256d V_new = _mm256_fmadd_pd(_mm256_sub_pd(_mm256_loadu_pd(r.diffusion + x), I_total), dt, V_old);
+        __m256d Cai = _mm256_loadu_pd(r.Cai + x);
+        __m256d Cai_new = _mm256_fnmadd_pd(calcium_dt, _mm256_fmadd_pd(leak, Cai_eval, I_CaL), Cai);
+        Cai_new = _mm256_max_pd(_mm256_min_pd(Cai_new, cai_max), cai_min);
+
+        advanceGateAVX2(r.m, x, dt);
+        advanceGateAVX2(r.u, x, dt);
+        _mm256_storeu_pd(r.V_out + x, V_new);
+        _mm256_storeu_pd(r.Cai_out + x, Cai_new);
+    }
+    tenTusscherRowTail(tenTusscherRowAVX2, 4, r, x, x_end, k);
+}
+
+// AVX-512F kernels (8 doubles or 16 floats per register)
+
+__attribute__((target("avx512f")))
+void fhnRowAVX512(const FHNRowPointers<double>& r, int x_begin, int x_end, const FHNCoefficients<double>& k) {
+    const __m512d dt = _mm512_set1_pd(k.dt);
+    const __m512d du = _mm512_set1_pd(k.du);
+    const __m512d dv = _mm512_set1_pd(k.dv);
+    const __m512d a = _mm512_set1_pd(k.a);
+    const __m512d b = _mm512_set1_pd(k.b);
+    const __m512d inv_c = _mm512_set1_pd(1.0 / k.c);
+    const __m512d third = _mm512_set1_pd(1.0 / 3.0);
+    const __m512d four = _mm512_set1_pd(4.0);
+
+    int x = x_begin;
+    for (; x + 8 <= x_end; x += 8) {
+        __m512d u = _mm512_loadu_pd(r.u_row + x);
+        __m512d v = _mm512_loadu_pd(r.v_row + x);
+
+        __m512d lap_u = _mm512_add_pd(_mm512_add_pd(_mm512_loadu_pd(r.u_up + x), _mm512_loadu_pd(r.u_down + x)),
+                                      _mm512_add_pd(_mm512_loadu_pd(r.u_row + x - 1), _mm512_loadu_pd(r.u_row + x + 1)));
+        lap_u = _mm512_fnmadd_pd(four, u, lap_u);
+        __m512d lap_v = _mm512_add_pd(_mm512_add_pd(_mm512_loadu_pd(r.v_up + x), _mm512_loadu_pd(r.v_down + x)),
+                                      _mm512_add_pd(_mm512_loadu_pd(r.v_row + x - 1), _mm512_loadu_pd(r.v_row + x + 1)));
+        lap_v = _mm512_fnmadd_pd(four, v, lap_v);
+
+        __m512d cube = _mm512_mul_pd(_mm512_mul_pd(_mm512_mul_pd(u, u), u), third);
+        __m512d react_u = _mm512_add_pd(_mm512_sub_pd(_mm512_sub_pd(u, cube), v), _mm512_loadu_pd(r.stim + x));
+        __m512d react_v = _mm512_mul_pd(_mm512_fnmadd_pd(b, v, _mm512_add_pd(u, a)), inv_c);
+
+        __m512d du_dt = _mm512_fmadd_pd(du, lap_u, react_u);
+        __m512d dv_dt = _mm512_fmadd_pd(dv, lap_v, react_v);
+        _mm512_storeu_pd(r.u_out + x, _mm512_fmadd_pd(dt, du_dt, u));
+        _mm512_storeu_pd(r.v_out + x, _mm512_fmadd_pd(dt, dv_dt, v));
+    }
+    fhnRowTail(fhnRowAVX512, 8, r, x, x_end, k);
+}
+
+__attribute__((target("avx512f")))
+void fhnRowAVX512Float(const FHNRowPointers<float>& r, int x_begin, int x_end, const FHNCoefficients<float>& k) {
+    const __m512 dt = _mm512_set1_ps(k.dt);
+    const __m512 du = _mm512_set1_ps(k.du);
+    const __m512 dv = _mm512_set1_ps(k.dv);
+    const __m512 a = _mm512_set1_ps(k.a);
+    const __m512 b = _mm512_set1_ps(k.b);
+    const __m512 inv_c = _mm512_set1_ps(1.0f / k.c);
+    const __m512 third = _mm512_set1_ps(1.0f / 3.0f);
+    const __m512 four = _mm512_set1_ps(4.0f);
+
+    int x = x_begin;
+    for (; x + 16 <= x_end; x += 16) {
+        __m512 u = _mm512_loadu_ps(r.u_row + x);
+        __m512 v = _mm512_loadu_ps(r.v_row + x);
+
+        __m512 lap_u = _mm512_add_ps(_mm512_add_ps(_mm512_loadu_ps(r.u_up + x), _mm512_loadu_ps(r.u_down + x)),
+                                     _mm512_add_ps(_mm512_loadu_ps(r.u_row + x - 1), _mm512_loadu_ps(r.u_row + x + 1)));
+        lap_u = _mm512_fnmadd_ps(four, u, lap_u);
+        __m512 lap_v = _mm512_add_ps(_mm512_add_ps(_mm512_loadu_ps(r.v_up + x), _mm512_loadu_ps(r.v_down + x)),
+                                     _mm512_add_ps(_mm512_loadu_ps(r.v_row + x - 1), _mm512_loadu_ps(r.v_row + x + 1)));
+        lap_v = _mm512_fnmadd_ps(four, v, lap_v);
+
+        __m512 cube = _mm512_mul_ps(_mm512_mul_ps(_mm512_mul_ps(u, u), u), third);
+        __m512 react_u = _mm512_add_ps(_mm512_sub_ps(_mm512_sub_ps(u, cube), v), _mm512_loadu_ps(r.stim + x));
+        __m512 react_v = _mm512_mul_ps(_mm512_fnmadd_ps(b, v, _mm512_add_ps(u, a)), inv_c);
+
+        __m512 du_dt = _mm512_fmadd_ps(du, lap_u, react_u);
+        __m512 dv_dt = _mm512_fmadd_ps(dv, lap_v, react_v);
+        _mm512_storeu_ps(r.u_out + x, _mm512_fmadd_ps(dt, du_dt, u));
+        _mm512_storeu_ps(r.v_out + x, _mm512_fmadd_ps(dt, dv_dt, v));
+    }
+    fhnRowTail(fhnRowAVX512Float, 16, r, x, x_end, k);
+}
+
+__attribute__((target("avx512f")))
+void fhnRow7AVX512(const FHNRowPointers3D& r3, int x_begin, int x_end, const FHNCoefficients<double>& k) {
+    const FHNRowPointers<double>& r = r3.plane;
+    const __m512d dt = _mm512_set1_pd(k.dt);
+    const __m512d du = _mm512_set1_pd(k.du);
+    const __m512d dv = _mm512_set1_pd(k.dv);
+    const __m512d a = _mm512_set1_pd(k.a);
+    const __m512d b = _mm512_set1_pd(k.b);
+    const __m512d inv_c = _mm512_set1_pd(1.0 / k.c);
+    const __m512d third = _mm512_set1_pd(1.0 / 3.0);
+    const __m512d six = _mm512_set1_pd(6.0);
+
+    int x = x_begin;
+    for (; x + 8 <= x_end; x += 8) {
+        __m512d u = _mm512_loadu_pd(r.u_row + x);
+        __m512d v = _mm512_loadu_pd(r.v_row + x);
+
+        __m512d lap_u = _mm512_add_pd(_mm512_add_pd(_mm512_loadu_pd(r.u_up + x), _mm512_loadu_pd(r.u_down + x)),
+                                      _mm512_add_pd(_mm512_loadu_pd(r.u_row + x - 1), _mm512_loadu_pd(r.u_row + x + 1)));
+        lap_u = _mm512_add_pd(lap_u, _mm512_add_pd(_mm512_loadu_pd(r3.u_front + x), _mm512_loadu_pd(r3.u_back + x)));
+        lap_u = _mm512_fnmadd_pd(six, u, lap_u);
+        __m512d lap_v = _mm512_add_pd(_mm512_add_pd(_mm512_loadu_pd(r.v_up + x), _mm512_loadu_pd(r.v_down + x)),
+                                      _mm512_add_pd(_mm512_loadu_pd(r.v_row + x - 1), _mm512_loadu_pd(r.v_row + x + 1)));
+        lap_v = _mm512_add_pd(lap_v, _mm512_add_pd(_mm512_loadu_pd(r3.v_front + x), _mm512_loadu_pd(r3.v_back + x)));
+        lap_v = _mm512_fnmadd_pd(six, v, lap_v);
+
+        __m512d cube = _mm512_mul_pd(_mm512_mul_pd(_mm512_mul_pd(u, u), u), third);
+        __m512d react_u = _mm512_add_pd(_mm512_sub_pd(_mm512_sub_pd(u, cube), v), _mm512_loadu_pd(r.stim + x));
+        __m512d react_v = _mm512_mul_pd(_mm512_fnmadd_pd(b, v, _mm512_add_pd(u, a)), inv_c);
+
+        __m512d du_dt = _mm512_fmadd_pd(du, lap_u, react_u);
+        __m512d dv_dt = _mm512_fmadd_pd(dv, lap_v, react_v);
+        _mm512_storeu_pd(r.u_out + x, _mm512_fmadd_pd(dt, du_dt, u));
+        _mm512_storeu_pd(r.v_out + x, _mm512_fmadd_pd(dt, dv_dt, v));
+    }
+    fhnRow7Scalar(r3, x, x_end, k);
+}
+
+__attribute__((target("avx512f")))
+void fhnEnsembleRowAVX512(const FHNRowPointers<double>& r, int x_begin, int x_end, int members,
+                          const FHNEnsembleCoefficients& k) {
+    const __m512d dt = _mm512_set1_pd(k.dt);
+    const __m512d third = _mm512_set1_pd(1.0 / 3.0);
+    const __m512d four = _mm512_set1_pd(4.0);
+
+    for (int x = x_begin; x < x_end; ++x) {
+        const std::ptrdiff_t cell = static_cast<std::ptrdiff_t>(x) * members;
+        for (int m = 0; m < members; m += 8) {
+            const std::ptrdiff_t i = cell + m;
+            __m512d u = _mm512_loadu_pd(r.u_row + i);
+            __m512d v = _mm512_loadu_pd(r.v_row + i);
+
+            __m512d lap_u = _mm512_add_pd(_mm512_add_pd(_mm512_loadu_pd(r.u_up + i), _mm512_loadu_pd(r.u_down + i)),
+                                          _mm512_add_pd(_mm512_loadu_pd(r.u_row + i - members), _mm512_loadu_pd(r.u_row + i + members)));
+            lap_u = _mm512_fnmadd_pd(four, u, lap_u);
+            __m512d lap_v = _mm512_add_pd(_mm512_add_pd(_mm512_loadu_pd(r.v_up + i), _mm512_loadu_pd(r.v_down + i)),
+                                          _mm512_add_pd(_mm512_loadu_pd(r.v_row + i - members), _mm512_loadu_pd(r.v_row + i + members)));
+            lap_v = _mm512_fnmadd_pd(four, v, lap_v);
+
+            __m512d cube = _mm512_mul_pd(_mm512_mul_pd(_mm512_mul_pd(u, u), u), third);
+            __m512d react_u = _mm512_add_pd(_mm512_sub_pd(_mm512_sub_pd(u, cube), v), _mm512_loadu_pd(r.stim + i));
+            __m512d react_v = _mm512_mul_pd(_mm512_fnmadd_pd(_mm512_loadu_pd(k.b + m), v,
+                                                             _mm512_add_pd(u, _mm512_loadu_pd(k.a + m))),
+                                            _mm512_loadu_pd(k.inv_c + m));
+
+            __m512d du_dt = _mm512_fmadd_pd(_mm512_loadu_pd(k.du + m), lap_u, react_u);
+            __m512d dv_dt = _mm512_fmadd_pd(_mm512_loadu_pd(k.dv + m), lap_v, react_v);
+            _mm512_storeu_pd(r.u_out + i, _mm512_fmadd_pd(dt, du_dt, u));
+            _mm512_storeu_pd(r.v_out + i, _mm512_fmadd_pd(dt, dv_dt, v));
+        }
+    }
+}
+
+__attribute__((target("avx512f")))
+void laplacianRowAVX512(const double* up, const double* row, const double* down,
+                        double coeff, double* out, int x_begin, int x_end) {
+    const __m512d scale = _mm512_set1_pd(coeff);
+    const __m512d four = _mm512_set1_pd(4.0);
+
+    int x = x_begin;
+    for (; x + 8 <= x_end; x += 8) {
+        __m512d center = _mm512_loadu_pd(row + x);
+        __m512d sum = _mm512_add_pd(_mm512_add_pd(_mm512_loadu_pd(up + x), _mm512_loadu_pd(down + x)),
+                                    _mm512_add_pd(_mm512_loadu_pd(row + x - 1), _mm512_loadu_pd(row + x + 1)));
+        _mm512_storeu_pd(out + x, _mm512_mul_pd(scale, _mm512_fnmadd_pd(four, center, sum)));
+    }
+    laplacianRowTail(laplacianRowAVX512, 8, up, row, down, coeff, out, x, x_end);
+}
+
+// sum + weight * (neighbour - center)
+__attribute__((target("avx512f")))
+inline __m512d couplingAVX512(const double* weight, const double* neighbour, __m512d center, __m512d sum) {
+    return _mm512_fmadd_pd(_mm512_loadu_pd(weight), _mm512_sub_pd(_mm512_loadu_pd(neighbour), center), sum);
+}
+
+template <bool Diagonal>
+__attribute__((target("avx512f")))
+void ninePointRowAVX512(const NinePointRowPointers& r, int x_begin, int x_end) {
+    int x = x_begin;
+    for (; x + 8 <= x_end; x += 8) {
+        __m512d center = _mm512_loadu_pd(r.row + x);
+        __m512d sum = couplingAVX512(r.east + x, r.row + x + 1, center, _mm512_setzero_pd());
+        sum = couplingAVX512(r.east + x - 1, r.row + x - 1, center, sum);
+        sum = couplingAVX512(r.south + x, r.down + x, center, sum);
+        sum = couplingAVX512(r.south_up + x, r.up + x, center, sum);
+        if (Diagonal) {
+            sum = couplingAVX512(r.south_east + x, r.down + x + 1, center, sum);
+            sum = couplingAVX512(r.south_east_up + x - 1, r.up + x - 1, center, sum);
+            sum = couplingAVX512(r.north_east + x, r.up + x + 1, center, sum);
+            sum = couplingAVX512(r.north_east_down + x - 1, r.down + x - 1, center, sum);
+        }
+        _mm512_storeu_pd(r.out + x, sum);
+    }
+    ninePointRowTail(ninePointRowAVX512<Diagonal>, 8, r, x, x_end);
+}
+
+// Table offsets (in doubles) of the tissue classes of cells x .. x + 7
+template <int Count>
+__attribute__((target("avx512f")))
+inline __m512i tissueIndexAVX512(const TissueRowPointers<Count>& t, int x) {
+    if (!t.tissue_class) {
+        return _mm512_setzero_si512();
+    }
+    __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(t.tissue_class + x));
+    // All-lanes maskz forms: GCC 12's unmasked wrappers pass an undefined
+    // source operand and trip -Wmaybe-uninitialized at -O3
+    __m512i classes = _mm512_maskz_cvtepu8_epi64(0xFF, bytes);
+    return _mm512_maskz_mul_epu32(0xFF, classes, _mm512_set1_epi64(Count));
+}
+
+// Conductance c of cells x .. x + 7, gathered from the tissue table
+template <int Count>
+__attribute__((target("avx512f")))
+inline __m512d conductanceAVX512(const double* table, const TissueRowPointers<Count>& t, __m512i index,
+                                 int c, int x) {
+    __m512d g = t.tissue_class ? _mm512_mask_i64gather_pd(_mm512_setzero_pd(), 0xFF, index, table + c, 8)
+                               : _mm512_set1_pd(table[c]);
+    return t.scale[c] ? _mm512_mul_pd(g, _mm512_loadu_pd(t.scale[c] + x)) : g;
+}
+
+__attribute__((target("avx512f")))
+inline void advanceGateAVX512(const GateRowPointers& g, int x, __m512d dt) {
+    __m512d value = _mm512_loadu_pd(g.value + x);
+    __m512d drift = _mm512_fnmadd_pd(_mm512_loadu_pd(g.beta + x), value,
+                                     _mm512_mul_pd(_mm512_loadu_pd(g.alpha + x),
+                                                   _mm512_sub_pd(_mm512_set1_pd(1.0), value)));
+    __m512d step = g.step ? _mm512_loadu_pd(g.step + x) : dt;
+    _mm512_storeu_pd(g.out + x, _mm512_fmadd_pd(step, drift, value));
+}
+
+__attribute__((target("avx512f")))
+void luoRudyRowAVX512(const LuoRudyRowPointers& r, int x_begin, int x_end, const LuoRudyCoefficients& k) {
+    const auto& t = r.tissue;
+    const double* table = k.tissue[0].data();
+    const __m512d dt = _mm512_set1_pd(k.dt);
+    const __m512d calcium_dt = _mm512_set1_pd(k.dt * 0.001);
+    const __m512d j = _mm512_set1_pd(k.j);
+    const __m512d xs = _mm512_set1_pd(k.xs);
+    const __m512d e_na = _mm512_set1_pd(54.4);
+    const __m512d e_ca = _mm512_set1_pd(130.0);
+    const __m512d e_k = _mm512_set1_pd(-77.0);
+    const __m512d e_b = _mm512_set1_pd(-59.87);
+    const __m512d leak = _mm512_set1_pd(0.0001);
+    const __m512d cai_min = _mm512_set1_pd(0.0001);
+    const __m512d cai_max = _mm512_set1_pd(0.01);
+
+    int x = x_begin;
+    for (; x + 8 <= x_end; x += 8) {
+        const __m512i index = tissueIndexAVX512(t, x);
+        __m512d V = _mm512_loadu_pd(r.V_eval + x);
+        __m512d m = _mm512_loadu_pd(r.m.eval + x);
+        __m512d V_ca = _mm512_sub_pd(V, e_ca);
+        __m512d V_k = _mm512_sub_pd(V, e_k);
+        __m512d g_na = _mm512_mul_pd(conductanceAVX512(table, t, index, kLRNa, x), j);
+        __m512d I_Na = _mm512_mul_pd(_mm512_mul_pd(g_na, _mm512_mul_pd(m, _mm512_mul_pd(m, m))),
+                                     _mm512_mul_pd(_mm512_loadu_pd(r.h.eval + x), _mm512_sub_pd(V, e_na)));
+        __m512d I_CaL = _mm512_mul_pd(conductanceAVX512(table, t, index, kLRCaL, x), V_ca);
+        __m512d g_k = _mm512_mul_pd(conductanceAVX512(table, t, index, kLRK, x), xs);
+        __m512d I_K = _mm512_mul_pd(_mm512_mul_pd(g_k, _mm512_loadu_pd(r.xr.eval + x)), V_k);
+        __m512d I_K1 = _mm512_div_pd(_mm512_mul_pd(conductanceAVX512(table, t, index, kLRK1, x), V_k),
+                                     _mm512_loadu_pd(r.k1_denominator + x));
+        __m512d I_total = _mm512_add_pd(_mm512_add_pd(I_Na, I_CaL), _mm512_add_pd(I_K, I_K1));
+        I_total = _mm512_fmadd_pd(conductanceAVX512(table, t, index, kLRb, x), _mm512_sub_pd(V, e_b), I_total);
+        I_total = _mm512_fmadd_pd(conductanceAVX512(table, t, index, kLRCaT, x), V_ca, I_total);
+
+        __m512d V_old = _mm512_loadu_pd(r.V + x);
+        __m512d V_new = _mm512_fmadd_pd(_mm512_sub_pd(_mm512_loadu_pd(r.diffusion + x), I_total), dt, V_old);
+        __m512d Cai = _mm512_loadu_pd(r.Cai + x);
+        __m512d Cai_new = _mm512_fnmadd_pd(calcium_dt, _mm512_fmadd_pd(leak, Cai, I_CaL), Cai);
+        // maskz: see tissueIndexAVX512
+        Cai_new = _mm512_maskz_max_pd(0xFF, _mm512_maskz_min_pd(0xFF, Cai_new, cai_max), cai_min);
+
+        advanceGateAVX512(r.m, x, dt);
+        advanceGateAVX512(r.h, x, dt);
+        advanceGateAVX512(r.xr, x, dt);
+        _mm512_storeu_pd(r.V_out + x, V_new);
+        _mm512_storeu_pd(r.Cai_out + x, Cai_new);
+    }
+    luoRudyRowTail(luoRudyRowAVX512, 8, r, x, x_end, k);
+}
+
+__attribute__((target("avx512f")))
+void tenTusscherRowAVX512(const TenTusscherRowPointers& r, int x_begin, int x_end,
+                        const TenTusscherCoefficients& k) {
+    const auto& t = r.tissue;
+    const double* table = k.tissue[0].data();
+    const __m512d dt = _mm512_set1_pd(k.dt);
+    const __m512d calcium_dt = _mm512_set1_pd(k.dt * 0.001);
+    const __m512d hj = _mm512_set1_pd(k.h * k.j);
+    const __m512d nai3 = _mm512_set1_pd(k.Nai * k.Nai * k.Nai);
+    const __m512d e_na = _mm512_set1_pd(54.4);
+    const __m512d e_ca = _mm512_set1_pd(130.0);
+    const __m512d e_k = _mm512_set1_pd(-77.0);
+    const __m512d ca_o = _mm512_set1_pd(1.4);
+    const __m512d sat = _mm512_set1_pd(0.1);
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d leak = _mm512_set1_pd(0.0001);
+    const __m512d cai_min = _mm512_set1_pd(0.0001);
+    const __m512d cai_max = _mm512_set1_pd(0.01);
+
+    int x = x_begin;
+    for (; x + 8 <= x_end; x += 8) {
+        const __m512i index = tissueIndexAVX512(t, x);
+        __m512d V = _mm512_loadu_pd(r.V_eval + x);
+        __m512d m = _mm512_loadu_pd(r.m.eval + x);
+        __m512d Cai_eval = _mm512_loadu_pd(r.Cai_eval + x);
+        __m512d g_na = _mm512_mul_pd(conductanceAVX512(table, t, index, kTTNa, x), hj);
+        __m512d I_Na = _mm512_mul_pd(_mm512_mul_pd(g_na, _mm512_mul_pd(m, _mm512_mul_pd(m, m))),
+                                     _mm512_sub_pd(V, e_na));
+        __m512d I_CaL = _mm512_mul_pd(conductanceAVX512(table, t, index, kTTCaL, x), _mm512_sub_pd(V, e_ca));
+        __m512d V_k = _mm512_sub_pd(V, e_k);
+        __m512d g_k = _mm512_add_pd(conductanceAVX512(table, t, index, kTTKs, x),
+                                    conductanceAVX512(table, t, index, kTTto, x));
+        g_k = _mm512_fmadd_pd(conductanceAVX512(table, t, index, kTTKr, x), _mm512_loadu_pd(r.u.eval + x), g_k);
+        __m512d I_K = _mm512_mul_pd(g_k, V_k);
+        __m512d I_K1 = _mm512_div_pd(_mm512_mul_pd(conductanceAVX512(table, t, index, kTTK1, x), V_k),
+                                     _mm512_loadu_pd(r.k1_denominator + x));
+        __m512d exp_minus = _mm512_loadu_pd(r.naca_exp_minus + x);
+        __m512d naca = _mm512_fmsub_pd(_mm512_mul_pd(_mm512_loadu_pd(r.naca_exp_plus + x), nai3), Cai_eval,
+                                       _mm512_mul_pd(exp_minus, ca_o));
+        __m512d I_NaCa = _mm512_div_pd(_mm512_mul_pd(conductanceAVX512(table, t, index, kTTNaCa, x), naca),
+                                       _mm512_fmadd_pd(sat, exp_minus, one));
+        __m512d I_total = _mm512_add_pd(_mm512_add_pd(I_Na, I_CaL), _mm512_add_pd(I_K, I_K1));
+        I_total = _mm512_add_pd(I_total, _mm512_add_pd(I_NaCa, conductanceAVX512(table, t, index, kTTNaK, x)));
+
+        __m512d V_old = _mm512_loadu_pd(r.V + x);
+        __m512d V_new = _mm512_fmadd_pd(_mm512_sub_pd(_mm512_loadu_pd(r.diffusion + x), I_total), dt, V_old);
+        __m512d Cai = _mm512_loadu_pd(r.Cai + x);
+        __m512d Cai_new = _mm512_fnmadd_pd(calcium_dt, _mm512_fmadd_pd(leak, Cai_eval, I_CaL), Cai);
+        // maskz: see tissueIndexAVX512
+        Cai_new = _mm512_maskz_max_pd(0xFF, _mm512_maskz_min_pd(0xFF, Cai_new, cai_max), cai_min);
+
+        advanceGateAVX512(r.m, x, dt);
+        advanceGateAVX512(r.u, x, dt);
+        _mm512_storeu_pd(r.V_out + x, V_new);
+        _mm512_storeu_pd(r.Cai_out + x, Cai_new);
+    }
+    tenTusscherRowTail(tenTusscherRowAVX512, 8, r, x, x_end, k);
+}
+
+#endif // MI_SIMD_X86
+
+bool isSupported(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar:
+            return true;
+#ifdef MI_SIMD_X86
+        case SimdLevel::SSE2:
+            return __builtin_cpu_supports("sse2");
+        case SimdLevel::AVX2:
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        case SimdLevel::AVX512:
+            return __builtin_cpu_supports("avx512f");
+#endif
+        default:
+            return false;
+    }
+}
+
+KernelTable tableFor(SimdLevel level) {
+    switch (level) {
+#ifdef MI_SIMD_X86
+        case SimdLevel::AVX512:
+            return {level, fhnRowAVX512, fhnRowAVX512Float, fhnRow7AVX512, fhnEnsembleRowAVX512,
+                    laplacianRowAVX512, ninePointRowAVX512<true>, ninePointRowAVX512<false>,
+                    luoRudyRowAVX512, tenTusscherRowAVX512};
+        case SimdLevel::AVX2:
+            return {level, fhnRowAVX2, fhnRowAVX2Float, fhnRow7AVX2, fhnEnsembleRowAVX2,
+                    laplacianRowAVX2, ninePointRowAVX2<true>, ninePointRowAVX2<false>,
+                    luoRudyRowAVX2, tenTusscherRowAVX2};
+        case SimdLevel::SSE2:
+            return {level, fhnRowSSE2, fhnRowSSE2Float, fhnRow7SSE2, fhnEnsembleRowSSE2,
+                    laplacianRowSSE2, ninePointRowSSE2<true>, ninePointRowSSE2<false>,
+                    luoRudyRowSSE2, tenTusscherRowSSE2};
+#endif
+        default:
+            return {SimdLevel::Scalar, fhnRowScalar<double>, fhnRowScalar<float>, fhnRow7Scalar,
+                    fhnEnsembleRowScalar, laplacianRowScalar, ninePointRowScalar<true>,
+                    ninePointRowScalar<false>, luoRudyRowScalar, tenTusscherRowScalar};
+    }
+}
+
+KernelTable initialTable() {
+    SimdLevel level = StencilKernels::detectSimdLevel();
+
+    // Allow a lower level to be forced for testing and benchmarking
+    if (const char* requested = std::getenv("MI_SIMD")) {
+        for (SimdLevel candidate : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512}) {
+            if (std::strcmp(requested, StencilKernels::simdLevelName(candidate)) == 0 &&
+                candidate <= level) {
+                level = candidate;
+            }
+        }
+    }
+    return tableFor(level);
+}
+
+KernelTable& activeTable() {
+    static KernelTable table = initialTable();
+    return table;
+}
+
+} // namespace
+
+void StencilKernels::fhnRow(const FHNRowPointers<double>& rows, int x_begin, int x_end,
+                            const FHNCoefficients<double>& coeff) {
+    activeTable().fhn_row(rows, x_begin, x_end, coeff);
+}
+
+void StencilKernels::fhnRow(const FHNRowPointers<float>& rows, int x_begin, int x_end,
+                            const FHNCoefficients<float>& coeff) {
+    activeTable().fhn_row_float(rows, x_begin, x_end, coeff);
+}
+
+void StencilKernels::fhnRow7(const FHNRowPointers3D& rows, int x_begin, int x_end,
+                             const FHNCoefficients<double>& coeff) {
+    activeTable().fhn_row7(rows, x_begin, x_end, coeff);
+}
+
+void StencilKernels::fhnEnsembleRow(const FHNRowPointers<double>& rows, int x_begin, int x_end, int members,
+                                    const FHNEnsembleCoefficients& coeff) {
+    activeTable().fhn_ensemble_row(rows, x_begin, x_end, members, coeff);
+}
+
+void StencilKernels::laplacianRow(const double* up, const double* row, const double* down,
+                                  double coeff, double* out, int x_begin, int x_end) {
+    activeTable().laplacian_row(up, row, down, coeff, out, x_begin, x_end);
+}
+
+void StencilKernels::ninePointRow(const NinePointRowPointers& rows, int x_begin, int x_end) {
+    const KernelTable& table = activeTable();
+    (rows.south_east ? table.nine_point_row : table.five_point_row)(rows, x_begin, x_end);
+}
+
+void StencilKernels::luoRudyRow(const LuoRudyRowPointers& rows, int x_begin, int x_end,
+                                const LuoRudyCoefficients& coeff) {
+    activeTable().luo_rudy_row(rows, x_begin, x_end, coeff);
+}
+
+void StencilKernels::tenTusscherRow(const TenTusscherRowPointers& rows, int x_begin, int x_end,
+                                    const TenTusscherCoefficients& coeff) {
+    activeTable().ten_tusscher_row(rows, x_begin, x_end, coeff);
+}
+
+SimdLevel StencilKernels::detectSimdLevel() {
+    for (SimdLevel level : {SimdLevel::AVX512, SimdLevel::AVX2, SimdLevel::SSE2}) {
+        if (isSupported(level)) {
+            return level;
+        }
+    }
+    return SimdLevel::Scalar;
+}
+
+SimdLevel StencilKernels::getSimdLevel() {
+    return activeTable().level;
+}
+
+bool StencilKernels::setSimdLevel(SimdLevel level) {
+    if (!isSupported(level)) {
+        return false;
+    }
+    activeTable() = tableFor(level);
+    return true;
+}
+
+const char* StencilKernels::simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::SSE2: return "sse2";
+        case SimdLevel::AVX2: return "avx2";
+        case SimdLevel::AVX512: return "avx512";
+        default: return "scalar";
+    }
+}
@@ -0,0 +1,155 @@
+#include "StimulusSchedule.h"
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <tuple>
+
+StimulusRegion StimulusRegion::point(int x, int y) {
+    StimulusRegion region;
+    region.cells_.emplace_back(x, y);
+    return region;
+}
+
+StimulusRegion StimulusRegion::rectangle(int x_begin, int y_begin, int x_end, int y_end) {
+    StimulusRegion region;
+    for (int y = y_begin; y < y_end; ++y) {
+        for (int x = x_begin; x < x_end; ++x) {
+            region.cells_.emplace_back(x, y);
+        }
+    }
+    return region;
+}
+
+StimulusRegion StimulusRegion::mask(const std::vector<std::vector<bool>>& mask) {
+    StimulusRegion region;
+    for (int y = 0; y < static_cast<int>(mask.size()); ++y) {
+        for (int x = 0; x < static_cast<int>(mask[y].size()); ++x) {
+            if (mask[y][x]) {
+                region.cells_.emplace_back(x, y);
+            }
+        }
+    }
+    return region;
+}
+
+StimulusSchedule::StimulusSchedule() {
+    compile(0, 0);
+}
+
+void StimulusSchedule::addPulse(const StimulusRegion& region, double strength, double start, double duration,
+                                double period, int count) {
+    if (duration <= 0.0 || count <= 0) {
+        return;
+    }
+    pulses_.push_back({region, strength, start, duration, count > 1 ? period : 0.0, count});
+}
+
+void StimulusSchedule::addS1S2(const StimulusRegion& s1_region, const StimulusRegion& s2_region, double strength,
+                               double duration, double start, double s1_interval, int s1_count,
+                               double s2_coupling) {
+    addPulse(s1_region, strength, start, duration, s1_interval, s1_count);
+    double last_s1 = start + std::max(s1_count - 1, 0) * s1_interval;
+    addPulse(s2_region, strength, last_s1 + s2_coupling, duration);
+}
+
+void StimulusSchedule::clear() {
+    pulses_.clear();
+    compile(0, 0);
+}
+
+void StimulusSchedule::compile(int width, int height) {
+    window_starts_.clear();
+    window_patterns_.clear();
+    patterns_.assign(1, StimulusPattern());
+    patterns_[0].row_offsets.push_back(0);
+
+    // Onsets (+1) and offsets (-1) of every pulse; at equal times offsets
+    // sort first, so back-to-back pulses do not count as overlapping
+    std::vector<std::tuple<double, int, int>> events;
+    for (int p = 0; p < static_cast<int>(pulses_.size()); ++p) {
+        const Pulse& pulse = pulses_[p];
+        for (int k = 0; k < pulse.count; ++k) {
+            double onset = pulse.start + k * pulse.period;
+            events.emplace_back(onset, +1, p);
+            events.emplace_back(onset + pulse.duration, -1, p);
+        }
+    }
+    std::sort(events.begin(), events.end());
+
+    std::map<std::vector<int>, int> pattern_ids;
+    pattern_ids[std::vector<int>()] = 0;
+    std::vector<int> active(pulses_.size(), 0);
+
+    for (std::size_t i = 0; i < events.size();) {
+        const double t = std::get<0>(events[i]);
+        for (; i < events.size() && std::get<0>(events[i]) == t; ++i) {
+            active[std::get<2>(events[i])] += std::get<1>(events[i]);
+        }
+
+        std::vector<int> key;
+        for (int p = 0; p < static_cast<int>(active.size()); ++p) {
+            if (active[p] > 0) {
+                key.push_back(p);
+            }
+        }
+
+        auto found = pattern_ids.find(key);
+        int id;
+        if (found != pattern_ids.end()) {
+            id = found->second;
+        } else {
+            // Sum the strengths of all active pulses per cell, row-major
+            std::vector<std::tuple<int, int, double>> cells;
+            for (int p : key) {
+                for (const auto& cell : pulses_[p].region.cells()) {
+                    if (cell.first >= 0 && cell.first < width && cell.second >= 0 && cell.second < height) {
+                        cells.emplace_back(cell.second, cell.first, pulses_[p].strength);
+                    }
+                }
+            }
+            std::sort(cells.begin(), cells.end());
+
+            StimulusPattern pattern;
+            for (std::size_t c = 0; c < cells.size(); ++c) {
+                int y = std::get<0>(cells[c]);
+                int x = std::get<1>(cells[c]);
+                if (!pattern.cells.empty() && pattern.rows.back() == y && pattern.cells.back().x == x) {
+                    pattern.cells.back().strength += std::get<2>(cells[c]);
+                    continue;
+                }
+                if (pattern.rows.empty() || pattern.rows.back() != y) {
+                    pattern.rows.push_back(y);
+                    pattern.row_offsets.push_back(static_cast<int>(pattern.cells.size()));
+                }
+                pattern.cells.push_back({x, std::get<2>(cells[c])});
+            }
+            pattern.row_offsets.push_back(static_cast<int>(pattern.cells.size()));
+
+            id = static_cast<int>(patterns_.size());
+            patterns_.push_back(pattern);
+            pattern_ids[key] = id;
+        }
+
+        int previous = window_patterns_.empty() ? 0 : window_patterns_.back();
+        if (id != previous) {
+            window_starts_.push_back(t);
+            window_patterns_.push_back(id);
+        }
+    }
+}
+
+int StimulusSchedule::patternAt(double t) const {
+    auto next = std::upper_bound(window_starts_.begin(), window_starts_.end(), t);
+    if (next == window_starts_.begin()) {
+        return 0;
+    }
+    return window_patterns_[next - window_starts_.begin() - 1];
+}
+
+double StimulusSchedule::nextChange(double t) const {
+    auto next = std::upper_bound(window_starts_.begin(), window_starts_.end(), t);
+    if (next == window_starts_.end()) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return *next;
+}
@@ -0,0 +1,89 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+Barrier::Barrier(int count)
+    : count_(std::max(count, 1)), arrived_(0), generation_(0) {
+}
+
+int ThreadPool::hardwareConcurrency() {
+    unsigned int n = std::thread::hardware_concurrency();
+    return n > 0 ? static_cast<int>(n) : 1;
+}
+
+ThreadPool::ThreadPool(int num_threads)
+    : barrier_(num_threads > 0 ? num_threads : hardwareConcurrency()),
+      task_(nullptr), job_generation_(0), pending_(0), stop_(false) {
+
+    int total = num_threads > 0 ? num_threads : hardwareConcurrency();
+    workers_.reserve(total - 1);
+    for (int i = 1; i < total; ++i) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    start_cv_.notify_all();
+
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::run(const std::function<void(int)>& task) {
+    if (workers_.empty()) {
+        task(0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = &task;
+        pending_ = static_cast<int>(workers_.size());
+        ++job_generation_;
+    }
+    start_cv_.notify_all();
+
+    // The calling thread works as thread 0
+    task(0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return pending_ == 0; });
+    task_ = nullptr;
+}
+
+std::pair<int, int> ThreadPool::partition(int thread_index, int begin, int end) const {
+    long long count = end - begin;
+    int n = size();
+    int chunk_begin = begin + static_cast<int>(count * thread_index / n);
+    int chunk_end = begin + static_cast<int>(count * (thread_index + 1) / n);
+    return {chunk_begin, chunk_end};
+}
+
+void ThreadPool::workerLoop(int thread_index) {
+    unsigned long seen_generation = 0;
+
+    while (true) {
+        const std::function<void(int)>* task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_cv_.wait(lock, [&] { return stop_ || job_generation_ != seen_generation; });
+            if (stop_) {
+                return;
+            }
+            seen_generation = job_generation_;
+            task = task_;
+        }
+
+        (*task)(thread_index);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --pending_;
+        }
+        done_cv_.notify_one();
+    }
+}
@@ -2,8 +2,10 @@
 #include <string>
 #include <chrono>
 #include <cmath>
+#include <vector>
 #include "DTM.h"
 #include "FitzHughNagumo.h"
+#include "StencilKernels.h"
 
 /**
  * @file main.cpp
@@ -14,11 +16,14 @@ void printUsage(const std::string& programName) {
     std::cout << "Usage: " << programName << " [options]\n";
     std::cout << "Options:\n";
     std::cout << "  --dtm <filename>     Load and process DTM data\n";
-    std::cout << "  --fhn <width> <height> [steps]  Run FitzHugh-Nagumo simulation\n";
+    std::cout << "  --fhn <width> <height> [steps] [threads]  Run FitzHugh-Nagumo simulation\n";
+    std::cout << "  --fhn-float <width> <height> [steps] [threads]  Compare single and double precision FHN\n";
     std::cout << "  --help              Show this help message\n";
     std::cout << "\nExamples:\n";
     std::cout << "  " << programName << " --dtm terrain.dat\n";
     std::cout << "  " << programName << " --fhn 100 100 1000\n";
+    std::cout << "  " << programName << " --fhn 2048 2048 100 8\n";
+    std::cout << "  " << programName << " --fhn-float 1024 1024 500\n";
 }
 
 void runDTMDemo() {
@@ -53,12 +58,13 @@ void runDTMDemo() {
     }
 }
 
-void runFitzHughNagumoDemo(int width, int height, int steps) {
+void runFitzHughNagumoDemo(int width, int height, int steps, int threads = 1) {
     std::cout << "\n=== FitzHugh-Nagumo Model Demo ===\n";
     
     // Create simulation
     FitzHughNagumo fhn(width, height, 0.01);
     fhn.initialize();
+    fhn.setNumThreads(threads);
     
     // Set model parameters (typical values for excitable media)
     fhn.setParameters(0.1, 0.5, 1.0, 0.0);
@@ -70,6 +76,8 @@ void runFitzHughNagumoDemo(int width, int height, int steps) {
     fhn.addStimulus(center_x, center_y, 1.0, 10.0);
     
     std::cout << "Grid size: " << width << "x" << height << "\n";
+    std::cout << "Threads: " << fhn.getNumThreads() << "\n";
+    std::cout << "SIMD kernels: " << StencilKernels::simdLevelName(StencilKernels::getSimdLevel()) << "\n";
     std::cout << "Running " << steps << " time steps...\n";
     
     auto start_time = std::chrono::high_resolution_clock::now();
@@ -91,6 +99,63 @@ void runFitzHughNagumoDemo(int width, int height, int steps) {
     }
 }
 
+/**
+ * @brief Set up a solver with the demo parameters and a central stimulus
+ */
+template <typename T>
+void setupFitzHughNagumoDemo(BasicFitzHughNagumo<T>& fhn, int width, int height, int threads) {
+    std::vector<std::vector<double>> u_init(height, std::vector<double>(width));
+    std::vector<std::vector<double>> v_init(height, std::vector<double>(width));
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            u_init[y][x] = 0.01 * std::sin(0.3 * x + 0.7 * y);
+            v_init[y][x] = 0.005 * std::cos(0.2 * x - 0.1 * y);
+        }
+    }
+    
+    fhn.setNumThreads(threads);
+    fhn.setInitialConditions(u_init, v_init);
+    fhn.setParameters(0.1, 0.5, 1.0, 0.0);
+    fhn.setDiffusionCoefficients(0.1, 0.0);
+    fhn.addStimulus(width / 2, height / 2, 1.0, 10.0);
+}
+
+/**
+ * @brief Time the float and double solvers and report the float deviation
+ */
+void runPrecisionComparison(int width, int height, int steps, int threads) {
+    std::cout << "\n=== FitzHugh-Nagumo Precision Comparison ===\n";
+    std::cout << "Grid size: " << width << "x" << height << "\n";
+    std::cout << "SIMD kernels: " << StencilKernels::simdLevelName(StencilKernels::getSimdLevel()) << "\n";
+    
+    FitzHughNagumo fhn_double(width, height, 0.01);
+    setupFitzHughNagumoDemo(fhn_double, width, height, threads);
+    auto start_time = std::chrono::high_resolution_clock::now();
+    fhn_double.run(steps);
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::cout << "Double precision: "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count() << " ms\n";
+    
+    FitzHughNagumoF fhn_float(width, height, 0.01);
+    setupFitzHughNagumoDemo(fhn_float, width, height, threads);
+    start_time = std::chrono::high_resolution_clock::now();
+    fhn_float.run(steps);
+    end_time = std::chrono::high_resolution_clock::now();
+    std::cout << "Single precision: "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count() << " ms\n";
+    
+    // Same inputs again, checked against a double run after every step
+    FitzHughNagumoF fhn_checked(width, height, 0.01);
+    fhn_checked.setAccuracyComparison(true);
+    setupFitzHughNagumoDemo(fhn_checked, width, height, threads);
+    fhn_checked.run(steps);
+    
+    PrecisionDeviation deviation = fhn_checked.getPrecisionDeviation();
+    std::cout << "Max |u - u_double|: " << deviation.max_abs_u << "\n";
+    std::cout << "Max |v - v_double|: " << deviation.max_abs_v << "\n";
+    std::cout << "Steps compared: " << deviation.steps_compared << "\n";
+}
+
 int main(int argc, char* argv[]) {
     std::cout << "MI Modeling C++ Project\n";
     std::cout << "=======================\n";
@@ -139,13 +204,33 @@ int main(int argc, char* argv[]) {
         int width = std::stoi(argv[2]);
         int height = std::stoi(argv[3]);
         int steps = (argc > 4) ? std::stoi(argv[4]) : 1000;
+        int threads = (argc > 5) ? std::stoi(argv[5]) : 1;
+        
+        if (width <= 0 || height <= 0 || steps <= 0) {
+            std::cerr << "Error: Width, height, and steps must be positive integers\n";
+            return 1;
+        }
+        
+        runFitzHughNagumoDemo(width, height, steps, threads);
+    }
+    else if (arg1 == "--fhn-float") {
+        if (argc < 4) {
+            std::cerr << "Error: Width and height required for precision comparison\n";
+            printUsage(argv[0]);
+            return 1;
+        }
+        
+        int width = std::stoi(argv[2]);
+        int height = std::stoi(argv[3]);
+        int steps = (argc > 4) ? std::stoi(argv[4]) : 1000;
+        int threads = (argc > 5) ? std::stoi(argv[5]) : 1;
         
         if (width <= 0 || height <= 0 || steps <= 0) {
             std::cerr << "Error: Width, height, and steps must be positive integers\n";
             return 1;
         }
         
-        runFitzHughNagumoDemo(width, height, steps);
+        runPrecisionComparison(width, height, steps, threads);
     }
     else {
         std::cerr << "Error: Unknown argument " << arg1 << "\n";
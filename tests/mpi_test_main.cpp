@@ -0,0 +1,277 @@
+#include <mpi.h>
+#include <iostream>
+#include <cmath>
+#include <memory>
+#include "CardiacElectrophysiology.h"
+#include "DistributedCardiacModel.h"
+#include "DistributedFitzHughNagumo.h"
+#include "FitzHughNagumo.h"
+#include "StimulusSchedule.h"
+
+/**
+ * @file mpi_test_main.cpp
+ * @brief Tests of the MPI domain decomposition; run with mpirun -np N
+ *
+ * Every rank runs the distributed solver; rank 0 also runs the serial
+ * solver and compares the gathered result.
+ */
+
+namespace {
+
+int worldRank() {
+    int rank = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    return rank;
+}
+
+// Agree on a result across ranks
+bool allRanks(bool ok) {
+    int local = ok ? 1 : 0;
+    int global = 0;
+    MPI_Allreduce(&local, &global, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    return global == 1;
+}
+
+double initialU(int x, int y) {
+    return 0.5 * std::sin(0.3 * x + 0.7 * y);
+}
+
+double initialV(int x, int y) {
+    return 0.1 * std::cos(0.2 * x - 0.1 * y);
+}
+
+} // namespace
+
+bool testDistributedFitzHughNagumo() {
+    const bool root = worldRank() == 0;
+    if (root) {
+        std::cout << "Testing distributed FitzHugh-Nagumo..." << std::endl;
+    }
+
+    const int width = 53;
+    const int height = 41;
+    const double dt = 0.02;
+    const int steps = 300;
+
+    StimulusSchedule protocol;
+    protocol.addPulse(StimulusRegion::rectangle(0, 0, 4, height), 1.5, 0.0, 0.5, 3.0, 2);
+
+    bool ok = true;
+    for (double dv : {0.0, 0.05}) {
+        DistributedFitzHughNagumo distributed(width, height, dt);
+        distributed.setParameters(0.7, 0.8, 3.0, 0.0);
+        distributed.setDiffusionCoefficients(0.2, dv);
+        distributed.setInitialConditions(initialU, initialV);
+        distributed.setStimulusSchedule(protocol);
+        distributed.run(steps);
+        auto u = distributed.gatherU();
+        auto v = distributed.gatherV();
+
+        if (!root) {
+            if (!u.empty()) {
+                ok = false;
+            }
+            continue;
+        }
+
+        std::vector<std::vector<double>> u_init(height, std::vector<double>(width));
+        std::vector<std::vector<double>> v_init(height, std::vector<double>(width));
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                u_init[y][x] = initialU(x, y);
+                v_init[y][x] = initialV(x, y);
+            }
+        }
+        FitzHughNagumo serial(width, height, dt);
+        serial.setParameters(0.7, 0.8, 3.0, 0.0);
+        serial.setDiffusionCoefficients(0.2, dv);
+        serial.setInitialConditions(u_init, v_init);
+        serial.setStimulusSchedule(protocol);
+        serial.run(steps);
+        auto u_serial = serial.getU();
+        auto v_serial = serial.getV();
+
+        for (int y = 0; y < height && ok; ++y) {
+            for (int x = 0; x < width; ++x) {
+                if (u[y][x] != u_serial[y][x] || v[y][x] != v_serial[y][x]) {
+                    std::cerr << "Error: Distributed FitzHugh-Nagumo (dv = " << dv << ") differs at ("
+                              << x << ", " << y << ")" << std::endl;
+                    ok = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    // Replacing the schedule while a pulse is on ends the pulse
+    {
+        const int replace_width = 20;
+        const int replace_height = 16;
+        DistributedFitzHughNagumo distributed(replace_width, replace_height, dt);
+        distributed.addStimulus(8, 8, 1.0, 100.0);
+        distributed.run(20);
+        distributed.setStimulusSchedule(StimulusSchedule());
+        distributed.run(180);
+        auto u = distributed.gatherU();
+
+        if (root) {
+            FitzHughNagumo serial(replace_width, replace_height, dt);
+            serial.addStimulus(8, 8, 1.0, 100.0);
+            serial.run(20);
+            serial.setStimulusSchedule(StimulusSchedule());
+            serial.run(180);
+            auto u_serial = serial.getU();
+
+            for (int y = 0; y < replace_height && ok; ++y) {
+                for (int x = 0; x < replace_width; ++x) {
+                    if (u[y][x] != u_serial[y][x]) {
+                        std::cerr << "Error: Distributed FitzHugh-Nagumo keeps a replaced stimulus at (" << x
+                                  << ", " << y << ")" << std::endl;
+                        ok = false;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    ok = allRanks(ok);
+    if (ok && root) {
+        std::cout << "Distributed FitzHugh-Nagumo tests passed!" << std::endl;
+    }
+    return ok;
+}
+
+bool testDistributedCardiacModel() {
+    const bool root = worldRank() == 0;
+    if (root) {
+        std::cout << "Testing distributed cardiac models..." << std::endl;
+    }
+
+    const int width = 23;
+    const int height = 19;
+    const double dt = 0.01;
+    const int steps = 40;
+    auto potential = [](int x, int y) { return -80.0 + 6.0 * std::sin(0.4 * x + 0.3 * y); };
+    auto scar = [](int x, int y) { return x >= 12 && x < 16 && y >= 6 && y < 12; };
+
+    // Fibers select the 9-point stencil, which reads the corner halo cells
+    auto fiber_angle = [](int x, int y) { return 0.7 + 0.05 * (x - y); };
+
+    // Steps overlap the exchange with the interior update. Cases, for
+    // Luo-Rudy and ten Tusscher each: 5-point; 9-point with a fixed edge;
+    // 9-point with zero flux, whose ghost cells beside the halo are stale
+    // while the interior is stepped; the same split into row bands over threads
+    bool ok = true;
+    for (int model_type = 0; model_type < 8; ++model_type) {
+        const int variant = model_type / 2;
+        const bool fibers = variant >= 1;
+        const bool fixed = variant == 1;
+        const bool threads = variant == 3;
+        auto factory = [model_type](int w, int h, double step) -> std::unique_ptr<CardiacElectrophysiology> {
+            if (model_type % 2 == 0) {
+                return std::unique_ptr<CardiacElectrophysiology>(new LuoRudyModel(w, h, step));
+            }
+            return std::unique_ptr<CardiacElectrophysiology>(new TenTusscherModel(w, h, step));
+        };
+
+        DistributedCardiacModel distributed(width, height, dt, factory);
+        distributed.setConductivity(0.5);
+        if (fibers && !distributed.setFiberOrientation(fiber_angle, 1.0, 0.3)) {
+            ok = false;
+        }
+        if (fixed && !distributed.setBoundaryCondition(BoundaryCondition::Fixed, -82.0)) {
+            ok = false;
+        }
+        if (threads) {
+            distributed.getLocalModel().setNumThreads(3);
+        }
+        distributed.setMIRegion(scar);
+        distributed.setMembranePotential(potential);
+        distributed.run(steps);
+        auto V = distributed.gatherMembranePotential();
+
+        if (!root) {
+            continue;
+        }
+
+        auto serial = factory(width, height, dt);
+        serial->setConductivity(0.5);
+        std::vector<std::vector<bool>> region(height, std::vector<bool>(width));
+        std::vector<std::vector<double>> angle(height, std::vector<double>(width));
+        for (int y = 0; y < height; ++y) {
+            double* row = serial->membranePotentialRow(y);
+            for (int x = 0; x < width; ++x) {
+                region[y][x] = scar(x, y);
+                angle[y][x] = fiber_angle(x, y);
+                row[x] = potential(x, y);
+            }
+        }
+        if (fibers) {
+            serial->setFiberOrientation(angle, 1.0, 0.3);
+        }
+        if (fixed) {
+            serial->setBoundaryCondition(BoundaryCondition::Fixed, -82.0);
+        }
+        serial->setMIRegion(region);
+        serial->run(steps);
+        auto V_serial = serial->getMembranePotential();
+
+        for (int y = 0; y < height && ok; ++y) {
+            for (int x = 0; x < width; ++x) {
+                if (!std::isfinite(V_serial[y][x]) || V[y][x] != V_serial[y][x]) {
+                    std::cerr << "Error: Distributed cardiac model " << model_type % 2 << " case " << variant
+                              << " differs at (" << x << ", " << y << ")" << std::endl;
+                    ok = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    // Periodic boundaries would wrap around each rank's block: rejected
+    DistributedCardiacModel periodic(width, height, dt, [](int w, int h, double step) {
+        std::unique_ptr<CardiacElectrophysiology> model(new LuoRudyModel(w, h, step));
+        model->setBoundaryCondition(BoundaryCondition::Periodic);
+        return model;
+    });
+    if (periodic.getLocalModel().getBoundaryCondition() != BoundaryCondition::ZeroFlux ||
+        periodic.setBoundaryCondition(BoundaryCondition::Periodic)) {
+        std::cerr << "Error: Periodic boundary accepted by the distributed cardiac model" << std::endl;
+        ok = false;
+    }
+
+    ok = allRanks(ok);
+    if (ok && root) {
+        std::cout << "Distributed cardiac model tests passed!" << std::endl;
+    }
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    MPI_Init(&argc, &argv);
+
+    int size = 1;
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    if (worldRank() == 0) {
+        std::cout << "Running MPI tests on " << size << " ranks..." << std::endl;
+    }
+
+    int passed_tests = 0;
+    int total_tests = 2;
+
+    if (testDistributedFitzHughNagumo()) {
+        passed_tests++;
+    }
+
+    if (testDistributedCardiacModel()) {
+        passed_tests++;
+    }
+
+    if (worldRank() == 0) {
+        std::cout << "Test Results: " << passed_tests << "/" << total_tests << " tests passed" << std::endl;
+    }
+
+    MPI_Finalize();
+    return passed_tests == total_tests ? 0 : 1;
+}
@@ -1,8 +1,21 @@
 #include <iostream>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include "ADIDiffusion.h"
+#include "AlignedGrid.h"
+#include "CardiacElectrophysiology.h"
 #include "DTM.h"
 #include "FitzHughNagumo.h"
+#include "FitzHughNagumo3D.h"
+#include "FitzHughNagumoEnsemble.h"
+#include "RateTable.h"
+#include "ScarMask.h"
+#include "SnapshotWriter.h"
+#include "SparseDiffusion.h"
+#include "StencilKernels.h"
+#include "StimulusSchedule.h"
 #include "ValidationFramework.h"
 
 /**
@@ -105,6 +118,1984 @@ bool testFitzHughNagumoBasicFunctionality() {
     }
 }
 
+bool testFitzHughNagumoBinaryCheckpoint() {
+    std::cout << "Testing FitzHugh-Nagumo binary checkpoints..." << std::endl;
+    
+    try {
+        const int width = 37;
+        const int height = 19;
+        std::vector<std::vector<double>> u_init(height, std::vector<double>(width));
+        std::vector<std::vector<double>> v_init(height, std::vector<double>(width));
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                u_init[y][x] = 0.7 * std::sin(0.3 * x + 0.2 * y);
+                v_init[y][x] = 0.2 * std::cos(0.1 * x - 0.4 * y);
+            }
+        }
+        
+        FitzHughNagumo original(width, height, 0.01);
+        original.setInitialConditions(u_init, v_init);
+        original.setParameters(0.12, 0.6, 1.5, 0.3);
+        original.setDiffusionCoefficients(0.15, 0.01);
+        original.run(17);
+        if (!original.saveState("test_fhn_checkpoint.bin", StateFormat::Binary)) {
+            std::cerr << "Error: Binary checkpoint save failed" << std::endl;
+            return false;
+        }
+        
+        // A double restart must continue bit-identically
+        FitzHughNagumo restarted(width, height, 0.01);
+        if (!restarted.loadState("test_fhn_checkpoint.bin") || restarted.getTime() != original.getTime()) {
+            std::cerr << "Error: Binary checkpoint load failed" << std::endl;
+            return false;
+        }
+        original.run(5);
+        restarted.run(5);
+        auto u_original = original.getU();
+        auto u_restarted = restarted.getU();
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                if (u_original[y][x] != u_restarted[y][x]) {
+                    std::cerr << "Error: Restart from binary checkpoint differs at (" << x << ", " << y << ")" << std::endl;
+                    return false;
+                }
+            }
+        }
+        
+        // Double checkpoints load into the float solver, and a wrong size is rejected
+        FitzHughNagumoF converted(width, height, 0.01);
+        FitzHughNagumo wrong_size(width + 1, height, 0.01);
+        if (!converted.loadState("test_fhn_checkpoint.bin") ||
+            wrong_size.loadState("test_fhn_checkpoint.bin")) {
+            std::cerr << "Error: Binary checkpoint conversion or size check failed" << std::endl;
+            return false;
+        }
+        
+        // The text format is still detected and loaded
+        if (!original.saveState("test_fhn_checkpoint.txt") ||
+            !restarted.loadState("test_fhn_checkpoint.txt") ||
+            std::abs(restarted.getU()[5][7] - original.getU()[5][7]) > 1e-5) {
+            std::cerr << "Error: Text checkpoint round trip failed" << std::endl;
+            return false;
+        }
+        std::remove("test_fhn_checkpoint.bin");
+        std::remove("test_fhn_checkpoint.txt");
+        
+        std::cout << "FitzHugh-Nagumo binary checkpoint tests passed!" << std::endl;
+        return true;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "FitzHugh-Nagumo checkpoint test failed with exception: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool testFitzHughNagumoParallelStepping() {
+    std::cout << "Testing FitzHugh-Nagumo parallel stepping..." << std::endl;
+    
+    try {
+        const int width = 33;
+        const int height = 29;
+        std::vector<std::vector<double>> u_init(height, std::vector<double>(width));
+        std::vector<std::vector<double>> v_init(height, std::vector<double>(width));
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                u_init[y][x] = 0.01 * std::sin(0.3 * x + 0.7 * y);
+                v_init[y][x] = 0.005 * std::cos(0.2 * x - 0.1 * y);
+            }
+        }
+        
+        FitzHughNagumo serial(width, height, 0.01);
+        FitzHughNagumo parallel(width, height, 0.01);
+        for (FitzHughNagumo* fhn : {&serial, &parallel}) {
+            fhn->setInitialConditions(u_init, v_init);
+            fhn->setDiffusionCoefficients(0.1, 0.02);
+            fhn->addStimulus(10, 12, 1.0, 10.0);
+        }
+        parallel.setNumThreads(4);
+        
+        serial.run(50);
+        parallel.run(25);
+        parallel.step();
+        parallel.run(24);
+        
+        // Row bands must reproduce the serial sweep exactly
+        auto u_serial = serial.getU();
+        auto u_parallel = parallel.getU();
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                if (u_serial[y][x] != u_parallel[y][x]) {
+                    std::cerr << "Error: Parallel stepping differs at (" << x << ", " << y << ")" << std::endl;
+                    return false;
+                }
+            }
+        }
+        if (std::abs(serial.getTime() - parallel.getTime()) > 1e-12) {
+            std::cerr << "Error: Parallel stepping time mismatch" << std::endl;
+            return false;
+        }
+        
+        std::cout << "FitzHugh-Nagumo parallel stepping tests passed!" << std::endl;
+        return true;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "FitzHugh-Nagumo parallel test failed with exception: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool testFitzHughNagumoTemporalBlocking() {
+    std::cout << "Testing FitzHugh-Nagumo temporal blocking..." << std::endl;
+    
+    try {
+        const int width = 53;
+        const int height = 37;
+        const int steps = 23;
+        std::vector<std::vector<double>> u_init(height, std::vector<double>(width));
+        std::vector<std::vector<double>> v_init(height, std::vector<double>(width));
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                u_init[y][x] = 0.8 * std::sin(0.37 * x) * std::cos(0.21 * y);
+                v_init[y][x] = 0.1 * std::cos(0.13 * x + 0.4 * y);
+            }
+        }
+        
+        FitzHughNagumo naive(width, height, 0.02);
+        naive.setInitialConditions(u_init, v_init);
+        naive.setDiffusionCoefficients(0.2, 0.05);
+        naive.addStimulus(5, 30, 1.0, 10.0);
+        for (int i = 0; i < steps; ++i) {
+            naive.step();
+        }
+        auto expected = naive.getU();
+        
+        // Depths that divide the run and ones that leave a remainder, with
+        // narrow tiles so that tile seams cross the vector kernels
+        const int configs[][2] = {{2, 0}, {4, 16}, {5, 9}, {8, 24}, {23, 64}};
+        for (const auto& config : configs) {
+            FitzHughNagumo blocked(width, height, 0.02);
+            blocked.setInitialConditions(u_init, v_init);
+            blocked.setDiffusionCoefficients(0.2, 0.05);
+            blocked.addStimulus(5, 30, 1.0, 10.0);
+            blocked.setTemporalBlocking(config[0], config[1]);
+            blocked.run(steps);
+            
+            auto u = blocked.getU();
+            for (int y = 0; y < height; ++y) {
+                for (int x = 0; x < width; ++x) {
+                    if (u[y][x] != expected[y][x]) {
+                        std::cerr << "Error: Blocked run (" << config[0] << " steps, tile " << config[1]
+                                  << ") differs at (" << x << ", " << y << ")" << std::endl;
+                        return false;
+                    }
+                }
+            }
+            if (blocked.getTime() != naive.getTime()) {
+                std::cerr << "Error: Blocked run time mismatch" << std::endl;
+                return false;
+            }
+        }
+        
+        std::cout << "FitzHugh-Nagumo temporal blocking tests passed!" << std::endl;
+        return true;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "FitzHugh-Nagumo temporal blocking test failed with exception: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool testFitzHughNagumoActiveTiles() {
+    std::cout << "Testing FitzHugh-Nagumo active tiles..." << std::endl;
+    
+    try {
+        // With a = 0, u = v = 0 is an exact fixed point, so tissue away from
+        // the stimulus stays bit-for-bit quiescent until activity reaches it
+        const int width = 203;
+        const int height = 97;
+        const int steps = 40;
+        auto setup = [&](FitzHughNagumo& model) {
+            model.setParameters(0.0, 0.8, 12.5, 1.0);
+            model.setDiffusionCoefficients(0.2, 0.05);
+            model.addStimulus(10, 10, 1.0, 10.0);
+        };
+        
+        FitzHughNagumo full(width, height, 0.02);
+        setup(full);
+        full.run(steps);
+        full.addStimulus(180, 80, 1.0, 10.0);
+        full.run(steps);
+        auto expected = full.getU();
+        
+        for (int threads : {1, 3}) {
+            FitzHughNagumo active(width, height, 0.02);
+            setup(active);
+            active.setNumThreads(threads);
+            active.setActiveTiles(true);
+            active.run(steps);
+            if (!(active.getActiveTileFraction() < 1.0)) {
+                std::cerr << "Error: Quiescent tiles were not skipped" << std::endl;
+                return false;
+            }
+            // A new stimulus in a skipped region must wake it up
+            active.addStimulus(180, 80, 1.0, 10.0);
+            for (int i = 0; i < steps; ++i) {
+                active.step();
+            }
+            
+            auto u = active.getU();
+            for (int y = 0; y < height; ++y) {
+                for (int x = 0; x < width; ++x) {
+                    if (u[y][x] != expected[y][x]) {
+                        std::cerr << "Error: Active-tile run (" << threads << " threads) differs at ("
+                                  << x << ", " << y << ")" << std::endl;
+                        return false;
+                    }
+                }
+            }
+            if (active.getTime() != full.getTime()) {
+                std::cerr << "Error: Active-tile run time mismatch" << std::endl;
+                return false;
+            }
+        }
+        
+        std::cout << "FitzHugh-Nagumo active tiles tests passed!" << std::endl;
+        return true;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "FitzHugh-Nagumo active tiles test failed with exception: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool testFitzHughNagumoEnsemble() {
+    std::cout << "Testing FitzHugh-Nagumo ensemble..." << std::endl;
+    
+    try {
+        // 11 members: the slot count is padded, so padding lanes are exercised
+        const int width = 29;
+        const int height = 23;
+        const int members = 11;
+        const int steps = 60;
+        std::vector<std::vector<double>> u_init(height, std::vector<double>(width));
+        std::vector<std::vector<double>> v_init(height, std::vector<double>(width));
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                u_init[y][x] = 0.8 * std::sin(0.37 * x) * std::cos(0.21 * y);
+                v_init[y][x] = 0.1 * std::cos(0.13 * x + 0.4 * y);
+            }
+        }
+        auto parametersFor = [](int m) {
+            FHNMemberParameters p;
+            p.a = 0.5 + 0.05 * m;
+            p.b = 0.6 + 0.03 * m;
+            p.c = 2.0 + 1.5 * m;
+            p.du = 0.05 + 0.02 * m;
+            p.dv = 0.01 * (m % 3);
+            return p;
+        };
+        
+        for (int threads : {1, 3}) {
+            FitzHughNagumoEnsemble ensemble(width, height, members, 0.02);
+            ensemble.setNumThreads(threads);
+            ensemble.setInitialConditions(u_init, v_init);
+            for (int m = 0; m < members; ++m) {
+                ensemble.setMemberParameters(m, parametersFor(m));
+            }
+            // Member 7's pulse ends halfway through the run
+            ensemble.addStimulus(4, 6, 1.0, 10.0);
+            ensemble.addStimulus(7, 20, 3, 0.5, 0.6);
+            ensemble.run(steps);
+            
+            for (int m = 0; m < members; ++m) {
+                FHNMemberParameters p = parametersFor(m);
+                FitzHughNagumo single(width, height, 0.02);
+                single.setInitialConditions(u_init, v_init);
+                single.setParameters(p.a, p.b, p.c, p.d);
+                single.setDiffusionCoefficients(p.du, p.dv);
+                single.addStimulus(4, 6, 1.0, 10.0);
+                if (m == 7) {
+                    single.addStimulus(20, 3, 0.5, 0.6);
+                }
+                single.run(steps);
+                
+                auto expected_u = single.getU();
+                auto expected_v = single.getV();
+                auto u = ensemble.getU(m);
+                auto v = ensemble.getV(m);
+                for (int y = 0; y < height; ++y) {
+                    for (int x = 0; x < width; ++x) {
+                        if (std::abs(u[y][x] - expected_u[y][x]) > 1e-10 ||
+                            std::abs(v(x, y) - expected_v[y][x]) > 1e-10) {
+                            std::cerr << "Error: Ensemble member " << m << " (" << threads
+                                      << " threads) differs at (" << x << ", " << y << ")" << std::endl;
+                            return false;
+                        }
+                    }
+                }
+            }
+            if (std::abs(ensemble.getTime() - steps * 0.02) > 1e-12) {
+                std::cerr << "Error: Ensemble time mismatch" << std::endl;
+                return false;
+            }
+        }
+        
+        std::cout << "FitzHugh-Nagumo ensemble tests passed!" << std::endl;
+        return true;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "FitzHugh-Nagumo ensemble test failed with exception: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool testFitzHughNagumo3D() {
+    std::cout << "Testing FitzHugh-Nagumo 3D..." << std::endl;
+    
+    try {
+        const int width = 21;
+        const int height = 13;
+        const int depth = 9;
+        const int steps = 30;
+        const double dt = 0.02, du = 0.15, dv = 0.03, a = 0.7, b = 0.8, c = 3.0;
+        typedef std::vector<std::vector<std::vector<double>>> Field;
+        Field u_init(depth, std::vector<std::vector<double>>(height, std::vector<double>(width)));
+        Field v_init = u_init;
+        for (int z = 0; z < depth; ++z) {
+            for (int y = 0; y < height; ++y) {
+                for (int x = 0; x < width; ++x) {
+                    u_init[z][y][x] = 0.8 * std::sin(0.37 * x + 0.5 * z) * std::cos(0.21 * y);
+                    v_init[z][y][x] = 0.1 * std::cos(0.13 * x + 0.4 * y - 0.3 * z);
+                }
+            }
+        }
+        
+        for (Stencil3D stencil : {Stencil3D::SevenPoint, Stencil3D::NineteenPoint}) {
+            // Straightforward reference: outer faces reaction only, and the
+            // pulse on while the step midpoint is before its end
+            Field u = u_init, v = v_init;
+            for (int i = 0; i < steps; ++i) {
+                Field u_next = u, v_next = v;
+                for (int z = 0; z < depth; ++z) {
+                    for (int y = 0; y < height; ++y) {
+                        for (int x = 0; x < width; ++x) {
+                            double lap_u = 0.0, lap_v = 0.0;
+                            bool interior = x > 0 && x < width - 1 && y > 0 && y < height - 1 && z > 0 && z < depth - 1;
+                            if (interior) {
+                                for (int dz = -1; dz <= 1; ++dz) {
+                                    for (int dy = -1; dy <= 1; ++dy) {
+                                        for (int dx = -1; dx <= 1; ++dx) {
+                                            int order = std::abs(dx) + std::abs(dy) + std::abs(dz);
+                                            double weight = 0.0;
+                                            if (stencil == Stencil3D::SevenPoint) {
+                                                weight = order == 0 ? -6.0 : (order == 1 ? 1.0 : 0.0);
+                                            } else {
+                                                weight = order == 0 ? -4.0 : (order == 1 ? 1.0 / 3.0 : (order == 2 ? 1.0 / 6.0 : 0.0));
+                                            }
+                                            lap_u += weight * u[z + dz][y + dy][x + dx];
+                                            lap_v += weight * v[z + dz][y + dy][x + dx];
+                                        }
+                                    }
+                                }
+                            }
+                            double uc = u[z][y][x], vc = v[z][y][x];
+                            double stim = (x == 10 && y == 6 && z == 4 && (i + 0.5) * dt < 0.3) ? 1.0 : 0.0;
+                            u_next[z][y][x] = uc + dt * (du * lap_u + uc - uc * uc * uc / 3.0 - vc + stim);
+                            v_next[z][y][x] = vc + dt * (dv * lap_v + (uc + a - b * vc) / c);
+                        }
+                    }
+                }
+                u.swap(u_next);
+                v.swap(v_next);
+            }
+            
+            // Automatic and small bricks, serial and slab-parallel
+            const int configs[][2] = {{1, 0}, {1, 3}, {3, 0}, {3, 5}};
+            for (const auto& config : configs) {
+                FitzHughNagumo3D model(width, height, depth, dt);
+                model.setParameters(a, b, c, 0.0);
+                model.setDiffusionCoefficients(du, dv);
+                model.setInitialConditions(u_init, v_init);
+                model.addStimulus(10, 6, 4, 1.0, 0.3);
+                model.setStencil(stencil);
+                model.setNumThreads(config[0]);
+                model.setBlockHeight(config[1]);
+                model.run(steps);
+                
+                for (int z = 0; z < depth; ++z) {
+                    auto plane_u = model.getU(z);
+                    auto plane_v = model.getV(z);
+                    for (int y = 0; y < height; ++y) {
+                        for (int x = 0; x < width; ++x) {
+                            if (std::abs(plane_u[y][x] - u[z][y][x]) > 1e-10 ||
+                                std::abs(plane_v[y][x] - v[z][y][x]) > 1e-10) {
+                                std::cerr << "Error: 3D solution differs at (" << x << ", " << y << ", " << z
+                                          << ") with " << config[0] << " threads, block " << config[1] << std::endl;
+                                return false;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        
+        std::cout << "FitzHugh-Nagumo 3D tests passed!" << std::endl;
+        return true;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "FitzHugh-Nagumo 3D test failed with exception: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool testStimulusSchedule() {
+    std::cout << "Testing stimulus schedule..." << std::endl;
+    
+    try {
+        const int width = 40;
+        const int height = 30;
+        const double dt = 0.02;
+        
+        // S1-S2: S1 pulses at 0, 4, 8 on the left edge, S2 at 8 + 2.5 in a corner
+        StimulusSchedule protocol;
+        protocol.addS1S2(StimulusRegion::rectangle(0, 0, 3, height), StimulusRegion::rectangle(25, 20, 32, 27),
+                         2.0, 0.5, 0.0, 4.0, 3, 2.5);
+        protocol.compile(width, height);
+        if (protocol.patternCount() != 3 || protocol.patternAt(-1.0) != 0 ||
+            protocol.patternAt(4.2) != protocol.patternAt(0.0) || protocol.patternAt(4.6) != 0 ||
+            protocol.pattern(protocol.patternAt(10.6)).rows.size() != 7 ||
+            protocol.nextChange(10.6) != 11.0 || protocol.patternAt(11.0) != 0) {
+            std::cerr << "Error: S1-S2 protocol compiled incorrectly" << std::endl;
+            return false;
+        }
+        
+        auto setup = [&](FitzHughNagumo& model) {
+            model.setParameters(0.7, 0.8, 3.0, 0.0);
+            model.setDiffusionCoefficients(0.2, 0.0);
+            model.setStimulusSchedule(protocol);
+        };
+        const int steps = 600;
+        
+        FitzHughNagumo serial(width, height, dt);
+        setup(serial);
+        for (int i = 0; i < steps; ++i) {
+            serial.step();
+        }
+        auto expected = serial.getU();
+        
+        // Every fixed-step path switches the stimulus at the same steps
+        for (int mode = 0; mode < 3; ++mode) {
+            FitzHughNagumo model(width, height, dt);
+            setup(model);
+            if (mode == 0) {
+                model.setNumThreads(3);
+            } else if (mode == 1) {
+                model.setTemporalBlocking(7, 16);
+            } else {
+                model.setActiveTiles(true);
+            }
+            model.run(steps);
+            
+            auto u = model.getU();
+            for (int y = 0; y < height; ++y) {
+                for (int x = 0; x < width; ++x) {
+                    if (u[y][x] != expected[y][x]) {
+                        std::cerr << "Error: Scheduled stimulus run (mode " << mode << ") differs at ("
+                                  << x << ", " << y << ")" << std::endl;
+                        return false;
+                    }
+                }
+            }
+        }
+        
+        // addStimulus now honours its duration: once the pulse is over the model
+        // continues exactly like an unstimulated copy of its state
+        FitzHughNagumo pulsed(width, height, dt);
+        pulsed.setParameters(0.7, 0.8, 3.0, 0.0);
+        pulsed.setDiffusionCoefficients(0.2, 0.0);
+        pulsed.addStimulus(20, 15, 2.0, 0.5);
+        pulsed.run(30);
+        FitzHughNagumo unstimulated(width, height, dt);
+        unstimulated.setParameters(0.7, 0.8, 3.0, 0.0);
+        unstimulated.setDiffusionCoefficients(0.2, 0.0);
+        unstimulated.setInitialConditions(pulsed.getU(), pulsed.getV());
+        pulsed.run(20);
+        unstimulated.run(20);
+        auto u_pulsed = pulsed.getU();
+        auto u_unstimulated = unstimulated.getU();
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                if (u_pulsed[y][x] != u_unstimulated[y][x]) {
+                    std::cerr << "Error: Stimulus still applied after its duration" << std::endl;
+                    return false;
+                }
+            }
+        }
+        
+        // Adaptive steps stop at every switch and track a fine Euler solution
+        FitzHughNagumo fine(width, height, 0.001);
+        setup(fine);
+        fine.run(12000);
+        FitzHughNagumo adaptive(width, height, 0.02);
+        setup(adaptive);
+        adaptive.setIntegrator(TimeIntegrator::AdaptiveRK23, 1e-4, 1e-6);
+        adaptive.run(600);
+        auto u_fine = fine.getU();
+        auto u_adaptive = adaptive.getU();
+        double max_error = 0.0;
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                max_error = std::max(max_error, std::abs(u_adaptive[y][x] - u_fine[y][x]));
+            }
+        }
+        if (max_error > 2e-2) {
+            std::cerr << "Error: Adaptive run with stimulus protocol deviates by " << max_error << std::endl;
+            return false;
+        }
+        
+        std::cout << "Stimulus schedule tests passed!" << std::endl;
+        return true;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Stimulus schedule test failed with exception: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool testSnapshotWriter() {
+    std::cout << "Testing snapshot writer..." << std::endl;
+    
+    try {
+        const int width = 37;
+        const int height = 23;
+        const double dt = 0.02;
+        const int interval = 10;
+        const int steps = 95;
+    
+        auto setup = [&](FitzHughNagumo& model) {
+            model.setParameters(0.7, 0.8, 3.0, 0.0);
+            model.setDiffusionCoefficients(0.2, 0.0);
+            model.addStimulus(5, 5, 1.5, 0.4);
+        };
+    
+        // Reference frames taken synchronously every interval steps
+        FitzHughNagumo serial(width, height, dt);
+        setup(serial);
+        std::vector<std::vector<std::vector<double>>> expected_u, expected_v;
+        std::vector<double> expected_time;
+        for (int i = 1; i <= steps; ++i) {
+            serial.step();
+            if (i % interval == 0) {
+                expected_u.push_back(serial.getU());
+                expected_v.push_back(serial.getV());
+                expected_time.push_back(serial.getTime());
+            }
+        }
+    
+        // Serial, pooled and temporally blocked runs record identical frames
+        for (int mode = 0; mode < 3; ++mode) {
+            SnapshotWriter writer;
+            if (!writer.open("test_fhn_frames.bin", width, height, false, kSnapshotU | kSnapshotV, 2)) {
+                return false;
+            }
+            FitzHughNagumo model(width, height, dt);
+            setup(model);
+            if (mode == 1) {
+                model.setNumThreads(3);
+            } else if (mode == 2) {
+                model.setTemporalBlocking(7, 16);
+            }
+            model.setOutput(&writer, interval);
+            model.run(steps);
+            if (!writer.close() || writer.getFramesWritten() != static_cast<long long>(expected_u.size())) {
+                std::cerr << "Error: Snapshot writer (mode " << mode << ") wrote "
+                          << writer.getFramesWritten() << " frames" << std::endl;
+                return false;
+            }
+    
+            SnapshotReader reader;
+            if (!reader.open("test_fhn_frames.bin") || reader.getFrameCount() != static_cast<long long>(expected_u.size()) ||
+                reader.getWidth() != width || reader.getHeight() != height || reader.isSinglePrecision()) {
+                std::cerr << "Error: Snapshot file (mode " << mode << ") has the wrong layout" << std::endl;
+                return false;
+            }
+            for (long long frame = 0; frame < reader.getFrameCount(); ++frame) {
+                if (reader.getStep(frame) != (frame + 1) * interval || reader.getTime(frame) != expected_time[frame] ||
+                    reader.getField(frame, kSnapshotU) != expected_u[frame] ||
+                    reader.getField(frame, kSnapshotV) != expected_v[frame]) {
+                    std::cerr << "Error: Snapshot frame " << frame << " (mode " << mode << ") differs" << std::endl;
+                    return false;
+                }
+            }
+        }
+    
+        // Single precision, u only
+        {
+            SnapshotWriter writer;
+            writer.open("test_fhn_frames.bin", width, height, true, kSnapshotU);
+            FitzHughNagumoF model(width, height, static_cast<float>(dt));
+            model.setOutput(&writer, interval);
+            model.addStimulus(5, 5, 1.5, 0.4);
+            model.run(2 * interval);
+            writer.close();
+    
+            SnapshotReader reader;
+            if (!reader.open("test_fhn_frames.bin") || !reader.isSinglePrecision() || reader.getFrameCount() != 2 ||
+                reader.hasField(kSnapshotV)) {
+                std::cerr << "Error: Single-precision snapshot file has the wrong layout" << std::endl;
+                return false;
+            }
+            auto stored = reader.getField(1, kSnapshotU);
+            auto u = model.getU();
+            for (int y = 0; y < height; ++y) {
+                for (int x = 0; x < width; ++x) {
+                    if (stored[y][x] != static_cast<double>(u[y][x])) {
+                        std::cerr << "Error: Single-precision snapshot differs at (" << x << ", " << y << ")" << std::endl;
+                        return false;
+                    }
+                }
+            }
+        }
+    
+        // With dropping enabled a full queue never blocks the solver
+        {
+            SnapshotWriter writer;
+            writer.open("test_fhn_frames.bin", width, height, false, kSnapshotU, 1);
+            writer.setDropWhenFull(true);
+            FitzHughNagumo model(width, height, dt);
+            model.setOutput(&writer, 1);
+            model.run(200);
+            writer.close();
+            if (writer.getFramesWritten() + writer.getFramesDropped() != 200) {
+                std::cerr << "Error: Frames lost without being counted as dropped" << std::endl;
+                return false;
+            }
+        }
+    
+        std::remove("test_fhn_frames.bin");
+        std::cout << "Snapshot writer tests passed!" << std::endl;
+        return true;
+    
+    } catch (const std::exception& e) {
+        std::cerr << "Snapshot writer test failed with exception: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool testFitzHughNagumoAdaptiveIntegrator() {
+    std::cout << "Testing FitzHugh-Nagumo adaptive integrator..." << std::endl;
+    
+    try {
+        const int width = 24;
+        const int height = 20;
+        std::vector<std::vector<double>> u_init(height, std::vector<double>(width, 0.0));
+        std::vector<std::vector<double>> v_init(height, std::vector<double>(width, 0.0));
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < 4; ++x) {
+                u_init[y][x] = 1.5;
+            }
+        }
+        
+        // Fine-step Euler solution as the reference
+        FitzHughNagumo fine(width, height, 0.001);
+        fine.setInitialConditions(u_init, v_init);
+        fine.setParameters(0.7, 0.8, 12.5, 0.0);
+        fine.setDiffusionCoefficients(1.0, 0.0);
+        fine.run(20000);
+        
+        FitzHughNagumo adaptive(width, height, 0.02);
+        adaptive.setIntegrator(TimeIntegrator::AdaptiveRK23, 1e-4, 1e-6);
+        adaptive.setInitialConditions(u_init, v_init);
+        adaptive.setParameters(0.7, 0.8, 12.5, 0.0);
+        adaptive.setDiffusionCoefficients(1.0, 0.0);
+        adaptive.run(999);
+        adaptive.step();
+        
+        if (std::abs(adaptive.getTime() - fine.getTime()) > 1e-9) {
+            std::cerr << "Error: Adaptive integrator ended at t = " << adaptive.getTime() << std::endl;
+            return false;
+        }
+        // Far fewer steps than fixed-step Euler at dt = 0.02 over the same interval
+        if (adaptive.getAcceptedSteps() <= 0 || adaptive.getAcceptedSteps() >= 1000) {
+            std::cerr << "Error: Unexpected adaptive step count " << adaptive.getAcceptedSteps() << std::endl;
+            return false;
+        }
+        
+        auto u_fine = fine.getU();
+        auto u_adaptive = adaptive.getU();
+        double max_error = 0.0;
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                max_error = std::max(max_error, std::abs(u_adaptive[y][x] - u_fine[y][x]));
+            }
+        }
+        if (max_error > 1e-2) {
+            std::cerr << "Error: Adaptive integrator error too large: " << max_error << std::endl;
+            return false;
+        }
+        
+        // Row bands must take the same steps and reach the same state
+        FitzHughNagumo parallel(width, height, 0.02);
+        parallel.setNumThreads(3);
+        parallel.setIntegrator(TimeIntegrator::AdaptiveRK23, 1e-4, 1e-6);
+        parallel.setInitialConditions(u_init, v_init);
+        parallel.setParameters(0.7, 0.8, 12.5, 0.0);
+        parallel.setDiffusionCoefficients(1.0, 0.0);
+        parallel.run(999);
+        parallel.step();
+        auto u_parallel = parallel.getU();
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                if (u_parallel[y][x] != u_adaptive[y][x]) {
+                    std::cerr << "Error: Parallel adaptive run differs at (" << x << ", " << y << ")" << std::endl;
+                    return false;
+                }
+            }
+        }
+        
+        std::cout << "FitzHugh-Nagumo adaptive integrator tests passed! (" << adaptive.getAcceptedSteps()
+                  << " accepted, " << adaptive.getRejectedSteps() << " rejected)" << std::endl;
+        return true;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "FitzHugh-Nagumo adaptive integrator test failed with exception: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool testImexADIDiffusion() {
+    std::cout << "Testing IMEX ADI diffusion..." << std::endl;
+    
+    try {
+        // A linear field is discretely harmonic, so implicit diffusion with
+        // matching boundary values must leave it unchanged
+        const int width = 29;
+        const int height = 17;
+        AlignedGrid<double> linear(width, height);
+        AlignedGrid<double> diffused(width, height);
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                linear(x, y) = 0.5 * x - 0.25 * y + 1.0;
+            }
+        }
+        ADIDiffusion<double> adi;
+        adi.configure(width, height, 3.0);
+        adi.apply(linear, diffused, nullptr);
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                if (std::abs(diffused(x, y) - linear(x, y)) > 1e-12) {
+                    std::cerr << "Error: ADI changed a harmonic field at (" << x << ", " << y << ")" << std::endl;
+                    return false;
+                }
+            }
+        }
+        
+        std::vector<std::vector<double>> u_init(height, std::vector<double>(width, -1.2));
+        std::vector<std::vector<double>> v_init(height, std::vector<double>(width, -0.62));
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < 4; ++x) {
+                u_init[y][x] = 2.0;
+            }
+        }
+        
+        // dt * du = 1.0 is four times the explicit stability limit
+        FitzHughNagumo serial(width, height, 0.25);
+        FitzHughNagumo parallel(width, height, 0.25);
+        for (FitzHughNagumo* fhn : {&serial, &parallel}) {
+            fhn->setIntegrator(TimeIntegrator::ImexADI);
+            fhn->setInitialConditions(u_init, v_init);
+            fhn->setParameters(0.7, 0.8, 12.5, 0.0);
+            fhn->setDiffusionCoefficients(4.0, 0.1);
+        }
+        parallel.setNumThreads(3);
+        serial.run(80);
+        parallel.run(80);
+        
+        auto u_serial = serial.getU();
+        auto u_parallel = parallel.getU();
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                if (!std::isfinite(u_serial[y][x]) || std::abs(u_serial[y][x]) > 3.0) {
+                    std::cerr << "Error: IMEX solution unbounded at (" << x << ", " << y << ")" << std::endl;
+                    return false;
+                }
+                if (u_serial[y][x] != u_parallel[y][x]) {
+                    std::cerr << "Error: Parallel IMEX run differs at (" << x << ", " << y << ")" << std::endl;
+                    return false;
+                }
+            }
+        }
+        
+        std::cout << "IMEX ADI diffusion tests passed!" << std::endl;
+        return true;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "IMEX ADI diffusion test failed with exception: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool testFitzHughNagumoSinglePrecision() {
+    std::cout << "Testing FitzHugh-Nagumo single precision..." << std::endl;
+    
+    try {
+        const int width = 41;
+        const int height = 27;
+        const int steps = 60;
+        std::vector<std::vector<double>> u_init(height, std::vector<double>(width));
+        std::vector<std::vector<double>> v_init(height, std::vector<double>(width));
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                u_init[y][x] = 0.5 * std::sin(0.3 * x + 0.7 * y);
+                v_init[y][x] = 0.1 * std::cos(0.2 * x - 0.1 * y);
+            }
+        }
+        
+        FitzHughNagumo fhn_double(width, height, 0.01);
+        FitzHughNagumoF fhn_float(width, height, 0.01);
+        fhn_float.setAccuracyComparison(true);
+        fhn_double.setInitialConditions(u_init, v_init);
+        fhn_float.setInitialConditions(u_init, v_init);
+        fhn_double.setDiffusionCoefficients(0.2, 0.05);
+        fhn_float.setDiffusionCoefficients(0.2, 0.05);
+        fhn_double.addStimulus(12, 8, 1.0, 10.0);
+        fhn_float.addStimulus(12, 8, 1.0, 10.0);
+        
+        fhn_double.run(steps);
+        fhn_float.run(steps);
+        
+        // The recorded deviation must match a direct comparison at the end
+        PrecisionDeviation deviation = fhn_float.getPrecisionDeviation();
+        if (deviation.steps_compared != steps) {
+            std::cerr << "Error: Expected " << steps << " compared steps, got " << deviation.steps_compared << std::endl;
+            return false;
+        }
+        auto u_double = fhn_double.getU();
+        auto u_float = fhn_float.getU();
+        double final_error = 0.0;
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                final_error = std::max(final_error, std::abs(u_float[y][x] - u_double[y][x]));
+            }
+        }
+        if (final_error > deviation.max_abs_u || deviation.max_abs_u > 1e-4 || deviation.max_abs_v > 1e-4) {
+            std::cerr << "Error: Single precision deviation too large (u " << deviation.max_abs_u
+                      << ", v " << deviation.max_abs_v << ")" << std::endl;
+            return false;
+        }
+        
+        std::cout << "FitzHugh-Nagumo single precision tests passed!" << std::endl;
+        return true;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "FitzHugh-Nagumo single precision test failed with exception: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool testStencilKernelDispatch() {
+    std::cout << "Testing stencil kernel dispatch..." << std::endl;
+    
+    try {
+        const int width = 45;
+        const int height = 21;
+        std::vector<std::vector<double>> u_init(height, std::vector<double>(width));
+        std::vector<std::vector<double>> v_init(height, std::vector<double>(width));
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                u_init[y][x] = 0.5 * std::sin(0.4 * x) * std::cos(0.3 * y);
+                v_init[y][x] = 0.1 * std::cos(0.2 * x + 0.5 * y);
+            }
+        }
+        
+        SimdLevel original = StencilKernels::getSimdLevel();
+        std::vector<std::vector<double>> reference;
+        std::vector<std::vector<float>> reference_float;
+        
+        // Every supported ISA level must agree with the scalar kernel
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512}) {
+            if (!StencilKernels::setSimdLevel(level)) {
+                continue;
+            }
+            
+            FitzHughNagumo fhn(width, height, 0.01);
+            fhn.setInitialConditions(u_init, v_init);
+            fhn.setDiffusionCoefficients(0.2, 0.05);
+            fhn.addStimulus(7, 9, 0.5, 10.0);
+            fhn.run(40);
+            
+            FitzHughNagumoF fhn_float(width, height, 0.01);
+            fhn_float.setInitialConditions(u_init, v_init);
+            fhn_float.setDiffusionCoefficients(0.2, 0.05);
+            fhn_float.addStimulus(7, 9, 0.5, 10.0);
+            fhn_float.run(40);
+            
+            std::vector<std::vector<double>> result = fhn.getU();
+            std::vector<std::vector<float>> result_float = fhn_float.getU();
+            if (reference.empty()) {
+                reference = result;
+                reference_float = result_float;
+                continue;
+            }
+            for (int y = 0; y < height; ++y) {
+                for (int x = 0; x < width; ++x) {
+                    if (std::abs(result[y][x] - reference[y][x]) > 1e-12 ||
+                        std::abs(result_float[y][x] - reference_float[y][x]) > 1e-5f) {
+                        std::cerr << "Error: " << StencilKernels::simdLevelName(level)
+                                  << " kernel differs from scalar kernel" << std::endl;
+                        StencilKernels::setSimdLevel(original);
+                        return false;
+                    }
+                }
+            }
+        }
+        StencilKernels::setSimdLevel(original);
+        
+        std::cout << "Stencil kernel tests passed!" << std::endl;
+        return true;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Stencil kernel test failed with exception: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool testAlignedGridLayout() {
+    std::cout << "Testing aligned grid layout..." << std::endl;
+    
+    try {
+        AlignedGrid<double> grid(37, 5, 1, 0.0);
+        
+        // Every row must start on a cache line and the halo must be addressable
+        for (int y = -1; y <= 5; ++y) {
+            if (reinterpret_cast<std::uintptr_t>(grid.row(y)) % kGridAlignment != 0) {
+                std::cerr << "Error: Grid row " << y << " is not aligned" << std::endl;
+                return false;
+            }
+        }
+        grid(-1, -1) = 1.0;
+        grid(37, 5) = 2.0;
+        grid(3, 2) = 3.0;
+        
+        // The nested-vector style view must see the same cells
+        GridView<const double> view = static_cast<const AlignedGrid<double>&>(grid).view();
+        if (view.size() != 5 || view[0].size() != 37 || view[2][3] != 3.0) {
+            std::cerr << "Error: Grid view does not match grid contents" << std::endl;
+            return false;
+        }
+        
+        std::vector<std::vector<double>> nested = view;
+        if (nested.size() != 5 || nested[2][3] != 3.0) {
+            std::cerr << "Error: Grid view conversion failed" << std::endl;
+            return false;
+        }
+        
+        std::cout << "Aligned grid tests passed!" << std::endl;
+        return true;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Aligned grid test failed with exception: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool testCardiacStateLayout() {
+    std::cout << "Testing cardiac model state layout..." << std::endl;
+    
+    try {
+        const int width = 29;
+        const int height = 21;
+    
+        LuoRudyModel luo_rudy(width, height, 0.01);
+        TenTusscherModel ten_tusscher(width, height, 0.01);
+    
+        // Only integrated variables are stored per cell: V, m, h, xr, Cai and V, m, u, Cai
+        if (luo_rudy.getStateBytesPerCell() != 5 * sizeof(double) ||
+            ten_tusscher.getStateBytesPerCell() != 4 * sizeof(double)) {
+            std::cerr << "Error: Unexpected cardiac state size per cell" << std::endl;
+            return false;
+        }
+    
+        std::vector<std::vector<bool>> scar(height, std::vector<bool>(width, false));
+        for (int y = 8; y < 13; ++y) {
+            for (int x = 10; x < 16; ++x) {
+                scar[y][x] = true;
+            }
+        }
+    
+        for (CardiacElectrophysiology* model : {static_cast<CardiacElectrophysiology*>(&luo_rudy),
+                                                static_cast<CardiacElectrophysiology*>(&ten_tusscher)}) {
+            model->setMIRegion(scar);
+            for (int y = 0; y < height; ++y) {
+                double* row = model->membranePotentialRow(y);
+                for (int x = 0; x < width; ++x) {
+                    row[x] = -80.0 + 6.0 * std::sin(0.4 * x + 0.3 * y);
+                }
+            }
+    
+            auto V = model->getMembranePotential();
+            if (V.width() != width || V.height() != height || V[3][5] != -80.0 + 6.0 * std::sin(0.4 * 5 + 0.3 * 3)) {
+                std::cerr << "Error: Membrane potential view does not match the written rows" << std::endl;
+                return false;
+            }
+    
+            model->run(50);
+            V = model->getMembranePotential();
+            for (int y = 0; y < height; ++y) {
+                for (int x = 0; x < width; ++x) {
+                    double initial = -80.0 + 6.0 * std::sin(0.4 * x + 0.3 * y);
+                    if (!std::isfinite(V[y][x]) || (scar[y][x] && V[y][x] != initial)) {
+                        std::cerr << "Error: Cardiac state invalid at (" << x << ", " << y << ")" << std::endl;
+                        return false;
+                    }
+                }
+            }
+        }
+    
+        std::cout << "Cardiac model state layout tests passed!" << std::endl;
+        return true;
+    
+    } catch (const std::exception& e) {
+        std::cerr << "Cardiac model state layout test failed with exception: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool testCardiacIonicCurrents() {
+    std::cout << "Testing cardiac ionic current reporting..." << std::endl;
+    
+    try {
+        LuoRudyModel luo_rudy(6, 5, 0.01);
+        TenTusscherModel ten_tusscher(6, 5, 0.01);
+        luo_rudy.membranePotentialRow(2)[3] = -60.0;
+    
+        auto lr_currents = luo_rudy.getIonicCurrents();
+        auto tt_currents = ten_tusscher.getIonicCurrents();
+        if (lr_currents.size() != LuoRudyModel::kCurrentCount || tt_currents.size() != TenTusscherModel::kCurrentCount) {
+            std::cerr << "Error: Unexpected number of reported currents" << std::endl;
+            return false;
+        }
+        for (const char* name : {"INa", "ICaL", "IK", "IK1", "Ib", "ICaT"}) {
+            if (lr_currents.count(name) == 0 || lr_currents[name].size() != 5 || lr_currents[name][0].size() != 6) {
+                std::cerr << "Error: Luo-Rudy current " << name << " missing" << std::endl;
+                return false;
+            }
+        }
+        for (const char* name : {"INa", "ICaL", "IKr", "IKs", "IK1", "Ito", "INaCa", "INaK"}) {
+            if (tt_currents.count(name) == 0) {
+                std::cerr << "Error: Ten Tusscher current " << name << " missing" << std::endl;
+                return false;
+            }
+        }
+    
+        // Resting Luo-Rudy cell: only IK1 and Ib are non-zero
+        double V = -60.0;
+        double ik1 = 0.6047 * (V + 77.0) / (1 + std::exp(0.07 * (V + 80)));
+        double ib = 0.03921 * (V + 59.87);
+        if (std::abs(lr_currents["IK1"][2][3] - ik1) > 1e-12 || std::abs(lr_currents["Ib"][2][3] - ib) > 1e-12 ||
+            lr_currents["INa"][2][3] != 0.0 || lr_currents["IK1"][2][3] == lr_currents["IK1"][0][0]) {
+            std::cerr << "Error: Luo-Rudy currents do not match the model equations" << std::endl;
+            return false;
+        }
+    
+        std::cout << "Cardiac ionic current reporting tests passed!" << std::endl;
+        return true;
+    
+    } catch (const std::exception& e) {
+        std::cerr << "Cardiac ionic current test failed with exception: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool testGateIntegrators() {
+    std::cout << "Testing Rush-Larsen gate integrators..." << std::endl;
+    
+    try {
+        // Potential of a uniform Luo-Rudy tissue (no diffusion) after 10 ms
+        auto run = [](GateIntegrator integrator, double dt, double V0) {
+            LuoRudyModel model(4, 4, dt);
+            model.setGateIntegrator(integrator);
+            for (int y = 0; y < 4; ++y) {
+                for (int x = 0; x < 4; ++x) {
+                    model.membranePotentialRow(y)[x] = V0;
+                }
+            }
+            model.run(static_cast<int>(std::lround(10.0 / dt)));
+            return model.getMembranePotential()[2][1];
+        };
+    
+        if (LuoRudyModel(4, 4).getGateIntegrator() != GateIntegrator::ForwardEuler) {
+            std::cerr << "Error: Forward Euler should be the default gate integrator" << std::endl;
+            return false;
+        }
+    
+        // Ten times the default step stays close to a fine forward Euler run
+        double reference = run(GateIntegrator::ForwardEuler, 0.001, -60.0);
+        double rush_larsen = run(GateIntegrator::RushLarsen, 0.1, -60.0);
+        double second_order = run(GateIntegrator::GeneralizedRushLarsen2, 0.1, -60.0);
+        if (!std::isfinite(rush_larsen) || std::abs(rush_larsen - reference) > 0.05 ||
+            !std::isfinite(second_order) || std::abs(second_order - reference) > 0.05) {
+            std::cerr << "Error: Rush-Larsen at dt = 0.1 deviates from the reference: " << rush_larsen << ", "
+                      << second_order << " vs " << reference << std::endl;
+            return false;
+        }
+    
+        // Second order beats first order at the default step
+        double error_rl = std::abs(run(GateIntegrator::RushLarsen, 0.01, -60.0) - reference);
+        double error_grl2 = std::abs(run(GateIntegrator::GeneralizedRushLarsen2, 0.01, -60.0) - reference);
+        if (error_grl2 >= error_rl) {
+            std::cerr << "Error: Generalized Rush-Larsen is not more accurate than Rush-Larsen" << std::endl;
+            return false;
+        }
+    
+        // Depolarized start: the stiff h gate stays bounded with exponential updates
+        double fine = run(GateIntegrator::GeneralizedRushLarsen2, 0.001, 20.0);
+        double coarse = run(GateIntegrator::RushLarsen, 0.1, 20.0);
+        if (!std::isfinite(coarse) || std::abs(coarse - fine) > 0.1) {
+            std::cerr << "Error: Rush-Larsen unstable from a depolarized state" << std::endl;
+            return false;
+        }
+    
+        std::cout << "Rush-Larsen gate integrator tests passed!" << std::endl;
+        return true;
+    
+    } catch (const std::exception& e) {
+        std::cerr << "Gate integrator test failed with exception: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool testRateTables() {
+    std::cout << "Testing voltage lookup tables..." << std::endl;
+    
+    try {
+        // Generic table: interpolation within the reported error, exact outside the range
+        RateTable table(0.0, 1.0, 0.01, 2, [](double V, double* values) {
+            values[0] = std::exp(V);
+            values[1] = 1.0 / (1.0 + V);
+        });
+        double values[2];
+        table.lookup(2.0, values);
+        if (values[0] != std::exp(2.0) || table.getMaxError(0) <= 0.0 || table.getMaxError(0) > 5e-5) {
+            std::cerr << "Error: Rate table error estimate or out-of-range fallback wrong" << std::endl;
+            return false;
+        }
+        for (double V = 0.0013; V < 1.0; V += 0.0371) {
+            table.lookup(V, values);
+            if (std::abs(values[0] - std::exp(V)) > table.getMaxError(0) * 1.01 ||
+                std::abs(values[1] - 1.0 / (1.0 + V)) > table.getMaxError(1) * 1.01) {
+                std::cerr << "Error: Rate table interpolation exceeds its reported error at V = " << V << std::endl;
+                return false;
+            }
+        }
+    
+        // Models of one class share a table; invalid resolutions are rejected
+        LuoRudyModel exact(6, 6, 0.01);
+        LuoRudyModel tabulated(6, 6, 0.01);
+        LuoRudyModel other(3, 3, 0.01);
+        TenTusscherModel ten_tusscher(3, 3, 0.01);
+        if (!tabulated.setRateTableResolution(0.02) || !other.setRateTableResolution(0.02) ||
+            !ten_tusscher.setRateTableResolution(0.02) || tabulated.setRateTableResolution(-1.0) ||
+            exact.getRateTable() != nullptr || tabulated.getRateTable() != other.getRateTable() ||
+            tabulated.getRateTable() == ten_tusscher.getRateTable() ||
+            tabulated.getRateTable()->getMaxRelativeError() > 1e-5) {
+            std::cerr << "Error: Model rate tables not shared or validated as expected" << std::endl;
+            return false;
+        }
+    
+        // Tabulated rates reproduce the exact model closely through an upstroke
+        for (LuoRudyModel* model : {&exact, &tabulated}) {
+            model->setGateIntegrator(GateIntegrator::RushLarsen);
+            for (int y = 0; y < 6; ++y) {
+                for (int x = 0; x < 6; ++x) {
+                    model->membranePotentialRow(y)[x] = -65.0 + 10.0 * std::sin(0.9 * x + 0.4 * y);
+                }
+            }
+            model->run(100);
+        }
+        auto V_exact = exact.getMembranePotential();
+        auto V_tabulated = tabulated.getMembranePotential();
+        for (int y = 0; y < 6; ++y) {
+            for (int x = 0; x < 6; ++x) {
+                if (!std::isfinite(V_exact[y][x]) || std::abs(V_tabulated[y][x] - V_exact[y][x]) > 1e-3) {
+                    std::cerr << "Error: Tabulated rates diverge from exact rates at (" << x << ", " << y << ")"
+                              << std::endl;
+                    return false;
+                }
+            }
+        }
+    
+        if (!tabulated.setRateTableResolution(0.0) || tabulated.getRateTable() != nullptr) {
+            std::cerr << "Error: Rate tables could not be switched off" << std::endl;
+            return false;
+        }
+    
+        std::cout << "Voltage lookup table tests passed!" << std::endl;
+        return true;
+    
+    } catch (const std::exception& e) {
+        std::cerr << "Rate table test failed with exception: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool testCardiacParallelStep() {
+    std::cout << "Testing parallel vectorized cardiac stepping..." << std::endl;
+    
+    try {
+        // Odd width so the vector kernels also finish rows through their tails
+        const int width = 37;
+        const int height = 23;
+        auto potential = [](int x, int y) { return -80.0 + 6.0 * std::sin(0.4 * x + 0.3 * y); };
+        auto scar = [](int x, int y) { return x >= 20 && x < 26 && y >= 5 && y < 15; };
+        std::vector<std::vector<bool>> region(height, std::vector<bool>(width));
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                region[y][x] = scar(x, y);
+            }
+        }
+        
+        SimdLevel original = StencilKernels::getSimdLevel();
+        for (int model_type = 0; model_type < 2; ++model_type) {
+            for (GateIntegrator integrator : {GateIntegrator::ForwardEuler, GateIntegrator::GeneralizedRushLarsen2}) {
+                std::vector<std::vector<double>> reference;
+                for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512}) {
+                    if (!StencilKernels::setSimdLevel(level)) {
+                        continue;
+                    }
+                    
+                    std::unique_ptr<CardiacElectrophysiology> serial, parallel;
+                    if (model_type == 0) {
+                        serial.reset(new LuoRudyModel(width, height, 0.01));
+                        parallel.reset(new LuoRudyModel(width, height, 0.01));
+                    } else {
+                        serial.reset(new TenTusscherModel(width, height, 0.01));
+                        parallel.reset(new TenTusscherModel(width, height, 0.01));
+                    }
+                    parallel->setNumThreads(3);
+                    for (CardiacElectrophysiology* model : {serial.get(), parallel.get()}) {
+                        model->setConductivity(0.5);
+                        model->setGateIntegrator(integrator);
+                        model->setMIRegion(region);
+                        for (int y = 0; y < height; ++y) {
+                            for (int x = 0; x < width; ++x) {
+                                model->membranePotentialRow(y)[x] = potential(x, y);
+                            }
+                        }
+                        model->run(40);
+                    }
+                    
+                    // Row bands reproduce the serial sweep exactly, scar cells
+                    // keep their potential and every ISA level agrees with scalar
+                    auto V_serial = serial->getMembranePotential();
+                    auto V_parallel = parallel->getMembranePotential();
+                    for (int y = 0; y < height; ++y) {
+                        for (int x = 0; x < width; ++x) {
+                            if (!std::isfinite(V_serial[y][x]) || V_parallel[y][x] != V_serial[y][x] ||
+                                (scar(x, y) && V_serial[y][x] != potential(x, y)) ||
+                                (!reference.empty() && std::abs(V_serial[y][x] - reference[y][x]) > 1e-8)) {
+                                std::cerr << "Error: Cardiac model " << model_type << " ("
+                                          << StencilKernels::simdLevelName(level) << ") wrong at (" << x << ", "
+                                          << y << ")" << std::endl;
+                                StencilKernels::setSimdLevel(original);
+                                return false;
+                            }
+                        }
+                    }
+                    if (reference.empty()) {
+                        reference.assign(height, std::vector<double>(width));
+                        for (int y = 0; y < height; ++y) {
+                            for (int x = 0; x < width; ++x) {
+                                reference[y][x] = V_serial[y][x];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        StencilKernels::setSimdLevel(original);
+        
+        std::cout << "Parallel vectorized cardiac stepping tests passed!" << std::endl;
+        return true;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Parallel cardiac stepping test failed with exception: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool testCardiacTissueClasses() {
+    std::cout << "Testing cardiac tissue classes..." << std::endl;
+    
+    try {
+        const int width = 29;
+        const int height = 11;
+        auto potential = [](int x, int y) { return -75.0 + 10.0 * std::sin(0.5 * x + 0.2 * y); };
+        auto border = [](int x, int y) { return x + y >= 17; };
+        std::vector<std::vector<uint8_t>> classes(height, std::vector<uint8_t>(width));
+        std::vector<std::vector<double>> ones(height, std::vector<double>(width, 1.0));
+        std::vector<std::vector<double>> gradient(height, std::vector<double>(width));
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                classes[y][x] = border(x, y) ? 1 : 0;
+                gradient[y][x] = 0.5 + x / static_cast<double>(width);
+            }
+        }
+        
+        SimdLevel original = StencilKernels::getSimdLevel();
+        for (int model_type = 0; model_type < 2; ++model_type) {
+            const std::string base = model_type == 0 ? "normal" : "epi";
+            const std::string other = model_type == 0 ? "infarcted" : "endo";
+            auto create = [&](const std::string& type) -> std::unique_ptr<CardiacElectrophysiology> {
+                if (model_type == 0) {
+                    std::unique_ptr<LuoRudyModel> model(new LuoRudyModel(width, height, 0.01));
+                    model->setCellType(type);
+                    return std::unique_ptr<CardiacElectrophysiology>(std::move(model));
+                }
+                std::unique_ptr<TenTusscherModel> model(new TenTusscherModel(width, height, 0.01));
+                model->setVariant(type);
+                return std::unique_ptr<CardiacElectrophysiology>(std::move(model));
+            };
+            
+            for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512}) {
+                if (!StencilKernels::setSimdLevel(level)) {
+                    continue;
+                }
+                
+                // Without coupling every cell of a mixed grid follows the
+                // homogeneous model of its class, and unit scales change nothing
+                auto mixed = create(base);
+                auto scaled = create(base);
+                auto uniform_base = create(base);
+                auto uniform_other = create(other);
+                for (CardiacElectrophysiology* model : {mixed.get(), scaled.get()}) {
+                    if (model->addTissueClass(other) != 1 || !model->setTissueClasses(classes)) {
+                        std::cerr << "Error: Could not set up tissue classes" << std::endl;
+                        StencilKernels::setSimdLevel(original);
+                        return false;
+                    }
+                }
+                const int current_count = model_type == 0 ? static_cast<int>(LuoRudyModel::kCurrentCount)
+                                                          : static_cast<int>(TenTusscherModel::kCurrentCount);
+                for (int current = 0; current < current_count; ++current) {
+                    scaled->setConductanceScale(current, ones);
+                }
+                for (CardiacElectrophysiology* model : {mixed.get(), scaled.get(), uniform_base.get(),
+                                                        uniform_other.get()}) {
+                    model->setConductivity(0.0);
+                    for (int y = 0; y < height; ++y) {
+                        for (int x = 0; x < width; ++x) {
+                            model->membranePotentialRow(y)[x] = potential(x, y);
+                        }
+                    }
+                    model->run(30);
+                }
+                
+                auto V_mixed = mixed->getMembranePotential();
+                auto V_scaled = scaled->getMembranePotential();
+                auto V_base = uniform_base->getMembranePotential();
+                auto V_other = uniform_other->getMembranePotential();
+                for (int y = 0; y < height; ++y) {
+                    for (int x = 0; x < width; ++x) {
+                        double expected = border(x, y) ? V_other[y][x] : V_base[y][x];
+                        if (!std::isfinite(expected) || V_mixed[y][x] != expected || V_scaled[y][x] != expected) {
+                            std::cerr << "Error: Tissue class model " << model_type << " ("
+                                      << StencilKernels::simdLevelName(level) << ") wrong at (" << x << ", "
+                                      << y << ")" << std::endl;
+                            StencilKernels::setSimdLevel(original);
+                            return false;
+                        }
+                    }
+                }
+            }
+        }
+        StencilKernels::setSimdLevel(original);
+        
+        // A scale field multiplies the conductance of one current cell by cell
+        LuoRudyModel model(width, height, 0.01);
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                model.membranePotentialRow(y)[x] = potential(x, y);
+            }
+        }
+        auto unscaled = model.getIonicCurrents();
+        if (!model.setConductanceScale(LuoRudyModel::INa, gradient)) {
+            std::cerr << "Error: Could not set conductance scale" << std::endl;
+            return false;
+        }
+        auto scaled = model.getIonicCurrents();
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                if (std::abs(scaled["INa"][y][x] - gradient[y][x] * unscaled["INa"][y][x]) >
+                        1e-12 * std::abs(unscaled["INa"][y][x]) ||
+                    scaled["IK"][y][x] != unscaled["IK"][y][x]) {
+                    std::cerr << "Error: Conductance scale wrong at (" << x << ", " << y << ")" << std::endl;
+                    return false;
+                }
+            }
+        }
+        
+        // Undefined classes, unknown names and mismatched fields are rejected
+        if (model.setTissueClasses(classes) || model.addTissueClass("unknown") != -1 ||
+            model.setConductanceScale(LuoRudyModel::kCurrentCount, gradient) ||
+            model.setConductanceScale(LuoRudyModel::INa, std::vector<std::vector<double>>(height)) ||
+            model.setTissueClasses(std::vector<std::vector<uint8_t>>(height + 1, std::vector<uint8_t>(width)))) {
+            std::cerr << "Error: Invalid tissue parameters should be rejected" << std::endl;
+            return false;
+        }
+        if (model.getTissueClassCount() != 1 || !model.setTissueClasses({}) ||
+            !model.setConductanceScale(LuoRudyModel::INa, {})) {
+            std::cerr << "Error: Tissue parameters could not be reset" << std::endl;
+            return false;
+        }
+        
+        std::cout << "Cardiac tissue class tests passed!" << std::endl;
+        return true;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Cardiac tissue class test failed with exception: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool testScarMask() {
+    std::cout << "Testing scar masks..." << std::endl;
+    
+    try {
+        // Wider than two words, with fully scarred and scar-free rows
+        const int width = 150;
+        const int height = 9;
+        auto scar = [](int x, int y) {
+            return y == 2 || (y != 5 && ((x * 7 + y * 3) % 11 < 3 || (x >= 60 && x < 70 + y)));
+        };
+        std::vector<std::vector<bool>> region(height, std::vector<bool>(width));
+        std::vector<uint64_t> words(height * ScarMask::wordsPerRow(width), 0);
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                region[y][x] = scar(x, y);
+                if (scar(x, y)) {
+                    words[y * ScarMask::wordsPerRow(width) + x / 64] |= uint64_t(1) << (x % 64);
+                }
+            }
+        }
+        
+        const uint64_t* buffer = words.data();
+        ScarMask packed(region);
+        ScarMask view = ScarMask::view(buffer, width, height, ScarMask::wordsPerRow(width));
+        ScarMask moved = ScarMask::fromWords(std::move(words), width, height);
+        if (view.ownsWords() || view.row(0) != buffer || !moved.ownsWords() || moved.row(0) != buffer) {
+            std::cerr << "Error: Scar mask words were copied" << std::endl;
+            return false;
+        }
+        
+        // The spans of each row tile it exactly, alternating live and scar
+        std::size_t scar_cells = 0;
+        for (const ScarMask* mask : {&packed, &view, &moved}) {
+            for (int y = 0; y < height; ++y) {
+                std::vector<int> covered(width, 0);
+                for (const CellSpan& span : mask->liveSpans(y)) {
+                    for (int x = span.begin; x < span.end; ++x) {
+                        covered[x] += scar(x, y) ? 10 : 1;
+                    }
+                }
+                for (const CellSpan& span : mask->scarSpans(y)) {
+                    for (int x = span.begin; x < span.end; ++x) {
+                        covered[x] += scar(x, y) ? 1 : 10;
+                    }
+                }
+                for (int x = 0; x < width; ++x) {
+                    if (covered[x] != 1 || mask->isScar(x, y) != scar(x, y)) {
+                        std::cerr << "Error: Scar mask spans wrong at (" << x << ", " << y << ")" << std::endl;
+                        return false;
+                    }
+                }
+            }
+            if (mask == &packed) {
+                scar_cells = mask->getScarCellCount();
+            } else if (mask->getScarCellCount() != scar_cells) {
+                std::cerr << "Error: Scar cell counts differ" << std::endl;
+                return false;
+            }
+        }
+        if (!packed.liveSpans(2).empty() || packed.scarSpans(5).size() != 0 || packed.liveSpans(5).size() != 1) {
+            std::cerr << "Error: Scar mask spans of uniform rows wrong" << std::endl;
+            return false;
+        }
+        
+        // A model stepped with a viewed mask matches one given the boolean grid
+        LuoRudyModel from_region(width, height, 0.01);
+        LuoRudyModel from_view(width, height, 0.01);
+        from_region.setMIRegion(region);
+        if (!from_view.setScarMask(ScarMask::view(buffer, width, height, ScarMask::wordsPerRow(width))) ||
+            from_view.getScarMask().row(0) != buffer) {
+            std::cerr << "Error: Could not set scar mask view" << std::endl;
+            return false;
+        }
+        for (LuoRudyModel* model : {&from_region, &from_view}) {
+            model->setConductivity(0.5);
+            for (int y = 0; y < height; ++y) {
+                for (int x = 0; x < width; ++x) {
+                    model->membranePotentialRow(y)[x] = -80.0 + 6.0 * std::sin(0.1 * x + 0.5 * y);
+                }
+            }
+            model->run(20);
+        }
+        auto V_region = from_region.getMembranePotential();
+        auto V_view = from_view.getMembranePotential();
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                if (!std::isfinite(V_region[y][x]) || V_region[y][x] != V_view[y][x] ||
+                    (scar(x, y) && V_region[y][x] != -80.0 + 6.0 * std::sin(0.1 * x + 0.5 * y))) {
+                    std::cerr << "Error: Scar mask model differs at (" << x << ", " << y << ")" << std::endl;
+                    return false;
+                }
+            }
+        }
+        
+        // Mismatched sizes are rejected
+        if (from_view.setScarMask(ScarMask(width, height + 1)) ||
+            ScarMask::fromWords(std::vector<uint64_t>(3), width, height).width() != 0 ||
+            ScarMask::view(buffer, width, height, 1).width() != 0) {
+            std::cerr << "Error: Invalid scar masks should be rejected" << std::endl;
+            return false;
+        }
+        
+        std::cout << "Scar mask tests passed!" << std::endl;
+        return true;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Scar mask test failed with exception: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool testCardiacAnisotropicDiffusion() {
+    std::cout << "Testing anisotropic cardiac diffusion..." << std::endl;
+    
+    try {
+        const int size = 41;
+        const int center = size / 2;
+        auto potential = [](int x, int y) { return -75.0 + 10.0 * std::sin(0.5 * x + 0.2 * y); };
+        auto bump = [&](int x, int y) {
+            int dx = x - center, dy = y - center;
+            return dx * dx + dy * dy <= 9 ? -80.0 : -84.0;
+        };
+        std::vector<std::vector<double>> along_x(size, std::vector<double>(size, 0.0));
+        std::vector<std::vector<double>> along_y(size, std::vector<double>(size, 1.5707963267948966));
+        std::vector<std::vector<double>> swirl(size, std::vector<double>(size));
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                swirl[y][x] = std::atan2(y - center + 0.5, x - center + 0.5);
+            }
+        }
+        
+        // Equal conductivities reproduce isotropic diffusion for any fiber field
+        LuoRudyModel isotropic(size, size, 0.01);
+        LuoRudyModel equal(size, size, 0.01);
+        isotropic.setConductivity(0.4);
+        if (!equal.setFiberOrientation(swirl, 0.4, 0.4) || !equal.isAnisotropic()) {
+            std::cerr << "Error: Could not set fiber orientation" << std::endl;
+            return false;
+        }
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                isotropic.membranePotentialRow(y)[x] = potential(x, y);
+                equal.membranePotentialRow(y)[x] = potential(x, y);
+            }
+        }
+        isotropic.run(20);
+        equal.run(20);
+        auto V_iso = isotropic.getMembranePotential();
+        auto V_equal = equal.getMembranePotential();
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                if (!std::isfinite(V_iso[y][x]) || !(std::abs(V_iso[y][x] - V_equal[y][x]) < 1e-9)) {
+                    std::cerr << "Error: Equal conductivities differ from isotropic diffusion" << std::endl;
+                    return false;
+                }
+            }
+        }
+        
+        // A depolarized spot spreads further along the fibers, and turning
+        // them by 90 degrees transposes the result
+        LuoRudyModel fibers_x(size, size, 0.01);
+        LuoRudyModel fibers_y(size, size, 0.01);
+        fibers_x.setFiberOrientation(along_x, 1.2, 0.4);
+        fibers_y.setFiberOrientation(along_y, 1.2, 0.4);
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                fibers_x.membranePotentialRow(y)[x] = bump(x, y);
+                fibers_y.membranePotentialRow(y)[x] = bump(x, y);
+            }
+        }
+        fibers_x.run(20);
+        fibers_y.run(20);
+        auto V_x = fibers_x.getMembranePotential();
+        auto V_y = fibers_y.getMembranePotential();
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                if (!std::isfinite(V_x[y][x]) || !(std::abs(V_x[y][x] - V_y[x][y]) < 1e-9)) {
+                    std::cerr << "Error: Rotated fiber field is not transposed at (" << x << ", " << y << ")"
+                              << std::endl;
+                    return false;
+                }
+            }
+        }
+        // Cells next to the spot rise towards its potential, and the rise
+        // reaches further along the fibers than across them
+        const double rest = V_x[2][2];
+        if (!(V_x[center][center + 4] > rest) || !(V_x[center + 4][center] > rest)) {
+            std::cerr << "Error: Cells next to a depolarized spot do not depolarize" << std::endl;
+            return false;
+        }
+        if (!(V_x[center][center + 6] - rest > 5.0 * (V_x[center + 6][center] - rest))) {
+            std::cerr << "Error: Conduction is not faster along the fibers" << std::endl;
+            return false;
+        }
+        
+        // Every supported ISA level agrees with the scalar kernel, with a scar
+        // set after the fibers (which recomputes the stencil weights)
+        std::vector<std::vector<bool>> region(size, std::vector<bool>(size, false));
+        for (int y = 5; y < 14; ++y) {
+            for (int x = 3; x < 30 - y; ++x) {
+                region[y][x] = true;
+            }
+        }
+        SimdLevel original = StencilKernels::getSimdLevel();
+        std::vector<std::vector<double>> reference;
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512}) {
+            if (!StencilKernels::setSimdLevel(level)) {
+                continue;
+            }
+            TenTusscherModel model(size, size, 0.01);
+            model.setFiberOrientation(swirl, 1.0, 0.3);
+            model.setMIRegion(region);
+            for (int y = 0; y < size; ++y) {
+                for (int x = 0; x < size; ++x) {
+                    model.membranePotentialRow(y)[x] = potential(x, y);
+                }
+            }
+            model.run(20);
+            auto V = model.getMembranePotential();
+            std::vector<std::vector<double>> result(size, std::vector<double>(size));
+            for (int y = 0; y < size; ++y) {
+                for (int x = 0; x < size; ++x) {
+                    result[y][x] = V[y][x];
+                    if (!std::isfinite(V[y][x]) || (region[y][x] && V[y][x] != potential(x, y))) {
+                        std::cerr << "Error: Anisotropic step changed scar cell (" << x << ", " << y << ")"
+                                  << std::endl;
+                        StencilKernels::setSimdLevel(original);
+                        return false;
+                    }
+                }
+            }
+            if (reference.empty()) {
+                reference = result;
+                continue;
+            }
+            for (int y = 0; y < size; ++y) {
+                for (int x = 0; x < size; ++x) {
+                    if (std::abs(result[y][x] - reference[y][x]) > 1e-9) {
+                        std::cerr << "Error: " << StencilKernels::simdLevelName(level)
+                                  << " nine-point kernel differs from scalar kernel" << std::endl;
+                        StencilKernels::setSimdLevel(original);
+                        return false;
+                    }
+                }
+            }
+        }
+        StencilKernels::setSimdLevel(original);
+        
+        // Mismatched fields are rejected; an empty field returns to isotropic diffusion
+        if (equal.setFiberOrientation(std::vector<std::vector<double>>(size, std::vector<double>(size - 1)),
+                                      1.0, 0.3) ||
+            !equal.isAnisotropic() || !equal.setFiberOrientation({}, 1.0, 0.3) || equal.isAnisotropic()) {
+            std::cerr << "Error: Fiber field size checks wrong" << std::endl;
+            return false;
+        }
+        
+        std::cout << "Anisotropic diffusion tests passed!" << std::endl;
+        return true;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Anisotropic diffusion test failed with exception: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool testCardiacBoundaryConditions() {
+    std::cout << "Testing cardiac boundary conditions..." << std::endl;
+    
+    try {
+        const int width = 23;
+        const int height = 13;
+        auto potential = [](int x, int y) { return -75.0 + 10.0 * std::sin(0.5 * x + 0.2 * y); };
+        auto scar = [](int x, int y) { return (x >= 4 && x < 9 && y >= 3 && y < 7) || (x == 0 && y < 5); };
+        
+        // Zero flux on the grid equals periodic on the grid mirrored across
+        // both edges, where the mirror symmetry stops current at the seams
+        SimdLevel original = StencilKernels::getSimdLevel();
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512}) {
+            if (!StencilKernels::setSimdLevel(level)) {
+                continue;
+            }
+            for (int with_scar = 0; with_scar < 2; ++with_scar) {
+                auto mirror = [&](int x, int y) {
+                    return std::make_pair(x < width ? x : 2 * width - 1 - x, y < height ? y : 2 * height - 1 - y);
+                };
+                LuoRudyModel zero_flux(width, height, 0.01);
+                LuoRudyModel periodic(2 * width, 2 * height, 0.01);
+                periodic.setBoundaryCondition(BoundaryCondition::Periodic);
+                std::vector<std::vector<bool>> region(height, std::vector<bool>(width));
+                std::vector<std::vector<bool>> mirrored_region(2 * height, std::vector<bool>(2 * width));
+                for (int y = 0; y < 2 * height; ++y) {
+                    for (int x = 0; x < 2 * width; ++x) {
+                        auto cell = mirror(x, y);
+                        mirrored_region[y][x] = with_scar && scar(cell.first, cell.second);
+                        periodic.membranePotentialRow(y)[x] = potential(cell.first, cell.second);
+                        if (x < width && y < height) {
+                            region[y][x] = mirrored_region[y][x];
+                            zero_flux.membranePotentialRow(y)[x] = potential(x, y);
+                        }
+                    }
+                }
+                zero_flux.setMIRegion(region);
+                periodic.setMIRegion(mirrored_region);
+                zero_flux.setConductivity(0.5);
+                periodic.setConductivity(0.5);
+                zero_flux.run(20);
+                periodic.run(20);
+                
+                auto V_zero_flux = zero_flux.getMembranePotential();
+                auto V_periodic = periodic.getMembranePotential();
+                for (int y = 0; y < 2 * height; ++y) {
+                    for (int x = 0; x < 2 * width; ++x) {
+                        auto cell = mirror(x, y);
+                        double expected = V_zero_flux[cell.second][cell.first];
+                        if (!std::isfinite(expected) || !(std::abs(V_periodic[y][x] - expected) < 1e-9)) {
+                            std::cerr << "Error: " << StencilKernels::simdLevelName(level)
+                                      << " zero-flux edge differs from mirrored periodic grid at (" << x << ", "
+                                      << y << ")" << std::endl;
+                            StencilKernels::setSimdLevel(original);
+                            return false;
+                        }
+                    }
+                }
+            }
+        }
+        StencilKernels::setSimdLevel(original);
+        
+        // Scar interfaces carry no current: live cells at a common potential
+        // stay in step with scar-free tissue whatever the scar potential
+        LuoRudyModel scarred(width, height, 0.01);
+        LuoRudyModel healthy(width, height, 0.01);
+        std::vector<std::vector<bool>> region(height, std::vector<bool>(width));
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                region[y][x] = scar(x, y);
+                scarred.membranePotentialRow(y)[x] = scar(x, y) ? 0.0 : -80.0;
+                healthy.membranePotentialRow(y)[x] = -80.0;
+            }
+        }
+        scarred.setMIRegion(region);
+        scarred.run(20);
+        healthy.run(20);
+        auto V_scarred = scarred.getMembranePotential();
+        auto V_healthy = healthy.getMembranePotential();
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                if (V_scarred[y][x] != (scar(x, y) ? 0.0 : V_healthy[y][x])) {
+                    std::cerr << "Error: Current crosses the scar interface at (" << x << ", " << y << ")"
+                              << std::endl;
+                    return false;
+                }
+            }
+        }
+        
+        // A fixed potential drives the edge cells only, and edge cells are no longer frozen
+        LuoRudyModel fixed(width, height, 0.01);
+        fixed.setBoundaryCondition(BoundaryCondition::Fixed, -60.0);
+        if (fixed.getBoundaryCondition() != BoundaryCondition::Fixed) {
+            std::cerr << "Error: Boundary condition not set" << std::endl;
+            return false;
+        }
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                fixed.membranePotentialRow(y)[x] = -80.0;
+            }
+        }
+        LuoRudyModel reference(width, height, 0.01);
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                reference.membranePotentialRow(y)[x] = -80.0;
+            }
+        }
+        fixed.step();
+        reference.step();
+        auto V_fixed = fixed.getMembranePotential();
+        auto V_reference = reference.getMembranePotential();
+        const double edge_shift = V_fixed[height / 2][0] - V_reference[height / 2][0];
+        const double corner_shift = V_fixed[0][0] - V_reference[0][0];
+        if (!(std::abs(edge_shift) > 0.1) || !(std::abs(corner_shift - 2.0 * edge_shift) < 1e-9) ||
+            V_fixed[height / 2][width / 2] != V_reference[height / 2][width / 2]) {
+            std::cerr << "Error: Fixed boundary potential not applied at the edge only" << std::endl;
+            return false;
+        }
+        
+        std::cout << "Boundary condition tests passed!" << std::endl;
+        return true;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Boundary condition test failed with exception: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool testSparseDiffusion() {
+    std::cout << "Testing sparse diffusion operator..." << std::endl;
+    
+    try {
+        const int width = 19;
+        const int height = 11;
+        auto potential = [](int x, int y) { return -75.0 + 10.0 * std::sin(0.5 * x + 0.2 * y); };
+        auto scar = [](int x, int y) { return (x >= 4 && x < 9 && y >= 3 && y < 7) || (x == 0 && y < 5); };
+        std::vector<std::vector<bool>> region(height, std::vector<bool>(width));
+        std::vector<std::vector<double>> swirl(height, std::vector<double>(width));
+        int live_cells = 0;
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                region[y][x] = scar(x, y);
+                swirl[y][x] = 0.3 * x - 0.2 * y;
+                live_cells += !scar(x, y);
+            }
+        }
+        
+        // The CSR operator reproduces the stencil for every boundary
+        // condition, with and without fibers, serially and threaded
+        auto compare = [&](CardiacElectrophysiology& stencil, CardiacElectrophysiology& sparse,
+                           BoundaryCondition boundary, bool fibers, int threads) {
+            for (CardiacElectrophysiology* model : {&stencil, &sparse}) {
+                model->setBoundaryCondition(boundary, -70.0);
+                model->setMIRegion(region);
+                model->setConductivity(0.5);
+                if (fibers) {
+                    model->setFiberOrientation(swirl, 1.0, 0.3);
+                }
+                model->setNumThreads(threads);
+                for (int y = 0; y < height; ++y) {
+                    for (int x = 0; x < width; ++x) {
+                        model->membranePotentialRow(y)[x] = potential(x, y);
+                    }
+                }
+            }
+            sparse.setSparseDiffusion(true);
+            stencil.run(20);
+            sparse.run(20);
+            auto V_stencil = stencil.getMembranePotential();
+            auto V_sparse = sparse.getMembranePotential();
+            for (int y = 0; y < height; ++y) {
+                for (int x = 0; x < width; ++x) {
+                    if (!std::isfinite(V_sparse[y][x]) || !(std::abs(V_sparse[y][x] - V_stencil[y][x]) < 1e-9)) {
+                        std::cerr << "Error: Sparse diffusion differs from the stencil at (" << x << ", " << y
+                                  << ")" << std::endl;
+                        return false;
+                    }
+                }
+            }
+            return true;
+        };
+        for (BoundaryCondition boundary :
+             {BoundaryCondition::ZeroFlux, BoundaryCondition::Fixed, BoundaryCondition::Periodic}) {
+            for (int fibers = 0; fibers < 2; ++fibers) {
+                for (int threads : {1, 3}) {
+                    LuoRudyModel luo_rudy(width, height, 0.01), luo_rudy_sparse(width, height, 0.01);
+                    TenTusscherModel ten_tusscher(width, height, 0.01), ten_tusscher_sparse(width, height, 0.01);
+                    if (!compare(luo_rudy, luo_rudy_sparse, boundary, fibers, threads) ||
+                        !compare(ten_tusscher, ten_tusscher_sparse, boundary, fibers, threads)) {
+                        return false;
+                    }
+                }
+            }
+        }
+        
+        // The operator can be enabled before the scar is set, and disabled again
+        LuoRudyModel model(width, height, 0.01);
+        model.setSparseDiffusion(true);
+        model.setMIRegion(region);
+        if (!model.getSparseDiffusion()) {
+            std::cerr << "Error: Sparse diffusion not enabled" << std::endl;
+            return false;
+        }
+        model.setSparseDiffusion(false);
+        if (model.getSparseDiffusion()) {
+            std::cerr << "Error: Sparse diffusion not disabled" << std::endl;
+            return false;
+        }
+        
+        // Reverse Cuthill-McKee narrows the band of a wide grid from its width to about its height
+        const int wide = 40;
+        const int narrow = 6;
+        std::vector<int> row_begin(1, 0), columns;
+        std::vector<double> values;
+        for (int y = 0; y < narrow; ++y) {
+            for (int x = 0; x < wide; ++x) {
+                const int cell = y * wide + x;
+                columns.push_back(cell);
+                values.push_back(0.0);
+                const int neighbours[4][2] = {{x - 1, y}, {x + 1, y}, {x, y - 1}, {x, y + 1}};
+                for (const auto& n : neighbours) {
+                    if (n[0] >= 0 && n[0] < wide && n[1] >= 0 && n[1] < narrow) {
+                        columns.push_back(n[1] * wide + n[0]);
+                        values.push_back(1.0);
+                        values[row_begin.back()] -= 1.0;
+                    }
+                }
+                row_begin.push_back(static_cast<int>(columns.size()));
+            }
+        }
+        SparseDiffusion grid;
+        if (!grid.assemble(row_begin, columns, values, {}) || grid.size() != wide * narrow ||
+            grid.getOffDiagonalCount() != columns.size() - wide * narrow || grid.getBandwidth() > narrow + 1) {
+            std::cerr << "Error: Reverse Cuthill-McKee bandwidth " << grid.getBandwidth() << " exceeds "
+                      << narrow + 1 << std::endl;
+            return false;
+        }
+        
+        // Applying the renumbered operator matches the original rows
+        std::vector<double> in(wide * narrow), out(wide * narrow);
+        const std::vector<int>& order = grid.getOrder();
+        for (int i = 0; i < grid.size(); ++i) {
+            in[i] = std::sin(0.1 * order[i]);
+        }
+        grid.apply(in.data(), out.data(), 0, grid.size());
+        for (int i = 0; i < grid.size(); ++i) {
+            const int old = order[i];
+            double expected = 0.0;
+            for (int k = row_begin[old]; k < row_begin[old + 1]; ++k) {
+                expected += values[k] * std::sin(0.1 * columns[k]);
+            }
+            if (!(std::abs(out[i] - expected) < 1e-12)) {
+                std::cerr << "Error: Renumbered operator differs at row " << old << std::endl;
+                return false;
+            }
+        }
+        
+        // Inconsistent arrays are rejected and leave the operator unchanged
+        if (grid.assemble({0, 2}, {0, 1}, {1.0, 1.0}, {}) || grid.assemble({0, 1}, {0}, {}, {}) ||
+            grid.size() != wide * narrow) {
+            std::cerr << "Error: Inconsistent sparse operator accepted" << std::endl;
+            return false;
+        }
+        
+        std::cout << "Sparse diffusion tests passed!" << std::endl;
+        return true;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Sparse diffusion test failed with exception: " << e.what() << std::endl;
+        return false;
+    }
+}
+
 bool testValidationMetrics() {
     std::cout << "Testing validation metrics..." << std::endl;
     
@@ -198,7 +2189,7 @@ int main() {
     std::cout << "=====================================" << std::endl;
     
     int passed_tests = 0;
-    int total_tests = 4;
+    int total_tests = 27;
     
     // Run tests
     if (testDTMBasicFunctionality()) {
@@ -209,6 +2200,98 @@ int main() {
         passed_tests++;
     }
     
+    if (testFitzHughNagumoBinaryCheckpoint()) {
+        passed_tests++;
+    }
+    
+    if (testFitzHughNagumoParallelStepping()) {
+        passed_tests++;
+    }
+    
+    if (testFitzHughNagumoTemporalBlocking()) {
+        passed_tests++;
+    }
+    
+    if (testFitzHughNagumoActiveTiles()) {
+        passed_tests++;
+    }
+    
+    if (testFitzHughNagumoEnsemble()) {
+        passed_tests++;
+    }
+    
+    if (testFitzHughNagumo3D()) {
+        passed_tests++;
+    }
+    
+    if (testStimulusSchedule()) {
+        passed_tests++;
+    }
+    
+    if (testSnapshotWriter()) {
+        passed_tests++;
+    }
+    
+    if (testFitzHughNagumoAdaptiveIntegrator()) {
+        passed_tests++;
+    }
+    
+    if (testImexADIDiffusion()) {
+        passed_tests++;
+    }
+    
+    if (testFitzHughNagumoSinglePrecision()) {
+        passed_tests++;
+    }
+    
+    if (testStencilKernelDispatch()) {
+        passed_tests++;
+    }
+    
+    if (testAlignedGridLayout()) {
+        passed_tests++;
+    }
+    
+    if (testCardiacStateLayout()) {
+        passed_tests++;
+    }
+    
+    if (testCardiacIonicCurrents()) {
+        passed_tests++;
+    }
+    
+    if (testGateIntegrators()) {
+        passed_tests++;
+    }
+    
+    if (testRateTables()) {
+        passed_tests++;
+    }
+    
+    if (testCardiacParallelStep()) {
+        passed_tests++;
+    }
+    
+    if (testCardiacTissueClasses()) {
+        passed_tests++;
+    }
+    
+    if (testScarMask()) {
+        passed_tests++;
+    }
+    
+    if (testCardiacAnisotropicDiffusion()) {
+        passed_tests++;
+    }
+    
+    if (testCardiacBoundaryConditions()) {
+        passed_tests++;
+    }
+    
+    if (testSparseDiffusion()) {
+        passed_tests++;
+    }
+    
     if (testValidationMetrics()) {
         passed_tests++;
     }
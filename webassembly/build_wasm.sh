@@ -47,6 +47,17 @@ emcc -O3 \
     --bind \
     -I../include \
     ../src/FitzHughNagumo.cpp \
+    ../src/ThreadPool.cpp \
+    ../src/StencilKernels.cpp \
+    ../src/MappedFile.cpp \
+    ../src/ADIDiffusion.cpp \
+    ../src/FitzHughNagumoEnsemble.cpp \
+    ../src/FitzHughNagumo3D.cpp \
+    ../src/StimulusSchedule.cpp \
+    ../src/SnapshotWriter.cpp \
+    ../src/RateTable.cpp \
+    ../src/ScarMask.cpp \
+    ../src/SparseDiffusion.cpp \
     ../src/DTM.cpp \
     mi_modeling_wasm.cpp \
     -o dist/mi_modeling.js
@@ -103,6 +114,17 @@ emcc -O3 \
     --bind \
     -I../include \
     ../src/FitzHughNagumo.cpp \
+    ../src/ThreadPool.cpp \
+    ../src/StencilKernels.cpp \
+    ../src/MappedFile.cpp \
+    ../src/ADIDiffusion.cpp \
+    ../src/FitzHughNagumoEnsemble.cpp \
+    ../src/FitzHughNagumo3D.cpp \
+    ../src/StimulusSchedule.cpp \
+    ../src/SnapshotWriter.cpp \
+    ../src/RateTable.cpp \
+    ../src/ScarMask.cpp \
+    ../src/SparseDiffusion.cpp \
     ../src/DTM.cpp \
     mi_modeling_wasm.cpp \
     -o dist/mi_modeling.min.js